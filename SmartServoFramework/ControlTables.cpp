@@ -27,6 +27,7 @@
 
 // C++ standard libraries
 #include <cmath>
+#include <climits>
 
 const int (*getRegisterTable(const int servo_model))[8]
 {
@@ -260,13 +261,14 @@ int getRegisterInfos(const int ct[][8], const int reg_name, RegisterInfos &infos
                 }
                 if (infos.reg_value_max < 0)
                 {
-                    if (ct[i][1] < 5)
+                    // 2^32 doesn't fit in an int, clamp 4 bytes registers to INT_MAX
+                    if (ct[i][1] < 4)
                     {
                         infos.reg_value_max = static_cast<int>(std::pow(2, infos.reg_size*8));
                     }
                     else
                     {
-                        infos.reg_value_max = 0xFFFFFFFF;
+                        infos.reg_value_max = INT_MAX;
                     }
                 }
                 status = 1;
@@ -0,0 +1,265 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file ControllerGroup.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "ControllerGroup.h"
+#include "minitraces.h"
+
+#include <algorithm>
+
+//! Minimum time a controller waits for the others at the barrier, before opening it anyway.
+#define GROUP_BARRIER_TIMEOUT_MS    100
+
+/* ************************************************************************** */
+
+ControllerGroup::ControllerGroup(int freq)
+{
+    if (freq < 1 || freq > SYNCLOOP_MAX_FREQUENCY)
+    {
+        freq = 30;
+    }
+
+    frequency = freq;
+    period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / static_cast<double>(freq)));
+}
+
+ControllerGroup::~ControllerGroup()
+{
+    std::vector <ServoController *> ctrls = getControllers();
+    for (auto c: ctrls)
+    {
+        removeController(c);
+    }
+}
+
+/* ************************************************************************** */
+
+bool ControllerGroup::addController(ServoController *ctrl)
+{
+    if (ctrl == nullptr)
+    {
+        return false;
+    }
+
+    std::lock_guard <std::mutex> lock(groupLock);
+
+    ControllerGroup *expected = nullptr;
+    if (ctrl->syncloopGroup.compare_exchange_strong(expected, this) == false)
+    {
+        TRACE_ERROR(MAPI, "Cannot add a controller to a group: it already belongs to a group");
+        return false;
+    }
+
+    if (ctrl->syncloopFrequency != frequency)
+    {
+        TRACE_WARNING(MAPI, "Controller frequency (%iHz) doesn't match its group frequency (%iHz), polling rates will be off",
+                      ctrl->syncloopFrequency.load(), frequency);
+    }
+
+    controllers.push_back(ctrl);
+
+    return true;
+}
+
+void ControllerGroup::removeController(ServoController *ctrl)
+{
+    std::lock_guard <std::mutex> lock(groupLock);
+
+    std::vector <ServoController *>::iterator it = std::find(controllers.begin(), controllers.end(), ctrl);
+    if (it != controllers.end())
+    {
+        controllers.erase(it);
+
+        ControllerGroup *expected = this;
+        ctrl->syncloopGroup.compare_exchange_strong(expected, nullptr);
+
+        // The controllers waiting at the barrier may not need to wait anymore
+        groupCondition.notify_all();
+    }
+}
+
+std::vector <ServoController *> ControllerGroup::getControllers()
+{
+    std::lock_guard <std::mutex> lock(groupLock);
+    return controllers;
+}
+
+int ControllerGroup::getFrequency()
+{
+    return frequency;
+}
+
+std::chrono::steady_clock::duration ControllerGroup::getPeriod() const
+{
+    return period;
+}
+
+/* ************************************************************************** */
+
+size_t ControllerGroup::getRunningCount_internal()
+{
+    size_t running = 0;
+
+    for (auto c: controllers)
+    {
+        if (c->getState() >= state_started)
+        {
+            running++;
+        }
+    }
+
+    return running;
+}
+
+std::chrono::steady_clock::time_point ControllerGroup::arrive()
+{
+    std::unique_lock <std::mutex> lock(groupLock);
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point timeout = now + std::max(period * 4, std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(GROUP_BARRIER_TIMEOUT_MS)));
+
+    if (arrived == 0)
+    {
+        firstArrival = now;
+    }
+    arrived++;
+
+    const uint64_t gen = generation;
+    while (generation == gen)
+    {
+        // Last one in (controllers that stopped or left are not waited for)
+        if (arrived >= getRunningCount_internal())
+        {
+            completeCycle_internal();
+            break;
+        }
+
+        // Re-check the running controllers every period, and give up on the stuck ones after a while
+        now = std::chrono::steady_clock::now();
+        if (now >= timeout)
+        {
+            TRACE_WARNING(MAPI, "Group barrier timeout: %i/%i controllers completed the cycle",
+                          static_cast<int>(arrived), static_cast<int>(getRunningCount_internal()));
+            groupTimeouts++;
+            completeCycle_internal();
+            break;
+        }
+
+        groupCondition.wait_until(lock, std::min(now + period, timeout));
+    }
+
+    return cycleStart;
+}
+
+void ControllerGroup::completeCycle_internal()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // First cycle, the group clock starts now
+    if (cycleStart == std::chrono::steady_clock::time_point())
+    {
+        cycleStart = firstArrival;
+    }
+
+    cycleHistogram.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - cycleStart).count()));
+    skewHistogram.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - firstArrival).count()));
+
+    // Schedule the next cycle, skipping the deadlines missed
+    cycleStart += period;
+    if (cycleStart <= now)
+    {
+        uint64_t missed = static_cast<uint64_t>((now - cycleStart) / period) + 1;
+        cycleStart += period * missed;
+        groupOverruns += missed;
+    }
+
+    // Gather the state of every controller, then swap it in (no allocation under the lock)
+    groupStatesBack.cycle = groupCycle + 1;
+    groupStatesBack.rxTime = std::chrono::steady_clock::time_point();
+    groupStatesBack.states.clear();
+    for (auto c: controllers)
+    {
+        if (c->snapshot(memberStates))
+        {
+            groupStatesBack.rxTime = std::max(groupStatesBack.rxTime, memberStates.rxTime);
+            groupStatesBack.states.insert(groupStatesBack.states.end(), memberStates.states.begin(), memberStates.states.end());
+        }
+    }
+    {
+        std::lock_guard <std::mutex> lock(groupStatesLock);
+        std::swap(groupStates, groupStatesBack);
+    }
+
+    groupCycle++;
+    arrived = 0;
+    generation++;
+    groupCondition.notify_all();
+}
+
+/* ************************************************************************** */
+
+uint64_t ControllerGroup::getCycleCount()
+{
+    return groupCycle;
+}
+
+uint64_t ControllerGroup::waitForCycle(const uint64_t lastCycle, const int timeout_ms)
+{
+    std::unique_lock <std::mutex> lock(groupLock);
+
+    groupCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]()
+    {
+        return groupCycle > lastCycle;
+    });
+
+    return groupCycle;
+}
+
+bool ControllerGroup::snapshot(CycleSnapshot &snap)
+{
+    std::lock_guard <std::mutex> lock(groupStatesLock);
+
+    snap.cycle = groupStates.cycle;
+    snap.rxTime = groupStates.rxTime;
+    snap.states.assign(groupStates.states.begin(), groupStates.states.end());
+
+    return (snap.cycle > 0);
+}
+
+LatencyStats ControllerGroup::getCycleLatency()
+{
+    return cycleHistogram.getStats();
+}
+
+LatencyStats ControllerGroup::getArrivalSkew()
+{
+    return skewHistogram.getStats();
+}
+
+uint64_t ControllerGroup::getOverruns()
+{
+    return groupOverruns;
+}
+
+uint64_t ControllerGroup::getTimeouts()
+{
+    return groupTimeouts;
+}
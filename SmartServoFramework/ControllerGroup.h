@@ -0,0 +1,185 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file ControllerGroup.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef CONTROLLER_GROUP_H
+#define CONTROLLER_GROUP_H
+
+#include "ServoController.h"
+#include "LatencyHistogram.h"
+
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+/** \addtogroup ManagedAPIs
+ *  @{
+ */
+
+/*!
+ * \brief The ControllerGroup class.
+ *
+ * Drive several controllers (one per serial port, Dynamixel and HerkuleX can
+ * be mixed) with a common cycle clock. Every controller keeps its own thread,
+ * so the I/O of each bus runs in parallel, but instead of sleeping until its
+ * own deadline, each one waits at a barrier at the end of its cycle. Once all
+ * of them have arrived, the state of the whole group is published, and they
+ * all start their next cycle at the same time.
+ *
+ * The group cycle frequency replaces the frequencies of its controllers for
+ * scheduling. Their polling rates are still computed from their own
+ * frequencies, so create them with the same frequency as the group.
+ */
+class ControllerGroup
+{
+    std::vector <ServoController *> controllers; //!< Controllers of the group, protected by groupLock.
+
+    std::chrono::steady_clock::duration period; //!< Duration of a group cycle.
+    int frequency;                      //!< Group cycle frequency, in Hz.
+
+    std::mutex groupLock;               //!< Lock for the barrier, and the cycle condition variable.
+    std::condition_variable groupCondition; //!< Notified at the end of every group cycle, or when a controller leaves.
+    size_t arrived = 0;                 //!< Number of controllers waiting at the barrier.
+    uint64_t generation = 0;            //!< Barrier generation, incremented every time the barrier opens.
+    std::chrono::steady_clock::time_point cycleStart; //!< Start of the next group cycle.
+    std::chrono::steady_clock::time_point firstArrival; //!< Time at which the first controller reached the barrier.
+
+    std::atomic <uint64_t> groupCycle {0}; //!< Number of group cycles published.
+    std::atomic <uint64_t> groupOverruns {0}; //!< Number of group cycle deadlines missed.
+    std::atomic <uint64_t> groupTimeouts {0}; //!< Number of barriers opened before every controller arrived.
+    LatencyHistogram cycleHistogram;    //!< Time from the start of a group cycle to the arrival of its last controller, in microseconds.
+    LatencyHistogram skewHistogram;     //!< Time between the first and the last arrivals at the barrier, in microseconds.
+
+    CycleSnapshot groupStates;          //!< State of the whole group at the last cycle, protected by groupStatesLock.
+    CycleSnapshot groupStatesBack;      //!< State of the group being published. Only used while holding groupLock.
+    CycleSnapshot memberStates;         //!< Scratch buffer for the state of one controller. Only used while holding groupLock.
+    std::mutex groupStatesLock;         //!< Lock for the state of the whole group.
+
+    /*!
+     * \brief Count the controllers with a running synchronization loop. Must be called while holding groupLock.
+     */
+    size_t getRunningCount_internal();
+
+    /*!
+     * \brief Open the barrier: publish the state of the group, and schedule the next cycle. Must be called while holding groupLock.
+     */
+    void completeCycle_internal();
+
+public:
+    /*!
+     * \brief ControllerGroup constructor.
+     * \param freq: Group cycle frequency. Range is [1;1000], default is 30.
+     */
+    ControllerGroup(int freq = 30);
+
+    /*!
+     * \brief ControllerGroup destructor. Controllers still in the group are removed from it.
+     */
+    ~ControllerGroup();
+
+    /*!
+     * \brief Add a controller to the group.
+     * \param ctrl: The controller. It must not belong to another group.
+     * \return True if the controller has been added.
+     *
+     * A controller can join a running group: it is synchronized from its next
+     * cycle. It must be removed from the group before being deleted.
+     */
+    bool addController(ServoController *ctrl);
+
+    /*!
+     * \brief Remove a controller from the group. It goes back to its own cycle clock.
+     */
+    void removeController(ServoController *ctrl);
+
+    /*!
+     * \brief Get the controllers of the group.
+     */
+    std::vector <ServoController *> getControllers();
+
+    /*!
+     * \brief Get the group cycle frequency, in Hz.
+     */
+    int getFrequency();
+
+    /*!
+     * \brief Get the number of group cycles published.
+     */
+    uint64_t getCycleCount();
+
+    /*!
+     * \brief Wait for the group to publish a cycle newer than 'lastCycle'.
+     * \param lastCycle: The last cycle seen by the caller, or 0.
+     * \param timeout_ms: Maximum time to wait, in milliseconds.
+     * \return The current cycle count, equal to 'lastCycle' on timeout.
+     */
+    uint64_t waitForCycle(const uint64_t lastCycle, const int timeout_ms = 1000);
+
+    /*!
+     * \brief Get the feedback of every device of every controller, all taken from the last group cycle.
+     * \param snap: Where to copy the feedback. Its storage is reused, so once it is large enough this call doesn't allocate.
+     * \return False if no group cycle has been published yet.
+     *
+     * Devices are ordered by controller (in the order they were added to the
+     * group), then by registration order. The cycle number is the group's, and
+     * the time is the one of the last controller to complete its cycle.
+     */
+    bool snapshot(CycleSnapshot &snap);
+
+    /*!
+     * \brief Get the duration of the group cycles, from their start to the arrival of their last controller, in microseconds.
+     */
+    LatencyStats getCycleLatency();
+
+    /*!
+     * \brief Get the time between the first and the last controller completing each group cycle, in microseconds.
+     */
+    LatencyStats getArrivalSkew();
+
+    /*!
+     * \brief Get the number of group cycle deadlines missed.
+     */
+    uint64_t getOverruns();
+
+    /*!
+     * \brief Get the number of group cycles published before every controller completed it (a controller was stuck).
+     */
+    uint64_t getTimeouts();
+
+    // Synchronization (used by controllers)
+
+    /*!
+     * \brief Wait at the barrier until every controller of the group has completed its cycle.
+     * \return The start of the next group cycle.
+     */
+    std::chrono::steady_clock::time_point arrive();
+
+    /*!
+     * \brief Get the duration of a group cycle.
+     */
+    std::chrono::steady_clock::duration getPeriod() const;
+};
+
+/** @}*/
+
+#endif // CONTROLLER_GROUP_H
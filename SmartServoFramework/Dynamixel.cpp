@@ -24,6 +24,7 @@
 #include "minitraces.h"
 
 // C++ standard libraries
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -32,9 +33,6 @@
 
 /* ************************************************************************** */
 
-// Enable latency timer
-//#define LATENCY_TIMER
-
 // Enable packet debugger
 //#define PACKET_DEBUGGER
 
@@ -95,6 +93,33 @@ enum {
     PKT2_PARAMETER      = 8,            //!< Note: parameter field as an address of 9 (and not 8) when found in status packet.
 };
 
+/*!
+ * \brief Sort a Dynamixel instruction into a ::LatencyInstructions_e transaction type.
+ */
+static int dxl_latency_instruction(const int instruction)
+{
+    switch (instruction)
+    {
+    case INST_PING:
+        return LATENCY_PING;
+    case INST_READ:
+        return LATENCY_READ;
+    case INST_WRITE:
+    case INST_REG_WRITE:
+        return LATENCY_WRITE;
+    case INST_SYNC_READ:
+        return LATENCY_SYNC_READ;
+    case INST_SYNC_WRITE:
+        return LATENCY_SYNC_WRITE;
+    case INST_BULK_READ:
+        return LATENCY_BULK_READ;
+    case INST_BULK_WRITE:
+        return LATENCY_BULK_WRITE;
+    default:
+        return LATENCY_OTHER;
+    }
+}
+
 /* ************************************************************************** */
 
 unsigned short crc_table[256] =
@@ -154,20 +179,34 @@ int Dynamixel::serialOpen(std::string &devicePath, const int baud)
         serialTerminate();
     }
 
-    // Instanciate a different serial subclass, depending on the current OS
+    // Instanciate a different serial subclass, depending on the device path and the current OS
+    if (isReplayDevicePath(devicePath))
+    {
+        m_serial = new SerialPortReplay(devicePath, baud, m_serialDevice, m_servoSerie);
+    }
+    else
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+    if (isNetworkDevicePath(devicePath))
+    {
+        m_serial = new SerialPortNet(devicePath, baud, m_serialDevice, m_servoSerie);
+    }
+    else
+#endif
+    {
 #if defined(FEATURE_QTSERIAL)
-    m_serial = new SerialPortQt(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortQt(devicePath, baud, m_serialDevice, m_servoSerie);
 #else
 #if defined(_WIN32) || defined(_WIN64)
-    m_serial = new SerialPortWindows(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortWindows(devicePath, baud, m_serialDevice, m_servoSerie);
 #elif defined(__APPLE__) || defined(__MACH__)
-    m_serial = new SerialPortMacOS(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortMacOS(devicePath, baud, m_serialDevice, m_servoSerie);
 #elif defined(__linux__) || defined(__unix__)
-    m_serial = new SerialPortLinux(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortLinux(devicePath, baud, m_serialDevice, m_servoSerie);
 #else
-    #error "No serial port implementation available..."
+        #error "No serial port implementation available..."
 #endif
 #endif
+    }
 
     // Initialize the serial link
     if (m_serial != nullptr)
@@ -246,6 +285,62 @@ void Dynamixel::serialSetLatency(int latency)
         m_serial->setLatency(latency);
 }
 
+SerialPortStats Dynamixel::serialGetStats()
+{
+    if (m_serial)
+        return m_serial->getStats();
+
+    return SerialPortStats();
+}
+
+void Dynamixel::serialResetStats()
+{
+    if (m_serial)
+        m_serial->resetStats();
+}
+
+double Dynamixel::serialGetByteTime()
+{
+    if (m_serial)
+        return m_serial->getByteTime();
+
+    return 0.0;
+}
+
+LatencyStats Dynamixel::getInstructionLatency(const int instruction)
+{
+    return m_latency.getInstructionStats(instruction);
+}
+
+LatencyStats Dynamixel::getServoLatency(const int id)
+{
+    return m_latency.getServoStats(id);
+}
+
+void Dynamixel::resetLatency()
+{
+    m_latency.reset();
+}
+
+bool Dynamixel::serialCaptureStart(const std::string &path)
+{
+    int baudrate = 0;
+    if (m_serial)
+        baudrate = m_serial->getDeviceBaudRate();
+
+    return m_capture.start(path, m_protocolVersion, baudrate);
+}
+
+void Dynamixel::serialCaptureStop()
+{
+    m_capture.stop();
+}
+
+bool Dynamixel::serialCaptureRunning()
+{
+    return m_capture.isRunning();
+}
+
 void Dynamixel::setAckPolicy(int ack)
 {
     if (m_ackPolicy >= ACK_NO_REPLY && ack <= ACK_REPLY_ALL)
@@ -288,11 +383,12 @@ void Dynamixel::dxl_tx_packet()
     dxl_checksum_packet();
 
     // Send packet
-    unsigned char txPacketSize = dxl_get_txpacket_size();
-    unsigned char txPacketSizeSent = 0;
+    int txPacketSize = dxl_get_txpacket_size();
+    int txPacketSizeSent = 0;
 
     if (m_serial != nullptr)
     {
+        m_txTime = std::chrono::steady_clock::now();
         txPacketSizeSent = m_serial->tx(txPacket, txPacketSize);
     }
     else
@@ -304,13 +400,20 @@ void Dynamixel::dxl_tx_packet()
     // Check if we send the whole packet
     if (txPacketSize != txPacketSizeSent)
     {
+        m_serial->statsTransmit(-1);
         m_commStatus = COMM_TXFAIL;
         m_commLock = 0;
         return;
     }
 
     // Set a timeout for the response packet
-    if (m_protocolVersion == PROTOCOL_DXLv2)
+    if ((m_protocolVersion == PROTOCOL_DXLv2 && (txPacket[PKT2_INSTRUCTION] == INST_SYNC_READ || txPacket[PKT2_INSTRUCTION] == INST_BULK_READ)) ||
+        (m_protocolVersion == PROTOCOL_DXLv1 && txPacket[PKT1_INSTRUCTION] == INST_BULK_READ))
+    {
+        // Every device answers in turn, right after the previous one
+        m_serial->setTimeOut(m_rxSequenceSize);
+    }
+    else if (m_protocolVersion == PROTOCOL_DXLv2)
     {
         if (txPacket[PKT2_INSTRUCTION] == INST_READ)
         {
@@ -335,6 +438,8 @@ void Dynamixel::dxl_tx_packet()
         }
     }
 
+    m_serial->statsTransmit(txPacketSizeSent);
+    m_capture.capture(CAPTURE_DIRECTION_TX, txPacket, txPacketSizeSent);
     m_commStatus = COMM_TXSUCCESS;
 }
 
@@ -352,10 +457,13 @@ void Dynamixel::dxl_rx_packet()
         return;
     }
 
-    // Packet sent to a broadcast address? No need to wait for a status packet.
-    if ((m_protocolVersion == PROTOCOL_DXLv1 && txPacket[PKT1_ID] == BROADCAST_ID) ||
-        (m_protocolVersion == PROTOCOL_DXLv2 && txPacket[PKT2_ID] == BROADCAST_ID))
+    // Packet sent to a broadcast address? No need to wait for a status packet (unless it's a sync or bulk read).
+    if (m_rxExpectedId < 0 &&
+        ((m_protocolVersion == PROTOCOL_DXLv1 && txPacket[PKT1_ID] == BROADCAST_ID) ||
+         (m_protocolVersion == PROTOCOL_DXLv2 && txPacket[PKT2_ID] == BROADCAST_ID)))
     {
+        m_serial->txNoReply();
+        m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
         m_commStatus = COMM_RXSUCCESS;
         m_commLock = 0;
         return;
@@ -374,6 +482,7 @@ void Dynamixel::dxl_rx_packet()
     {
         // Receive packet
         nRead = m_serial->rx((unsigned char*)&rxPacket[rxPacketSizeReceived], rxPacketSize - rxPacketSizeReceived);
+        m_capture.capture(CAPTURE_DIRECTION_RX, &rxPacket[rxPacketSizeReceived], nRead);
         rxPacketSizeReceived += nRead;
 
         // Check if we received the whole packet
@@ -383,10 +492,12 @@ void Dynamixel::dxl_rx_packet()
             {
                 if (rxPacketSizeReceived == 0)
                 {
+                    m_serial->statsComplete(0, TRANSACTION_TIMEOUT);
                     m_commStatus = COMM_RXTIMEOUT;
                 }
                 else
                 {
+                    m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_PARTIAL);
                     m_commStatus = COMM_RXCORRUPT;
                 }
 
@@ -402,7 +513,7 @@ void Dynamixel::dxl_rx_packet()
     }
 
     // Find packet header
-    unsigned char i, j;
+    int i, j;
     if (m_protocolVersion == PROTOCOL_DXLv2)
     {
         for (i = 0; i < (rxPacketSizeReceived - 1); i++)
@@ -466,9 +577,16 @@ void Dynamixel::dxl_rx_packet()
     }
 
     // Check ID pairing
-    if (((m_protocolVersion == PROTOCOL_DXLv1) && (txPacket[PKT1_ID] != rxPacket[PKT1_ID])) ||
-        ((m_protocolVersion == PROTOCOL_DXLv2) && (txPacket[PKT2_ID] != rxPacket[PKT2_ID])))
+    int expectedId = m_rxExpectedId;
+    if (expectedId < 0)
+    {
+        expectedId = (m_protocolVersion == PROTOCOL_DXLv2) ? txPacket[PKT2_ID] : txPacket[PKT1_ID];
+    }
+
+    if (((m_protocolVersion == PROTOCOL_DXLv1) && (expectedId != rxPacket[PKT1_ID])) ||
+        ((m_protocolVersion == PROTOCOL_DXLv2) && (expectedId != rxPacket[PKT2_ID])))
     {
+        m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_BAD_ID);
         m_commStatus = COMM_RXCORRUPT;
         m_commLock = 0;
         return;
@@ -480,6 +598,7 @@ void Dynamixel::dxl_rx_packet()
     if (rxPacketSizeReceived < rxPacketSize)
     {
         nRead = m_serial->rx(&rxPacket[rxPacketSizeReceived], rxPacketSize - rxPacketSizeReceived);
+        m_capture.capture(CAPTURE_DIRECTION_RX, &rxPacket[rxPacketSizeReceived], nRead);
         rxPacketSizeReceived += nRead;
 
         if (rxPacketSizeReceived < rxPacketSize)
@@ -498,6 +617,7 @@ void Dynamixel::dxl_rx_packet()
         if (rxPacket[rxPacketSize - 2] != get_lowbyte(crc) &&
             rxPacket[rxPacketSize - 1] != get_highbyte(crc))
         {
+            m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_BAD_CHECKSUM);
             m_commStatus = COMM_RXCORRUPT;
             m_commLock = 0;
             return;
@@ -510,24 +630,41 @@ void Dynamixel::dxl_rx_packet()
         // Compare it with the internal packet checksum
         if (rxPacket[rxPacketSize - 1] != checksum)
         {
+            m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_BAD_CHECKSUM);
             m_commStatus = COMM_RXCORRUPT;
             m_commLock = 0;
             return;
         }
     }
 
+    m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_REPLY);
+
+    // Transaction latency
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (m_rxExpectedId < 0)
+        {
+            int inst = (m_protocolVersion == PROTOCOL_DXLv2) ? txPacket[PKT2_INSTRUCTION] : txPacket[PKT1_INSTRUCTION];
+
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - m_txTime).count();
+            m_latency.record(dxl_latency_instruction(inst), expectedId, static_cast<uint32_t>(us));
+        }
+        else
+        {
+            // Part of a sequence: the device is timed from the end of the previous status packet,
+            // the whole transaction is recorded once by dxl_txrx_sequence()
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - m_rxTime).count();
+            m_latency.record(LATENCY_INSTRUCTION_COUNT, expectedId, static_cast<uint32_t>(us));
+            m_rxTime = now;
+        }
+    }
     m_commStatus = COMM_RXSUCCESS;
     m_commLock = 0;
 }
 
 void Dynamixel::dxl_txrx_packet(int ack)
 {
-#ifdef LATENCY_TIMER
-    // Latency timer for a complete transaction (instruction sent and status received)
-    std::chrono::time_point<std::chrono::high_resolution_clock> start, end;
-    start = std::chrono::high_resolution_clock::now();
-#endif
-
     dxl_tx_packet();
 
     if (m_commStatus != COMM_TXSUCCESS)
@@ -564,12 +701,16 @@ void Dynamixel::dxl_txrx_packet(int ack)
         }
         else
         {
+            m_serial->txNoReply();
+            m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
             m_commStatus = COMM_RXSUCCESS;
             m_commLock = 0;
         }
     }
     else
     {
+        m_serial->txNoReply();
+        m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
         m_commStatus = COMM_RXSUCCESS;
         m_commLock = 0;
     }
@@ -578,12 +719,85 @@ void Dynamixel::dxl_txrx_packet(int ack)
     printTxPacket();
     printRxPacket();
 #endif
+}
+
+void Dynamixel::dxl_txrx_sequence(DynamixelReadRequest *requests, const int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        requests[i].status = COMM_UNKNOWN;
+    }
+
+    dxl_tx_packet();
+
+    if (m_commStatus != COMM_TXSUCCESS)
+    {
+        TRACE_ERROR(DXL, "Unable to send TX packet on serial link: '%s'", serialGetCurrentDevice().c_str());
+        return;
+    }
+
+    // Status packets are expected in the order of the requests
+    m_rxTime = m_txTime;
+
+    int received = 0;
+    for (int i = 0; i < count; i++)
+    {
+        DynamixelReadRequest &r = requests[i];
+
+        m_rxExpectedId = r.id;
+        m_commStatus = COMM_TXSUCCESS;
+        m_commLock = 1;
 
-#ifdef LATENCY_TIMER
-    end = std::chrono::high_resolution_clock::now();
-    int loopd = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-    TRACE_1(DXL, "TX > RX loop: %iµs", loopd);
+        do {
+            dxl_rx_packet();
+        }
+        while (m_commStatus == COMM_RXWAITING);
+
+        if (m_commStatus == COMM_RXSUCCESS)
+        {
+            // Payload size, without the error field
+            int payload = dxl_get_rxpacket_length_field() - ((m_protocolVersion == PROTOCOL_DXLv2) ? 4 : 2);
+
+            if (payload == r.length)
+            {
+                r.data.resize(r.length);
+                for (int j = 0; j < r.length; j++)
+                {
+                    r.data[j] = static_cast<unsigned char>(dxl_get_rxpacket_parameter(j));
+                }
+                r.error = dxl_get_rxpacket_error();
+            }
+            else
+            {
+                m_commStatus = COMM_RXCORRUPT;
+            }
+        }
+
+        r.status = m_commStatus;
+
+#ifdef PACKET_DEBUGGER
+        printRxPacket();
 #endif
+
+        // The next devices are waiting for this status packet, they won't answer
+        if (m_commStatus != COMM_RXSUCCESS)
+        {
+            break;
+        }
+        received++;
+    }
+
+    // Transaction latency, from the instruction packet to the end of the last status packet
+    if (received == count && count > 0)
+    {
+        int inst = (m_protocolVersion == PROTOCOL_DXLv2) ? txPacket[PKT2_INSTRUCTION] : txPacket[PKT1_INSTRUCTION];
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(m_rxTime - m_txTime).count();
+        m_latency.record(dxl_latency_instruction(inst), BROADCAST_ID, static_cast<uint32_t>(us));
+    }
+
+    m_rxExpectedId = -1;
+    m_commLock = 0;
 }
 
 // Low level API
@@ -767,7 +981,8 @@ int Dynamixel::dxl1_validate_packet()
         txPacket[PKT1_INSTRUCTION] != INST_WRITE &&
         txPacket[PKT1_INSTRUCTION] != INST_REG_WRITE &&
         txPacket[PKT1_INSTRUCTION] != INST_ACTION &&
-        txPacket[PKT1_INSTRUCTION] != INST_SYNC_READ)
+        txPacket[PKT1_INSTRUCTION] != INST_SYNC_WRITE &&
+        txPacket[PKT1_INSTRUCTION] != INST_BULK_READ)
     {
         m_commStatus = COMM_TXERROR;
         m_commLock = 0;
@@ -1394,3 +1609,274 @@ void Dynamixel::dxl_write_word(const int id, const int address, const int value,
 
     dxl_txrx_packet(ack);
 }
+
+void Dynamixel::dxl_read(DynamixelReadRequest &request, const int ack)
+{
+    request.status = COMM_UNKNOWN;
+
+    if (request.id == BROADCAST_ID || request.length <= 0)
+    {
+        TRACE_ERROR(DXL, "Cannot send 'Read' instruction to broadcast address, or for 0 bytes!");
+        return;
+    }
+    else if (ack == ACK_NO_REPLY || (ack == ACK_DEFAULT && m_ackPolicy == ACK_NO_REPLY))
+    {
+        TRACE_ERROR(DXL, "Cannot send 'Read' instruction if ACK_NO_REPLY is set!");
+        return;
+    }
+
+    while(m_commLock);
+
+    if (m_protocolVersion == PROTOCOL_DXLv2)
+    {
+        txPacket[PKT2_ID] = get_lowbyte(request.id);
+        txPacket[PKT2_INSTRUCTION] = INST_READ;
+        txPacket[PKT2_PARAMETER] = get_lowbyte(request.address);
+        txPacket[PKT2_PARAMETER+1] = get_highbyte(request.address);
+        txPacket[PKT2_PARAMETER+2] = get_lowbyte(request.length);
+        txPacket[PKT2_PARAMETER+3] = get_highbyte(request.length);
+        txPacket[PKT2_LENGTH_L] = 7;
+        txPacket[PKT2_LENGTH_H] = 0;
+    }
+    else
+    {
+        txPacket[PKT1_ID] = get_lowbyte(request.id);
+        txPacket[PKT1_INSTRUCTION] = INST_READ;
+        txPacket[PKT1_PARAMETER] = get_lowbyte(request.address);
+        txPacket[PKT1_PARAMETER+1] = get_lowbyte(request.length);
+        txPacket[PKT1_LENGTH] = 4;
+    }
+
+    dxl_txrx_packet(ack);
+
+    if (m_commStatus == COMM_RXSUCCESS &&
+        dxl_get_rxpacket_length_field() - ((m_protocolVersion == PROTOCOL_DXLv2) ? 4 : 2) != request.length)
+    {
+        m_commStatus = COMM_RXCORRUPT;
+    }
+
+    if (m_commStatus == COMM_RXSUCCESS)
+    {
+        request.data.resize(request.length);
+        for (int i = 0; i < request.length; i++)
+        {
+            request.data[i] = static_cast<unsigned char>(dxl_get_rxpacket_parameter(i));
+        }
+        request.error = dxl_get_rxpacket_error();
+    }
+
+    request.status = m_commStatus;
+}
+
+void Dynamixel::dxl_sync_read(DynamixelReadRequest *requests, const int count)
+{
+    if (m_protocolVersion != PROTOCOL_DXLv2)
+    {
+        m_commStatus = COMM_TXERROR;
+        TRACE_ERROR(DXL, "'Sync Read' instruction not available with protocol v1!");
+        return;
+    }
+
+    if (requests == nullptr || count <= 0)
+    {
+        return;
+    }
+
+    const int address = requests[0].address;
+    const int length = requests[0].length;
+
+    // Number of devices fitting into one instruction packet
+    const int packetCount = MAX_PACKET_LENGTH_dxlv2 - 14;
+
+    for (int first = 0; first < count; first += packetCount)
+    {
+        int n = std::min(packetCount, count - first);
+
+        while(m_commLock);
+
+        txPacket[PKT2_ID] = BROADCAST_ID;
+        txPacket[PKT2_INSTRUCTION] = INST_SYNC_READ;
+        txPacket[PKT2_PARAMETER] = get_lowbyte(address);
+        txPacket[PKT2_PARAMETER+1] = get_highbyte(address);
+        txPacket[PKT2_PARAMETER+2] = get_lowbyte(length);
+        txPacket[PKT2_PARAMETER+3] = get_highbyte(length);
+        for (int i = 0; i < n; i++)
+        {
+            txPacket[PKT2_PARAMETER+4+i] = get_lowbyte(requests[first + i].id);
+        }
+        txPacket[PKT2_LENGTH_L] = get_lowbyte(n + 7);
+        txPacket[PKT2_LENGTH_H] = get_highbyte(n + 7);
+
+        // A v2 status packet is 11 bytes plus its parameters
+        m_rxSequenceSize = n * (11 + length);
+
+        dxl_txrx_sequence(requests + first, n);
+    }
+}
+
+void Dynamixel::dxl_bulk_read(DynamixelReadRequest *requests, const int count)
+{
+    if (requests == nullptr || count <= 0)
+    {
+        return;
+    }
+
+    // Number of devices fitting into one instruction packet
+    int packetCount = 0;
+    if (m_protocolVersion == PROTOCOL_DXLv2)
+    {
+        packetCount = (MAX_PACKET_LENGTH_dxlv2 - 10) / 5;
+    }
+    else
+    {
+        packetCount = (MAX_PACKET_LENGTH_dxlv1 - 6) / 3;
+    }
+
+    for (int first = 0; first < count; first += packetCount)
+    {
+        int n = std::min(packetCount, count - first);
+        DynamixelReadRequest *r = requests + first;
+
+        while(m_commLock);
+
+        m_rxSequenceSize = 0;
+
+        if (m_protocolVersion == PROTOCOL_DXLv2)
+        {
+            txPacket[PKT2_ID] = BROADCAST_ID;
+            txPacket[PKT2_INSTRUCTION] = INST_BULK_READ;
+            for (int i = 0; i < n; i++)
+            {
+                txPacket[PKT2_PARAMETER+5*i] = get_lowbyte(r[i].id);
+                txPacket[PKT2_PARAMETER+5*i+1] = get_lowbyte(r[i].address);
+                txPacket[PKT2_PARAMETER+5*i+2] = get_highbyte(r[i].address);
+                txPacket[PKT2_PARAMETER+5*i+3] = get_lowbyte(r[i].length);
+                txPacket[PKT2_PARAMETER+5*i+4] = get_highbyte(r[i].length);
+                m_rxSequenceSize += 11 + r[i].length;
+            }
+            txPacket[PKT2_LENGTH_L] = get_lowbyte(5*n + 3);
+            txPacket[PKT2_LENGTH_H] = get_highbyte(5*n + 3);
+        }
+        else
+        {
+            txPacket[PKT1_ID] = BROADCAST_ID;
+            txPacket[PKT1_INSTRUCTION] = INST_BULK_READ;
+            txPacket[PKT1_PARAMETER] = 0;
+            for (int i = 0; i < n; i++)
+            {
+                txPacket[PKT1_PARAMETER+1+3*i] = get_lowbyte(r[i].length);
+                txPacket[PKT1_PARAMETER+1+3*i+1] = get_lowbyte(r[i].id);
+                txPacket[PKT1_PARAMETER+1+3*i+2] = get_lowbyte(r[i].address);
+                m_rxSequenceSize += 6 + r[i].length;
+            }
+            txPacket[PKT1_LENGTH] = get_lowbyte(3*n + 3);
+        }
+
+        dxl_txrx_sequence(r, n);
+    }
+}
+
+void Dynamixel::dxl_write(const int id, const int address, const unsigned char *data, const int length, const int ack)
+{
+    int maxLength = (m_protocolVersion == PROTOCOL_DXLv2) ? (MAX_PACKET_LENGTH_dxlv2 - 12) : (MAX_PACKET_LENGTH_dxlv1 - 7);
+    if (data == nullptr || length <= 0 || length > maxLength)
+    {
+        TRACE_ERROR(DXL, "Cannot send 'Write' instruction for %i bytes!", length);
+        return;
+    }
+
+    while(m_commLock);
+
+    if (m_protocolVersion == PROTOCOL_DXLv2)
+    {
+        txPacket[PKT2_ID] = get_lowbyte(id);
+        txPacket[PKT2_INSTRUCTION] = INST_WRITE;
+        txPacket[PKT2_PARAMETER] = get_lowbyte(address);
+        txPacket[PKT2_PARAMETER+1] = get_highbyte(address);
+        std::memcpy(&txPacket[PKT2_PARAMETER+2], data, length);
+        txPacket[PKT2_LENGTH_L] = get_lowbyte(length + 5);
+        txPacket[PKT2_LENGTH_H] = get_highbyte(length + 5);
+    }
+    else
+    {
+        txPacket[PKT1_ID] = get_lowbyte(id);
+        txPacket[PKT1_INSTRUCTION] = INST_WRITE;
+        txPacket[PKT1_PARAMETER] = get_lowbyte(address);
+        std::memcpy(&txPacket[PKT1_PARAMETER+1], data, length);
+        txPacket[PKT1_LENGTH] = get_lowbyte(length + 3);
+    }
+
+    dxl_txrx_packet(ack);
+}
+
+void Dynamixel::dxl_sync_write(const int address, const int size, const DynamixelWriteRequest *requests, const int count)
+{
+    if (requests == nullptr || count <= 0 || size <= 0)
+    {
+        return;
+    }
+
+    // Number of devices fitting into one instruction packet
+    int packetCount = 0;
+    if (m_protocolVersion != PROTOCOL_DXLv2 && size + 9 > MAX_PACKET_LENGTH_dxlv1)
+    {
+        TRACE_ERROR(DXL, "Cannot send 'Sync Write' instruction for %i bytes!", size);
+        return;
+    }
+
+    if (m_protocolVersion == PROTOCOL_DXLv2)
+    {
+        packetCount = (MAX_PACKET_LENGTH_dxlv2 - 14) / (size + 1);
+    }
+    else
+    {
+        packetCount = (MAX_PACKET_LENGTH_dxlv1 - 8) / (size + 1);
+    }
+
+    for (int first = 0; first < count; first += packetCount)
+    {
+        int n = std::min(packetCount, count - first);
+
+        while(m_commLock);
+
+        if (m_protocolVersion == PROTOCOL_DXLv2)
+        {
+            txPacket[PKT2_ID] = BROADCAST_ID;
+            txPacket[PKT2_INSTRUCTION] = INST_SYNC_WRITE;
+            txPacket[PKT2_PARAMETER] = get_lowbyte(address);
+            txPacket[PKT2_PARAMETER+1] = get_highbyte(address);
+            txPacket[PKT2_PARAMETER+2] = get_lowbyte(size);
+            txPacket[PKT2_PARAMETER+3] = get_highbyte(size);
+
+            for (int i = 0; i < n; i++)
+            {
+                unsigned char *p = &txPacket[PKT2_PARAMETER + 4 + i*(size + 1)];
+                p[0] = get_lowbyte(requests[first + i].id);
+                std::memcpy(p + 1, requests[first + i].data.data(), size);
+            }
+
+            int length = 4 + n*(size + 1) + 3;
+            txPacket[PKT2_LENGTH_L] = get_lowbyte(length);
+            txPacket[PKT2_LENGTH_H] = get_highbyte(length);
+        }
+        else
+        {
+            txPacket[PKT1_ID] = BROADCAST_ID;
+            txPacket[PKT1_INSTRUCTION] = INST_SYNC_WRITE;
+            txPacket[PKT1_PARAMETER] = get_lowbyte(address);
+            txPacket[PKT1_PARAMETER+1] = get_lowbyte(size);
+
+            for (int i = 0; i < n; i++)
+            {
+                unsigned char *p = &txPacket[PKT1_PARAMETER + 2 + i*(size + 1)];
+                p[0] = get_lowbyte(requests[first + i].id);
+                std::memcpy(p + 1, requests[first + i].data.data(), size);
+            }
+
+            txPacket[PKT1_LENGTH] = get_lowbyte(2 + n*(size + 1) + 2);
+        }
+
+        // Devices never answer a sync write
+        dxl_txrx_packet(ACK_NO_REPLY);
+    }
+}
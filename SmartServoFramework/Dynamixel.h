@@ -27,18 +27,45 @@
 #include "SerialPortLinux.h"
 #include "SerialPortWindows.h"
 #include "SerialPortMacOS.h"
+#include "SerialPortNet.h"
+#include "SerialPortReplay.h"
 
 #include "ServoTools.h"
 #include "DynamixelTools.h"
 #include "ControlTables.h"
+#include "LatencyHistogram.h"
+#include "PacketCapture.h"
 
 #include <string>
 #include <vector>
+#include <chrono>
+
+/*!
+ * \brief A block of registers to read from one device, with a single, sync or bulk read.
+ */
+struct DynamixelReadRequest
+{
+    int id = 0;                         //!< Device ID.
+    int address = 0;                    //!< Address of the first register to read.
+    int length = 0;                     //!< Number of bytes to read.
+    std::vector <unsigned char> data;   //!< Bytes read, valid if status is COMM_RXSUCCESS.
+    int status = COMM_UNKNOWN;          //!< Communication status ('::CommStatus_e'). Stays COMM_UNKNOWN if the device has not been asked.
+    int error = 0;                      //!< Device error bitfield, from its status packet.
+};
+
+/*!
+ * \brief Register bytes to write into one device, with a sync write.
+ */
+struct DynamixelWriteRequest
+{
+    int id = 0;                         //!< Device ID.
+    std::vector <unsigned char> data;   //!< Register bytes, little endian.
+};
 
 /*!
  * \brief The Dynamixel communication protocols implementation
  * \todo Rename to DynamixelProtocol
- * \todo Handle "sync" and "bulk" read/write operations.
+ * \todo Handle "bulk" write operations.
  *
  * This class provide the low level API to handle communication with servos.
  * It can generate instruction packets and send them over a serial link. This class
@@ -68,10 +95,19 @@ private:
     int m_commLock = 0;
     int m_commStatus = COMM_RXSUCCESS;  //!< Last communication status
 
+    int m_rxExpectedId = -1;            //!< ID of the next status packet, when several devices answer a sync or bulk read
+    int m_rxSequenceSize = 0;           //!< Total size of the status packets answering a sync or bulk read
+
+    std::chrono::steady_clock::time_point m_txTime; //!< When the last instruction packet has been sent
+    std::chrono::steady_clock::time_point m_rxTime; //!< When the device answering a sync or bulk read started its turn (end of the previous status packet)
+    LatencyMonitor m_latency;           //!< Transaction latency histograms
+    PacketCapture m_capture;            //!< Binary capture of the serial traffic
+
     // Serial communication methods, using one of the SerialPort[Linux/Mac/Windows] implementations.
     void dxl_tx_packet();
     void dxl_rx_packet();
     void dxl_txrx_packet(int ack);
+    void dxl_txrx_sequence(DynamixelReadRequest *requests, const int count);
 
 protected:
     Dynamixel();
@@ -162,20 +198,66 @@ protected:
     void dxl_write_byte(const int id, const int address, const int value, const int ack = ACK_DEFAULT);
     int dxl_read_word(const int id, const int address, const int ack = ACK_DEFAULT);
     void dxl_write_word(const int id, const int address, const int value, const int ack = ACK_DEFAULT);
+
+    /*!
+     * \brief Read a block of registers from one device, with a single 'Read' instruction.
+     * \param request: Device, address and length to read. Filled with the bytes read and the communication status.
+     * \param ack: Ack policy in effect.
+     */
+    void dxl_read(DynamixelReadRequest &request, const int ack = ACK_DEFAULT);
+
+    /*!
+     * \brief Read the same block of registers from several devices, with one 'Sync Read' instruction.
+     * \param requests: Devices to read. They must all use the address and length of the first request.
+     * \param count: Number of requests.
+     *
+     * Only available with protocol v2. The devices answer in turn: if one of them
+     * doesn't, the following requests keep a COMM_UNKNOWN status and may be read
+     * again separately. Requests that don't fit into one instruction packet are
+     * split across several.
+     */
+    void dxl_sync_read(DynamixelReadRequest *requests, const int count);
+
+    /*!
+     * \brief Read a block of registers (of any address and length) from several devices, with one 'Bulk Read' instruction.
+     * \param requests: Devices to read.
+     * \param count: Number of requests.
+     *
+     * Available with protocol v2, and with protocol v1 on MX devices. The devices
+     * answer in turn: if one of them doesn't, the following requests keep a
+     * COMM_UNKNOWN status and may be read again separately. Requests that don't
+     * fit into one instruction packet (about 48 devices with protocol v1) are
+     * split across several.
+     */
+    void dxl_bulk_read(DynamixelReadRequest *requests, const int count);
+
+    /*!
+     * \brief Write several consecutive registers of a device, with one 'Write' instruction.
+     * \param id: Device ID.
+     * \param address: Address of the first register.
+     * \param data: Register bytes, little endian.
+     * \param length: Number of bytes to write.
+     * \param ack: Ack policy for this instruction.
+     */
+    void dxl_write(const int id, const int address, const unsigned char *data, const int length, const int ack = ACK_DEFAULT);
+
+    /*!
+     * \brief Write the same registers of several devices, with 'Sync Write' instructions.
+     * \param address: Address of the first register.
+     * \param size: Number of bytes to write into each device.
+     * \param requests: Devices and register bytes to write ('size' bytes each).
+     * \param count: Number of requests.
+     *
+     * Devices never answer a sync write. With protocol v1, a sync write is split
+     * into several instruction packets if the requests don't fit into one.
+     */
+    void dxl_sync_write(const int address, const int size, const DynamixelWriteRequest *requests, const int count);
 /*
     // TODO // Reg write
     void dxl_reg_write(const int id, ???)
 
-    // TODO // Sync read/write register instructions
-    std::vector <int> dxl_sync_read_byte(std::vector <int> ids, int address);
-    void dxl_sync_write_byte(std::vector <int> ids, int address, int value);
-    std::vector <int> dxl_sync_read_word(std::vector <int> ids, int address);
-    void dxl_sync_write_word(std::vector <int> ids, int address, int value);
-
-    // TODO // Bulk read/write register instructions
-    std::vector <int> dxl_bulk_read_byte(std::vector <int> ids, int address);
+    // TODO // Bulk write register instructions
     void dxl_bulk_write_byte(std::vector <int> ids, int address, int value);
-    std::vector <int> dxl_bulk_read_word(std::vector <int> ids, int address);
     void dxl_bulk_write_word(std::vector <int> ids, int address, int value);
 */
 public:
@@ -197,6 +279,64 @@ public:
      */
     void serialSetLatency(int latency);
 
+    /*!
+     * \brief Get the bus utilization of the serial port associated with this Dynamixel instance.
+     * \return A snapshot of the serial port counters, or an empty one if no serial port is open.
+     */
+    SerialPortStats serialGetStats();
+
+    /*!
+     * \brief Reset the bus utilization counters of the serial port.
+     */
+    void serialResetStats();
+
+    /*!
+     * \brief Get the estimated time needed to read/write one byte on the serial port.
+     * \return The time per byte in milliseconds, or 0 if no serial port is open.
+     */
+    double serialGetByteTime();
+
+    /*!
+     * \brief Get the latency histogram summary of a transaction type, between the instruction packet and the end of its status packet.
+     * \param instruction: Transaction type (using ::LatencyInstructions_e).
+     * \return The latency summary, in microseconds.
+     */
+    LatencyStats getInstructionLatency(const int instruction);
+
+    /*!
+     * \brief Get the latency histogram summary of the transactions answered by a device.
+     * \param id: Device ID.
+     * \return The latency summary, in microseconds.
+     *
+     * During sync and bulk reads, a device is timed from the end of the
+     * previous status packet, so its position in the sequence doesn't count.
+     */
+    LatencyStats getServoLatency(const int id);
+
+    /*!
+     * \brief Clear the latency histograms.
+     */
+    void resetLatency();
+
+    /*!
+     * \brief Start recording every instruction and status packet exchanged on the serial port into a binary capture file.
+     * \param path: Path of the capture file.
+     * \return True if the capture has started.
+     *
+     * Captures can be replayed later by opening a "replay://<path>" device.
+     */
+    bool serialCaptureStart(const std::string &path);
+
+    /*!
+     * \brief Stop the capture and close the capture file.
+     */
+    void serialCaptureStop();
+
+    /*!
+     * \brief Check if the serial traffic is being captured.
+     */
+    bool serialCaptureRunning();
+
     /*!
      * \brief setAckPolicy
      * \param ack: Ack policy value, using '::AckPolicy_e' enum.
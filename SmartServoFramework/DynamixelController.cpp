@@ -24,18 +24,17 @@
 #include "minitraces.h"
 
 // C++ standard libraries
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <thread>
 #include <mutex>
 
-// Enable latency timer
-//#define LATENCY_TIMER
-
 DynamixelController::DynamixelController(int servoSerie, int ctrlFrequency):
     ServoController(ctrlFrequency)
 {
     m_servoSerie = servoSerie;
+    setDefaultPollingRates();
 }
 
 DynamixelController::~DynamixelController()
@@ -43,6 +42,18 @@ DynamixelController::~DynamixelController()
     disconnect();
 }
 
+void DynamixelController::setDefaultPollingRates()
+{
+    // "full speed" update loop (every loop, even if the adaptive frequency raises it)
+    setPollingRate({REG_CURRENT_POSITION}, SYNCLOOP_MAX_FREQUENCY);
+
+    // x/4 Hz "feedback" update loop
+    setPollingRate({REG_CURRENT_SPEED, REG_CURRENT_LOAD, REG_MOVING}, syncloopFrequency / 4.0);
+
+    // 1 Hz "low priority" update loop
+    setPollingRate({REG_CURRENT_VOLTAGE, REG_CURRENT_TEMPERATURE}, 1.0);
+}
+
 void DynamixelController::updateInternalSettings()
 {
     if (m_servoSerie != SERVO_UNKNOWN)
@@ -171,6 +182,64 @@ void DynamixelController::serialSetLatency_wrapper(int latency)
     serialSetLatency(latency);
 }
 
+SerialPortStats DynamixelController::serialGetStats_wrapper()
+{
+    return serialGetStats();
+}
+
+void DynamixelController::serialResetStats_wrapper()
+{
+    serialResetStats();
+}
+
+LatencyStats DynamixelController::getInstructionLatency_wrapper(const int instruction)
+{
+    return getInstructionLatency(instruction);
+}
+
+LatencyStats DynamixelController::getServoLatency_wrapper(const int id)
+{
+    return getServoLatency(id);
+}
+
+void DynamixelController::resetLatency_wrapper()
+{
+    resetLatency();
+    syncloopHistogram.reset();
+}
+
+bool DynamixelController::serialCaptureStart_wrapper(const std::string &path)
+{
+    // The controller's thread captures the frames, so it must (re)start the capture itself
+    if (getState() >= state_started)
+    {
+        {
+            std::lock_guard <std::mutex> lock(capturePathLock);
+            capturePath = path;
+        }
+
+        miniMessages m {ctrl_capture_start, std::chrono::steady_clock::time_point(), nullptr, 0, 0, 0};
+        sendMessageAndWait(&m);
+
+        return serialCaptureRunning();
+    }
+
+    return serialCaptureStart(path);
+}
+
+void DynamixelController::serialCaptureStop_wrapper()
+{
+    if (getState() >= state_started)
+    {
+        miniMessages m {ctrl_capture_stop, std::chrono::steady_clock::time_point(), nullptr, 0, 0, 0};
+        sendMessageAndWait(&m);
+    }
+    else
+    {
+        serialCaptureStop();
+    }
+}
+
 void DynamixelController::autodetect_internal(int start, int stop, int bail)
 {
     setState(state_scanning);
@@ -249,12 +318,8 @@ void DynamixelController::autodetect_internal(int start, int stop, int bail)
             {
                 servoListLock.lock();
 
-                // Add the servo to the controller
-                servoList.push_back(servo);
-
-                // Mark it for an "initial read" and synchronization
-                updateList.push_back(servo->getId());
-                syncList.push_back(servo->getId());
+                // Add the servo to the controller, and mark it for an "initial read" and synchronization
+                addServo_internal(servo);
 
                 servoListLock.unlock();
 
@@ -283,29 +348,290 @@ void DynamixelController::autodetect_internal(int start, int stop, int bail)
     }
 }
 
+void DynamixelController::queueCommit(ServoDynamixel *servo, const WriteBlock &block)
+{
+    const int size = static_cast<int>(block.data.size());
+    CommitGroup *group = nullptr;
+
+    for (size_t i = 0; i < commitGroupCount; i++)
+    {
+        if (commitGroups[i].address == block.address && commitGroups[i].size == size)
+        {
+            group = &commitGroups[i];
+            break;
+        }
+    }
+
+    if (group == nullptr)
+    {
+        if (commitGroupCount == commitGroups.size())
+        {
+            commitGroups.emplace_back();
+        }
+
+        group = &commitGroups[commitGroupCount++];
+        group->address = block.address;
+        group->size = size;
+        group->count = 0;
+    }
+
+    if (group->count == group->writes.size())
+    {
+        group->writes.emplace_back();
+        group->servos.push_back(nullptr);
+    }
+
+    DynamixelWriteRequest &w = group->writes[group->count];
+    w.id = servo->getId();
+    w.data.assign(block.data.begin(), block.data.end());
+    group->servos[group->count] = servo;
+    group->count++;
+}
+
+void DynamixelController::writeCommits()
+{
+    for (size_t i = 0; i < commitGroupCount; i++)
+    {
+        CommitGroup &g = commitGroups[i];
+
+        if (g.count == 1)
+        {
+            ServoDynamixel *s = g.servos[0];
+
+            dxl_write(g.writes[0].id, g.address, g.writes[0].data.data(), g.size, s->getStatusReturnLevel());
+            s->setError(dxl_get_rxpacket_error());
+            updateErrorCount(dxl_get_com_error_count());
+            dxl_print_error();
+        }
+        else
+        {
+            TRACE_1(DXL, "Sync writing addr: '%i' size: '%i' for %zu devices", g.address, g.size, g.count);
+
+            dxl_sync_write(g.address, g.size, g.writes.data(), static_cast<int>(g.count));
+            updateErrorCount(dxl_get_com_error_count());
+            dxl_print_error();
+        }
+    }
+
+    commitGroupCount = 0;
+}
+
+void DynamixelController::planFeedback()
+{
+    const int count = static_cast<int>(feedbackReads.size());
+    feedbackGrouped = count;
+
+    // Only MX devices can answer a bulk read with protocol v1, they go first
+    if (m_protocolVersion == PROTOCOL_DXLv1)
+    {
+        auto it = std::partition(feedbackReads.begin(), feedbackReads.end(),
+                                 [](const FeedbackRead &f) { return f.servo->getDeviceSerie() == SERVO_MX; });
+        feedbackGrouped = static_cast<int>(it - feedbackReads.begin());
+    }
+
+    // One register block per servo, from its first to its last due register
+    feedbackRequests.resize(count);
+    feedbackSameBlock = true;
+
+    for (int i = 0; i < count; i++)
+    {
+        const FeedbackRead &f = feedbackReads[i];
+        DynamixelReadRequest &r = feedbackRequests[i];
+
+        int first = f.addresses[0], last = f.addresses[0] + f.sizes[0];
+        for (int j = 1; j < f.registerCount; j++)
+        {
+            first = std::min(first, f.addresses[j]);
+            last = std::max(last, f.addresses[j] + f.sizes[j]);
+        }
+
+        r.id = f.servo->getId();
+        r.address = first;
+        r.length = last - first;
+        r.status = COMM_UNKNOWN;
+
+        if (i > 0 && i < feedbackGrouped &&
+            (r.address != feedbackRequests[0].address || r.length != feedbackRequests[0].length))
+        {
+            feedbackSameBlock = false;
+        }
+    }
+
+    // Packet sizes: instruction packets overhead, then status packets overhead and payload
+    const bool v2 = (m_protocolVersion == PROTOCOL_DXLv2);
+    const int statusSize = v2 ? 11 : 6;
+    int grouped = (feedbackGrouped > 1) ? feedbackGrouped : 0;
+
+    feedbackBytes = 0;
+    feedbackTransactions = 0;
+
+    if (grouped > 0)
+    {
+        // Requests that don't fit into one instruction packet are split across several
+        int packetCount = 0;
+        if (v2)
+            packetCount = feedbackSameBlock ? (MAX_PACKET_LENGTH_dxlv2 - 14) : ((MAX_PACKET_LENGTH_dxlv2 - 10) / 5);
+        else
+            packetCount = (MAX_PACKET_LENGTH_dxlv1 - 6) / 3;
+        int packets = (grouped + packetCount - 1) / packetCount;
+
+        if (v2)
+            feedbackBytes += feedbackSameBlock ? (14 * packets + grouped) : (10 * packets + 5 * grouped);
+        else
+            feedbackBytes += 7 * packets + 3 * grouped;
+        feedbackTransactions += packets;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        feedbackBytes += statusSize + feedbackRequests[i].length;
+
+        if (i >= grouped)
+        {
+            feedbackBytes += v2 ? 14 : 8;
+            feedbackTransactions++;
+        }
+    }
+}
+
+void DynamixelController::shedFeedback()
+{
+    planFeedback();
+
+    double remaining = getRemainingBudget();
+
+    for (int priority = PRIORITY_DIAGNOSTIC; priority > PRIORITY_POSITION; priority--)
+    {
+        if (estimateCost(feedbackBytes, feedbackTransactions) <= remaining)
+        {
+            break;
+        }
+
+        bool shed = false;
+        for (std::vector <FeedbackRead>::iterator it = feedbackReads.begin(); it != feedbackReads.end();)
+        {
+            FeedbackRead &f = *it;
+            int kept = 0;
+
+            for (int j = 0; j < f.registerCount; j++)
+            {
+                if (f.priorities[j] >= priority)
+                {
+                    deferRegister(f.servo->getId(), f.registers[j]);
+                    shed = true;
+                }
+                else
+                {
+                    f.registers[kept] = f.registers[j];
+                    f.addresses[kept] = f.addresses[j];
+                    f.sizes[kept] = f.sizes[j];
+                    f.priorities[kept] = f.priorities[j];
+                    kept++;
+                }
+            }
+
+            f.registerCount = kept;
+            if (kept == 0)
+                it = feedbackReads.erase(it);
+            else
+                ++it;
+        }
+
+        if (shed)
+        {
+            TRACE_1(DXL, "Loop budget exceeded, priority %i feedback deferred to the next loop", priority);
+            planFeedback();
+        }
+    }
+}
+
+void DynamixelController::readFeedback()
+{
+    const int count = static_cast<int>(feedbackReads.size());
+    const int grouped = feedbackGrouped;
+    const bool sameBlock = feedbackSameBlock;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (grouped > 1)
+    {
+        if (m_protocolVersion == PROTOCOL_DXLv2 && sameBlock)
+        {
+            dxl_sync_read(feedbackRequests.data(), grouped);
+        }
+        else
+        {
+            dxl_bulk_read(feedbackRequests.data(), grouped);
+        }
+    }
+
+    // Devices without bulk read support, or not answering because a previous device didn't
+    for (int i = 0; i < count; i++)
+    {
+        if (feedbackRequests[i].status == COMM_UNKNOWN)
+        {
+            dxl_read(feedbackRequests[i], feedbackReads[i].servo->getStatusReturnLevel());
+        }
+    }
+
+    double duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    updateCostModel(duration, feedbackBytes, feedbackTransactions);
+
+    for (int i = 0; i < count; i++)
+    {
+        const FeedbackRead &f = feedbackReads[i];
+        const DynamixelReadRequest &r = feedbackRequests[i];
+
+        // The feedback of a device is published as one modification of its register table
+        int values[64];
+
+        if (r.status == COMM_RXSUCCESS)
+        {
+            for (int j = 0; j < f.registerCount; j++)
+            {
+                // Little endian values
+                unsigned value = 0;
+                for (int b = 0; b < f.sizes[j]; b++)
+                {
+                    value |= static_cast<unsigned>(r.data[f.addresses[j] - r.address + b]) << (8 * b);
+                }
+
+                values[j] = static_cast<int>(value);
+            }
+
+            f.servo->updateValues(f.registers, values, f.registerCount);
+            f.servo->setError(r.error);
+        }
+        else
+        {
+            // Like a failed read, the error code is given to every register
+            std::fill(values, values + f.registerCount, r.status);
+            f.servo->updateValues(f.registers, values, f.registerCount);
+
+            updateErrorCount(1);
+            TRACE_ERROR(DXL, "[#%i] Unable to read feedback registers: communication status '%i'", r.id, r.status);
+        }
+    }
+}
+
 void DynamixelController::run()
 {
     TRACE_INFO(MAPI, "DynamixelController::run(port: '%s' / tid: '%i')",
                serialGetCurrentDevice().c_str(), std::this_thread::get_id());
 
-    std::chrono::time_point<std::chrono::system_clock> start, end;
-
     while (getState() >= state_started)
     {
         // Loop timer
-        start = std::chrono::system_clock::now();
+        beginSyncLoop();
+        syncloopByteTime = serialGetByteTime() * 1000.0;
 
         // MESSAGE PARSING
         ////////////////////////////////////////////////////////////////////////
 
-        unsigned ignoreMsg = 0;
+        miniMessages m;
 
-        m_mutex.lock();
-        while (m_queue.empty() == false && m_queue.size() != ignoreMsg)
+        while (receiveMessage(m) || receiveDelayedMessage(m))
         {
-            miniMessages m = m_queue.front();
-            m_mutex.unlock();
-
             switch (m.msg)
             {
             case ctrl_device_autodetect:
@@ -324,25 +650,25 @@ void DynamixelController::run()
                 break;
 
             case ctrl_device_delayed_add:
-                if (delayedAddServos_internal(m.delay, m.p1, m.p2) == 1)
-                {
-                    ignoreMsg++;
-                    sendMessage(&m);
-                }
+                delayedAddServos_internal(m.p1, m.p2);
+                break;
+
+            case ctrl_capture_start:
+            {
+                std::lock_guard <std::mutex> lock(capturePathLock);
+                serialCaptureStart(capturePath);
+                break;
+            }
+            case ctrl_capture_stop:
+                serialCaptureStop();
                 break;
 
             case ctrl_state_pause:
                 TRACE_INFO(MAPI, ">> THREAD (tid: '%i') paused by message", std::this_thread::get_id());
-                m_mutex.lock();
-                m_queue.pop_front();
-                m_mutex.unlock();
                 return;
                 break;
             case ctrl_state_stop:
                 TRACE_INFO(MAPI, ">> THREAD (tid: '%i') termination by 'stop message'", std::this_thread::get_id());
-                m_mutex.lock();
-                m_queue.pop_front();
-                m_mutex.unlock();
                 return;
                 break;
 
@@ -350,17 +676,16 @@ void DynamixelController::run()
                 TRACE_WARNING(DXL, "Unknown message type: '%i'", m.msg);
                 break;
             }
-
-            m_mutex.lock();
-            m_queue.pop_front();
         }
-        m_mutex.unlock();
 
         // ACTION LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        servoListLock.lock();
-        for (auto s: servoList)
+        // Devices registered at the beginning of this cycle; registrations happening
+        // during this cycle (ex: from a user thread) will be visible at the next one
+        std::shared_ptr <const ServoSnapshot> servos = getServoSnapshot();
+
+        for (auto s: servos->servos)
         {
             int id = s->getId();
             int ack = s->getStatusReturnLevel();
@@ -384,61 +709,33 @@ void DynamixelController::run()
             if (rebootProgrammed == 1)
             {
                 // Remove servo from sync/update lists; Need to be added again after reboot!
-                for (std::vector <int>::iterator it = updateList.begin(); it != updateList.end();)
-                {
-                    if (*it == id)
-                    { updateList.erase(it); }
-                    else
-                    { ++it; }
-                }
-                for (std::vector <int>::iterator it = syncList.begin(); it != syncList.end();)
-                {
-                    if (*it == id)
-                    { syncList.erase(it); }
-                    else
-                    { ++it; }
-                }
+                unsyncServo_internal(id);
 
                 // Reboot
                 dxl_reboot(id, ack);
                 TRACE_INFO(DXL, "Rebooting servo #%i...", id);
 
-                miniMessages m {ctrl_device_delayed_add, std::chrono::system_clock::now() + std::chrono::seconds(2), nullptr, id, 0, 0};
-                sendMessage(&m);
+                miniMessages m {ctrl_device_delayed_add, std::chrono::steady_clock::now() + std::chrono::seconds(2), nullptr, id, 0, 0};
+                delayMessage(m);
             }
 
             if (resetProgrammed > 0)
             {
                 // Remove servo from sync/update lists; Need to be added again after reset!
-                for (std::vector <int>::iterator it = updateList.begin(); it != updateList.end();)
-                {
-                    if (*it == id)
-                    { updateList.erase(it); }
-                    else
-                    { ++it; }
-                }
-                for (std::vector <int>::iterator it = syncList.begin(); it != syncList.end();)
-                {
-                    if (*it == id)
-                    { syncList.erase(it); }
-                    else
-                    { ++it; }
-                }
+                unsyncServo_internal(id);
 
                 // Reset
                 dxl_reset(id, resetProgrammed, ack);
                 TRACE_INFO(DXL, "Resetting servo #%i (setting: %i)...", id, resetProgrammed);
 
-                miniMessages m {ctrl_device_delayed_add, std::chrono::system_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
-                sendMessage(&m);
+                miniMessages m {ctrl_device_delayed_add, std::chrono::steady_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
+                delayMessage(m);
             }
         }
-        servoListLock.unlock();
 
         // INITIAL READ LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        servoListLock.lock();
         if (updateList.empty() == false)
         {
             std::vector <int>::iterator itr;
@@ -446,329 +743,342 @@ void DynamixelController::run()
             {
                 setState(state_reading);
 
-                for (auto s: servoList)
+                Servo *s = servos->find(*itr);
+                if (s != nullptr)
                 {
-                    if (s->getId() == (*itr))
-                    {
-                        int id = s->getId();
-                        int ack = s->getStatusReturnLevel();
+                    int id = s->getId();
+                    int ack = s->getStatusReturnLevel();
 
-                        for (int ctid = 1; ctid < s->getRegisterCount(); ctid++)
-                        {
-                            int reg_name = getRegisterName(s->getControlTable(), ctid);
-                            int reg_addr = getRegisterAddr(s->getControlTable(), reg_name);
-                            int reg_size = getRegisterSize(s->getControlTable(), reg_name);
+                    for (int ctid = 1; ctid < s->getRegisterCount(); ctid++)
+                    {
+                        int reg_name = getRegisterName(s->getControlTable(), ctid);
+                        int reg_addr = getRegisterAddr(s->getControlTable(), reg_name);
+                        int reg_size = getRegisterSize(s->getControlTable(), reg_name);
 
-                            TRACE_1(DXL, "Reading value for reg [%i] name: '%s' addr: '%i' size: '%i'", ctid, getRegisterNameTxt(reg_name).c_str(), reg_addr, reg_size);
+                        TRACE_1(DXL, "Reading value for reg [%i] name: '%s' addr: '%i' size: '%i'", ctid, getRegisterNameTxt(reg_name).c_str(), reg_addr, reg_size);
 
-                            if (reg_size == 1)
-                            {
-                                s->updateValue(reg_name, dxl_read_byte(id, reg_addr, ack));
-                            }
-                            else //if (regsize == 2)
-                            {
-                                s->updateValue(reg_name, dxl_read_word(id, reg_addr, ack));
-                            }
-                            s->setError(dxl_get_rxpacket_error());
-                            updateErrorCount(dxl_get_com_error_count());
-                            dxl_print_error();
+                        if (reg_size == 1)
+                        {
+                            s->updateValue(reg_name, dxl_read_byte(id, reg_addr, ack));
                         }
-
-                        // Once all registers are read, remove the servo from the "updateList"
-                        itr = updateList.erase(itr);
+                        else //if (regsize == 2)
+                        {
+                            s->updateValue(reg_name, dxl_read_word(id, reg_addr, ack));
+                        }
+                        s->setError(dxl_get_rxpacket_error());
+                        updateErrorCount(dxl_get_com_error_count());
+                        dxl_print_error();
                     }
                 }
+
+                // Once all registers are read, remove the servo from the "updateList"
+                itr = updateList.erase(itr);
             }
 
             setState(state_ready);
         }
-        servoListLock.unlock();
 
         // SYNCHRONIZATION LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        int cumulid = 0;
-
-        servoListLock.lock();
+        // Servos to synchronize during this cycle, in the 'syncList' order
+        syncServos.clear();
         for (auto id: syncList)
         {
-            cumulid++;
-            cumulid %= syncloopFrequency;
+            Servo *s_raw = servos->find(id);
+            if (s_raw != nullptr)
+            {
+                syncServos.push_back(static_cast<ServoDynamixel*>(s_raw));
+            }
+        }
 
-            for (auto s_raw: servoList)
+        // Unregister device if it reach an error count too high
+        // Count must be high enough to avoid "false positive": device producing a lot of errors but still present on the serial link
+        for (std::vector <ServoDynamixel *>::iterator it = syncServos.begin(); it != syncServos.end();)
+        {
+            if ((*it)->getErrorCount() > 16)
             {
-                servoListLock.unlock();
+                TRACE_ERROR(DXL, "Device #%i has an error count too high and is going to be unregistered from its controller on '%s'...", (*it)->getId(), serialGetCurrentDevice().c_str());
+                unregisterServo(*it);
+                it = syncServos.erase(it);
+            }
+            else
+            { ++it; }
+        }
 
-                ServoDynamixel *s = static_cast<ServoDynamixel*>(s_raw);
+        feedbackReads.clear();
+        updatePollingSchedule();
+        updateTrajectories(*servos);
 
-                if (s->getId() == id)
-                {
-                    int ack = s->getStatusReturnLevel();
+        for (auto s: syncServos)
+        {
+            int id = s->getId();
+            int ack = s->getStatusReturnLevel();
+
+            // Commit register modifications, only visiting the registers marked by the setters
+            uint64_t commits = s->takeCommits();
+            uint64_t kept = 0;
+
+            writePlanner.clear();
+            writePlanner.setGapTolerance(commitGapTolerance);
+
+            while (commits)
+            {
+                int ctid = getFirstCommit(commits);
+                commits &= commits - 1;
 
-                    // Unregister device if it reach an error count too high
-                    // Count must be high enough to avoid "false positive": device producing a lot of errors but still present on the serial link
-                    if (s->getErrorCount() > 16)
+                int reg_name = getRegisterName(s->getControlTable(), ctid);
+                int reg_addr = getRegisterAddr(s->getControlTable(), reg_name);
+                int reg_size = getRegisterSize(s->getControlTable(), reg_name);
+
+                if ((s->getSpeedMode() == SPEED_AUTO && (reg_name != REG_GOAL_POSITION && reg_name != REG_GOAL_SPEED)) == false)
+                {
+                    if (getRegisterAddr(s->getControlTable(), reg_name, REGISTER_ROM) < 0)
                     {
-                        TRACE_ERROR(DXL, "Device #%i has an error count too high and is going to be unregistered from its controller on '%s'...", id, serialGetCurrentDevice().c_str());
-                        unregisterServo(s);
+                        // RAM registers are written after this loop, merged and grouped with the other servos
+                        TRACE_1(DXL, "Queuing value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
+                                s->getValue(reg_name), ctid, getRegisterNameTxt(reg_name).c_str(), reg_addr, reg_size);
+
+                        writePlanner.add(reg_addr, reg_size, s->getValue(reg_name));
                         continue;
                     }
 
-                    // Commit register modifications
-                    for (int ctid = 0; ctid < s->getRegisterCount(); ctid++)
+                    TRACE_1(DXL, "Writing value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
+                            s->getValue(reg_name), ctid, getRegisterNameTxt(reg_name).c_str(), reg_addr, reg_size);
+
+                    if (reg_size == 1)
                     {
-                        int reg_name = getRegisterName(s->getControlTable(), ctid);
+                        dxl_write_byte(id, reg_addr, s->getValue(reg_name), ack);
+                    }
+                    else //if (regsize == 2)
+                    {
+                        dxl_write_word(id, reg_addr, s->getValue(reg_name), ack);
+                    }
+
+                    s->setError(dxl_get_rxpacket_error());
+                    updateErrorCount(dxl_get_com_error_count());
+                    dxl_print_error();
+
+                    if (reg_name == REG_ID)
+                    {
+                        if (s->changeInternalId(s->getValue(reg_name)) == 1)
+                        {
+                            reindexServo(s, id);
+                            s->reboot();
+                        }
+                    }
+                }
+                else
+                {
+                    kept |= (1ULL << ctid);
+                }
+            }
+
+            // Modifications not committed yet stay pending
+            if (kept)
+            {
+                s->restoreCommits(kept);
+            }
+
+            // Contiguous RAM registers are merged into one block
+            size_t blockCount = writePlanner.plan(s, REGISTER_RAM);
+            for (size_t i = 0; i < blockCount; i++)
+            {
+                queueCommit(s, writePlanner.getBlock(i));
+            }
+
+            // Feedback registers due during this cycle
+            if (ack != ACK_NO_REPLY)
+            {
+                int due[64];
+                int priorities[64];
+                int dueCount = getDueRegisters(id, due, priorities, 64);
+
+                // Registers missing from this device control table are skipped
+                FeedbackRead f;
+                f.servo = s;
+                for (int i = 0; i < dueCount; i++)
+                {
+                    int reg_addr = s->gaddr(due[i]);
+                    int reg_size = getRegisterSize(s->getControlTable(), due[i]);
+
+                    if (reg_addr >= 0 && reg_size > 0)
+                    {
+                        f.registers[f.registerCount] = due[i];
+                        f.addresses[f.registerCount] = reg_addr;
+                        f.sizes[f.registerCount] = reg_size;
+                        f.priorities[f.registerCount] = priorities[i];
+                        f.registerCount++;
+                    }
+                }
+
+                if (f.registerCount > 0)
+                {
+                    feedbackReads.push_back(f);
+                }
+            }
+        }
 
-                        if (s->getValueCommit(reg_name) == 1)
+        // Write the queued register modifications, one sync write per register
+        writeCommits();
+
+        // Read the due registers of all the servos, with as few transactions as possible,
+        // deferring the lower priority ones if they don't fit into this loop
+        shedFeedback();
+        readFeedback();
+
+        for (auto s: syncServos)
+        {
+            int id = s->getId();
+            int ack = s->getStatusReturnLevel();
+
+            // x Hz "full speed" update loop
+            {
+                // Goal pos
+                if (s->getValueCommit(REG_GOAL_POSITION) == 1)
+                {
+                    int cpos = s->getCurrentPosition();
+                    int gpos = s->getGoalPosition();
+                    int movingSpeed = 50; //s->getMovingSpeed();
+
+                    // Control modes:
+                    if (s->getSpeedMode() == SPEED_AUTO)
+                    {
+                        double k = 1.0; // acceleration factor
+                        double mot = 3.0; // margin of tolerance
+
+                        if (s->getCwAngleLimit() != 0 || s->getCcwAngleLimit() != 0) // JOINT MODE
                         {
-                            int reg_addr = getRegisterAddr(s->getControlTable(), reg_name);
-                            int reg_size = getRegisterSize(s->getControlTable(), reg_name);
+                            double step = static_cast<double>(s->getRunningDegrees()) / s->getSteps();
+                            double angle = static_cast<double>(gpos - cpos) * step;
+                            double angle_abs = std::fabs(angle);
+                            int speed = (movingSpeed + static_cast<int>(k * angle_abs));
 
-                            if ((s->getSpeedMode() == SPEED_AUTO && (reg_name != REG_GOAL_POSITION && reg_name != REG_GOAL_SPEED)) == false)
+                            if (angle_abs > mot)
                             {
-                                TRACE_1(DXL, "Writing value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
-                                        s->getValue(reg_name), ctid, getRegisterNameTxt(reg_name).c_str(), reg_addr, reg_size);
+                                // SPEED
+                                dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
+                                updateErrorCount(dxl_get_com_error_count());
+                                dxl_print_error();
+                                s->setError(dxl_get_rxpacket_error());
 
-                                if (reg_size == 1)
+                                // POS
+                                if (angle >= 0)
                                 {
-                                    dxl_write_byte(id, reg_addr, s->getValue(reg_name), ack);
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getSteps() - 1, ack);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
                                 }
-                                else //if (regsize == 2)
+                                else
                                 {
-                                    dxl_write_word(id, reg_addr, s->getValue(reg_name), ack);
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), 0, ack);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
                                 }
 
-                                s->commitValue(reg_name, 0);
+                                TRACE_2(DXL, "pos: '%i' Movingspeed: '%i' CurrentSpeed: '%i'   |   (> %i) (angle: %i)",
+                                        cpos, speed, s->getCurrentSpeed(), gpos, angle);
+                            }
+                            else // STOP
+                            {
+                                dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), movingSpeed, ack);
+                                s->setError(dxl_get_rxpacket_error());
+                                updateErrorCount(dxl_get_com_error_count());
+                                dxl_print_error();
+
+                                dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getGoalPosition(), ack);
                                 s->setError(dxl_get_rxpacket_error());
                                 updateErrorCount(dxl_get_com_error_count());
                                 dxl_print_error();
 
-                                if (reg_name == REG_ID)
-                                {
-                                    if (s->changeInternalId(s->getValue(reg_name)) == 1)
-                                    {
-                                        s->reboot();
-                                    }
-                                }
+                                TRACE_2(DXL, "[STOP] pos: '%i' speed: '%i'   |   (> %i) (angle: %i)",
+                                        cpos, speed, gpos, angle);
+                                s->commitValue(REG_GOAL_POSITION, 0);
                             }
                         }
-                    }
-
-                    // 1 Hz "low priority" update loop
-                    if (((syncloopCounter - cumulid) == 0) &&
-                        (ack != ACK_NO_REPLY))
-                    {
-                        // Read voltage
-                        s->updateValue(REG_CURRENT_VOLTAGE, dxl_read_byte(id, s->gaddr(REG_CURRENT_VOLTAGE), ack));
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
-
-                        // Read temp
-                        s->updateValue(REG_CURRENT_TEMPERATURE, dxl_read_byte(id, s->gaddr(REG_CURRENT_TEMPERATURE), ack));
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
-                    }
-
-                    // x/4 Hz "feedback" update loop
-                    if (((syncloopCounter - cumulid) % 4 == 0) &&
-                        (ack != ACK_NO_REPLY))
-                    {
-                        s->updateValue(REG_CURRENT_SPEED, dxl_read_word(id, s->gaddr(REG_CURRENT_SPEED), ack));
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
-
-                        s->updateValue(REG_CURRENT_LOAD, dxl_read_word(id, s->gaddr(REG_CURRENT_LOAD), ack));
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
-
-                        // Read moving
-                        s->updateValue(REG_MOVING, dxl_read_byte(id, s->gaddr(REG_MOVING), ack));
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
-                    }
+                        else // if (s->getCwAngleLimit() == 0 && s->getCcwAngleLimit() == 0) // WHEEL MODE
+                        {
+                            double step = 360.0 / s->getSteps();
+                            double angle = static_cast<double>(gpos - cpos) * step;
 
-                    // x Hz "full speed" update loop
-                    {
-                        // Get "current" values from devices, and write them into corresponding objects
-                        int cpos = dxl_read_word(id, s->gaddr(REG_CURRENT_POSITION), ack);
-                        s->updateValue(REG_CURRENT_POSITION, cpos);
-                        s->setError(dxl_get_rxpacket_error());
-                        updateErrorCount(dxl_get_com_error_count());
-                        dxl_print_error();
+                            if (angle > 180) angle -= 360;
+                            else if (angle < -180) angle += 360;
+                            double angle_abs = std::fabs(angle);
 
-                        // Goal pos
-                        if (s->getValueCommit(REG_GOAL_POSITION) == 1)
-                        {
-                            int gpos = s->getGoalPosition();
-                            int movingSpeed = 50; //s->getMovingSpeed();
+                            int speed = (movingSpeed + static_cast<int>(k * angle_abs));
 
-                            // Control modes:
-                            if (s->getSpeedMode() == SPEED_AUTO)
+                            if (angle_abs > mot)
                             {
-                                double k = 1.0; // acceleration factor
-                                double mot = 3.0; // margin of tolerance
-
-                                if (s->getCwAngleLimit() != 0 || s->getCcwAngleLimit() != 0) // JOINT MODE
+                                if (angle >= 0)
                                 {
-                                    double step = static_cast<double>(s->getRunningDegrees()) / s->getSteps();
-                                    double angle = static_cast<double>(gpos - cpos) * step;
-                                    double angle_abs = std::fabs(angle);
-                                    int speed = (movingSpeed + static_cast<int>(k * angle_abs));
-
-                                    if (angle_abs > mot)
-                                    {
-                                        // SPEED
-                                        dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
-                                        updateErrorCount(dxl_get_com_error_count());
-                                        dxl_print_error();
-                                        s->setError(dxl_get_rxpacket_error());
-
-                                        // POS
-                                        if (angle >= 0)
-                                        {
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getSteps() - 1, ack);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-                                        else
-                                        {
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), 0, ack);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-
-                                        TRACE_2(DXL, "pos: '%i' Movingspeed: '%i' CurrentSpeed: '%i'   |   (> %i) (angle: %i)",
-                                                cpos, speed, s->getCurrentSpeed(), gpos, angle);
-                                    }
-                                    else // STOP
-                                    {
-                                        dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), movingSpeed, ack);
-                                        s->setError(dxl_get_rxpacket_error());
-                                        updateErrorCount(dxl_get_com_error_count());
-                                        dxl_print_error();
-
-                                        dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getGoalPosition(), ack);
-                                        s->setError(dxl_get_rxpacket_error());
-                                        updateErrorCount(dxl_get_com_error_count());
-                                        dxl_print_error();
-
-                                        TRACE_2(DXL, "[STOP] pos: '%i' speed: '%i'   |   (> %i) (angle: %i)",
-                                                cpos, speed, gpos, angle);
-                                        s->commitValue(REG_GOAL_POSITION, 0);
-                                    }
+                                    // SPEED (counter clockwise)
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
                                 }
-                                else // if (s->getCwAngleLimit() == 0 && s->getCcwAngleLimit() == 0) // WHEEL MODE
+                                else
                                 {
-                                    double step = 360.0 / s->getSteps();
-                                    double angle = static_cast<double>(gpos - cpos) * step;
-
-                                    if (angle > 180) angle -= 360;
-                                    else if (angle < -180) angle += 360;
-                                    double angle_abs = std::fabs(angle);
-
-                                    int speed = (movingSpeed + static_cast<int>(k * angle_abs));
-
-                                    if (angle_abs > mot)
-                                    {
-                                        if (angle >= 0)
-                                        {
-                                            // SPEED (counter clockwise)
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-                                        else
-                                        {
-                                            // SPEED (clockwise)
-                                            speed +=  1024;
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-
-                                        TRACE_2(DXL, "pos: '%i' Movingspeed: '%i' CurrentSpeed: '%i'   |   (> %i) (angle: %i)",
-                                                cpos, speed, s->getCurrentSpeed(), gpos, angle);
-                                    }
-                                    else // STOP
-                                    {
-                                        if (dxl_read_word(id, s->gaddr(REG_GOAL_SPEED), ack) >= 1024)
-                                        {
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), ack, 1024);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-                                        else
-                                        {
-                                            dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), 0, ack);
-                                            s->setError(dxl_get_rxpacket_error());
-                                            updateErrorCount(dxl_get_com_error_count());
-                                            dxl_print_error();
-                                        }
-
-                                        dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getGoalPosition(), ack);
-                                        s->setError(dxl_get_rxpacket_error());
-                                        updateErrorCount(dxl_get_com_error_count());
-                                        dxl_print_error();
-
-                                        TRACE_2(DXL, "[STOP] pos: '%i' speed: '%i'   |   (> %i) (angle: %i)",
-                                                cpos, speed, gpos, angle);
-                                        s->commitValue(REG_GOAL_POSITION, 0);
-                                    }
+                                    // SPEED (clockwise)
+                                    speed +=  1024;
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), speed, ack);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
                                 }
+
+                                TRACE_2(DXL, "pos: '%i' Movingspeed: '%i' CurrentSpeed: '%i'   |   (> %i) (angle: %i)",
+                                        cpos, speed, s->getCurrentSpeed(), gpos, angle);
                             }
-                            else if (s->getSpeedMode() == SPEED_MANUAL)
+                            else // STOP
                             {
-                                if (s->getCwAngleLimit() == 0 || s->getCcwAngleLimit() == 0) // WHEEL MODE
+                                if (dxl_read_word(id, s->gaddr(REG_GOAL_SPEED), ack) >= 1024)
+                                {
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), ack, 1024);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
+                                }
+                                else
                                 {
-                                    // WIP // Do we want to handle this on the framework side ?
+                                    dxl_write_word(id, s->gaddr(REG_GOAL_SPEED), 0, ack);
+                                    s->setError(dxl_get_rxpacket_error());
+                                    updateErrorCount(dxl_get_com_error_count());
+                                    dxl_print_error();
                                 }
+
+                                dxl_write_word(id, s->gaddr(REG_GOAL_POSITION), s->getGoalPosition(), ack);
+                                s->setError(dxl_get_rxpacket_error());
+                                updateErrorCount(dxl_get_com_error_count());
+                                dxl_print_error();
+
+                                TRACE_2(DXL, "[STOP] pos: '%i' speed: '%i'   |   (> %i) (angle: %i)",
+                                        cpos, speed, gpos, angle);
+                                s->commitValue(REG_GOAL_POSITION, 0);
                             }
                         }
                     }
+                    else if (s->getSpeedMode() == SPEED_MANUAL)
+                    {
+                        if (s->getCwAngleLimit() == 0 || s->getCcwAngleLimit() == 0) // WHEEL MODE
+                        {
+                            // WIP // Do we want to handle this on the framework side ?
+                        }
+                    }
                 }
-
-                servoListLock.lock();
             }
         }
 
-        // Make sure we unlock servoList
-        servoListLock.unlock();
+        // Feedback of this cycle has landed, wake up the subscribers
+        publishCycle();
 
         // Loop control
         syncloopCounter++;
-        syncloopCounter %= syncloopFrequency;
 
         // Loop timer
-        end = std::chrono::system_clock::now();
-        double loopd = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-        double waitd = (syncloopDuration * 1000.0) - loopd;
-
-#ifdef LATENCY_TIMER
-        if ((loopd / 1000.0) > syncloopDuration)
-        {
-            TRACE_WARNING(DXL, "Sync loop duration: %fms of the %fms budget.", (loopd / 1000.0), syncloopDuration);
-        }
-        else
-        {
-            TRACE_INFO(DXL, "Sync loop duration: %fms of the %fms budget.", (loopd / 1000.0), syncloopDuration);
-        }
-#endif
-
-        if (waitd > 0.0)
-        {
-            std::chrono::microseconds waittime(static_cast<int>(waitd));
-            std::this_thread::sleep_for(waittime);
-        }
+        endSyncLoop();
     }
 
     TRACE_INFO(DXL, ">> THREAD (tid: '%i') termination by 'loop exit'", std::this_thread::get_id());
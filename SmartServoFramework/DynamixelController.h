@@ -52,6 +52,79 @@ class DynamixelController: public Dynamixel, public ServoController
     //! Compute some internal settings (ackPolicy, maxId, protocolVersion) depending on current servo serie and serial device.
     void updateInternalSettings();
 
+    //! Position at every loop, speed/load/moving at a quarter of the loop frequency, voltage/temperature at 1 Hz.
+    void setDefaultPollingRates();
+
+    /*!
+     * \brief Feedback registers of one servo, due during the current synchronization cycle.
+     */
+    struct FeedbackRead
+    {
+        ServoDynamixel *servo = nullptr;
+        int registers[64];              //!< Register names.
+        int addresses[64];              //!< Register addresses.
+        int sizes[64];                  //!< Register sizes, in bytes.
+        int priorities[64];             //!< Register priorities, using ::TransactionPriority_e.
+        int registerCount = 0;
+    };
+
+    /*!
+     * \brief Register blocks to commit at the same address, with the same size.
+     */
+    struct CommitGroup
+    {
+        int address = 0;
+        int size = 0;
+        size_t count = 0;                       //!< Writes in use (slots are reused between cycles).
+        std::vector <DynamixelWriteRequest> writes;
+        std::vector <ServoDynamixel *> servos;  //!< Servo of each write.
+    };
+
+    std::vector <ServoDynamixel *> syncServos;              //!< Servos synchronized during the current cycle.
+    std::vector <FeedbackRead> feedbackReads;               //!< Feedback registers due during the current cycle.
+    std::vector <DynamixelReadRequest> feedbackRequests;    //!< One register block per servo, covering its due feedback registers.
+
+    int feedbackGrouped = 0;                                //!< Requests read together, at the beginning of 'feedbackRequests'.
+    bool feedbackSameBlock = false;                         //!< True if the grouped requests all read the same register block.
+    int feedbackBytes = 0;                                  //!< Bytes planned for the feedback reads.
+    int feedbackTransactions = 0;                           //!< Transactions planned for the feedback reads.
+
+    /*!
+     * \brief Compute the 'feedbackRequests' for the 'feedbackReads' registers, and estimate their cost.
+     */
+    void planFeedback();
+
+    /*!
+     * \brief Defer the lower priority feedback registers to the next loop, until the feedback reads fit into the remaining loop budget.
+     */
+    void shedFeedback();
+
+    /*!
+     * \brief Read the 'feedbackReads' registers, and update the servos with their values.
+     *
+     * Every servo gets one register block read, and all the blocks are read with
+     * one sync read (same block for every servo, protocol v2) or one bulk read.
+     * Protocol v1 devices without bulk read support (all but MX) are read one by one.
+     */
+    void readFeedback();
+
+    std::vector <CommitGroup> commitGroups;                 //!< Register modifications queued during the current cycle.
+    size_t commitGroupCount = 0;                            //!< Groups in use in 'commitGroups' (slots are reused between cycles).
+
+    /*!
+     * \brief Queue a block of register bytes, to be written by writeCommits().
+     */
+    void queueCommit(ServoDynamixel *servo, const WriteBlock &block);
+
+    /*!
+     * \brief Write the queued register blocks.
+     *
+     * Every group of register blocks sharing an address and a size is written
+     * with one sync write. A block alone in its group is written with a regular
+     * write instead, so its status packet is still checked.
+     */
+    void writeCommits();
+
     //! Read/write synchronization loop, running inside its own background thread
     void run();
 
@@ -59,7 +132,7 @@ public:
     /*!
      * \brief DynamixelController constructor.
      * \param servoSerie: The servo serie to use with this controller. Only used to choose the right communication protocol.
-     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;120], default is 30.
+     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;1000], default is 30.
      */
     DynamixelController(int servoSerie = SERVO_MX, int ctrlFrequency = 30);
 
@@ -111,6 +184,13 @@ public:
     std::string serialGetCurrentDevice_wrapper();
     std::vector <std::string> serialGetAvailableDevices_wrapper();
     void serialSetLatency_wrapper(int latency);
+    SerialPortStats serialGetStats_wrapper();
+    void serialResetStats_wrapper();
+    LatencyStats getInstructionLatency_wrapper(const int instruction);
+    LatencyStats getServoLatency_wrapper(const int id);
+    void resetLatency_wrapper();
+    bool serialCaptureStart_wrapper(const std::string &path);
+    void serialCaptureStop_wrapper();
 };
 
 /** @}*/
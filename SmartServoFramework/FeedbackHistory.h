@@ -0,0 +1,169 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file FeedbackHistory.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef FEEDBACK_HISTORY_H
+#define FEEDBACK_HISTORY_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+//! Maximum number of registers recorded into a feedback history.
+#define FEEDBACK_HISTORY_MAX_REGISTERS  4
+
+/*!
+ * \brief One sample of a feedback history.
+ */
+struct FeedbackSample
+{
+    uint64_t cycle;                     //!< Synchronization cycle this sample comes from.
+    std::chrono::steady_clock::time_point time; //!< Time at which the feedback of this cycle was complete.
+    int values[FEEDBACK_HISTORY_MAX_REGISTERS]; //!< Register values, in the order given to the history.
+    unsigned updated;                   //!< Bitmask of the values read from the device during this cycle, the others are the last known ones.
+};
+
+/*!
+ * \brief Fixed capacity ring buffer of timestamped register samples.
+ *
+ * Only one thread (the controller's) may push() samples, while any number of
+ * threads read() them back, without locking: every slot carries the index of
+ * the sample it holds, so a reader can tell when a slot has been overwritten
+ * while it was copying it, and drop it. Storage is allocated once.
+ */
+class FeedbackHistory
+{
+    struct Slot
+    {
+        std::atomic <uint64_t> index;   //!< Index of the sample + 1, or 0 while being written.
+        std::atomic <uint64_t> cycle;
+        std::atomic <int64_t> time;
+        std::atomic <int> values[FEEDBACK_HISTORY_MAX_REGISTERS];
+        std::atomic <unsigned> updated;
+    };
+
+    std::vector <int> registers;        //!< Registers recorded.
+    size_t capacity;                    //!< Number of samples kept.
+    std::unique_ptr <Slot[]> slots;
+    std::atomic <uint64_t> written;     //!< Number of samples pushed since the creation of the history.
+
+public:
+    FeedbackHistory(const std::vector <int> &regs, const size_t size):
+        registers(regs), capacity(size > 0 ? size : 1), slots(new Slot[capacity]()), written(0)
+    {
+        if (registers.size() > FEEDBACK_HISTORY_MAX_REGISTERS)
+        {
+            registers.resize(FEEDBACK_HISTORY_MAX_REGISTERS);
+        }
+    }
+
+    //! Registers recorded, in the order of FeedbackSample::values.
+    const std::vector <int> &getRegisters() const { return registers; }
+
+    //! Maximum number of samples kept.
+    size_t getCapacity() const { return capacity; }
+
+    //! Number of samples pushed since the creation of the history (older ones are lost).
+    uint64_t getSampleCount() const { return written.load(std::memory_order_acquire); }
+
+    /*!
+     * \brief Add a sample, overwriting the oldest one if the history is full. Must only be called by one thread.
+     * \param cycle: Synchronization cycle of the sample.
+     * \param time: Time of the sample.
+     * \param values: One value per register recorded.
+     * \param updated: Bitmask of the values read from the device during this cycle.
+     */
+    void push(const uint64_t cycle, const std::chrono::steady_clock::time_point time, const int *values, const unsigned updated)
+    {
+        uint64_t i = written.load(std::memory_order_relaxed);
+        Slot &slot = slots[i % capacity];
+
+        slot.index.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.cycle.store(cycle, std::memory_order_relaxed);
+        slot.time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+        for (size_t r = 0; r < registers.size(); r++)
+        {
+            slot.values[r].store(values[r], std::memory_order_relaxed);
+        }
+        slot.updated.store(updated, std::memory_order_relaxed);
+
+        slot.index.store(i + 1, std::memory_order_release);
+        written.store(i + 1, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Copy the most recent samples. Can be called from any thread.
+     * \param samples: Where to copy the samples, oldest first.
+     * \param count: Maximum number of samples to copy.
+     * \return The number of samples copied.
+     *
+     * Samples overwritten during the copy are dropped, so less than 'count'
+     * samples may be returned even if the history is full.
+     */
+    size_t read(FeedbackSample *samples, const size_t count) const
+    {
+        uint64_t end = written.load(std::memory_order_acquire);
+        uint64_t n = end;
+        if (n > capacity) n = capacity;
+        if (n > count) n = count;
+
+        size_t copied = 0;
+        for (uint64_t i = end - n; i < end; i++)
+        {
+            const Slot &slot = slots[i % capacity];
+            FeedbackSample &s = samples[copied];
+
+            if (slot.index.load(std::memory_order_acquire) != i + 1)
+            {
+                continue;
+            }
+
+            s.cycle = slot.cycle.load(std::memory_order_relaxed);
+            s.time = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(slot.time.load(std::memory_order_relaxed)));
+            for (size_t r = 0; r < registers.size(); r++)
+            {
+                s.values[r] = slot.values[r].load(std::memory_order_relaxed);
+            }
+            s.updated = slot.updated.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.index.load(std::memory_order_relaxed) == i + 1)
+            {
+                copied++;
+            }
+        }
+
+        return copied;
+    }
+};
+
+/** @}*/
+
+#endif // FEEDBACK_HISTORY_H
@@ -33,9 +33,6 @@
 
 /* ************************************************************************** */
 
-// Enable latency timer
-//#define LATENCY_TIMER
-
 // Enable packet debugger
 //#define PACKET_DEBUGGER
 
@@ -80,6 +77,29 @@ enum {
     PKT_DATA        = 7,            //!< Note: parameter field as an address of 9 (and not 8) when found in status packet.
 };
 
+/*!
+ * \brief Sort a HerkuleX command into a ::LatencyInstructions_e transaction type.
+ */
+static int hkx_latency_instruction(const int cmd)
+{
+    switch (cmd)
+    {
+    case CMD_STAT:
+        return LATENCY_PING;
+    case CMD_EEP_READ:
+    case CMD_RAM_READ:
+        return LATENCY_READ;
+    case CMD_EEP_WRITE:
+    case CMD_RAM_WRITE:
+    case CMD_I_JOG:
+        return LATENCY_WRITE;
+    case CMD_S_JOG:
+        return LATENCY_SYNC_WRITE;
+    default:
+        return LATENCY_OTHER;
+    }
+}
+
 /* ************************************************************************** */
 
 HerkuleX::HerkuleX()
@@ -101,20 +121,34 @@ int HerkuleX::serialOpen(std::string &devicePath, const int baud)
         serialTerminate();
     }
 
-    // Instanciate a different serial subclass, depending on the current OS
+    // Instanciate a different serial subclass, depending on the device path and the current OS
+    if (isReplayDevicePath(devicePath))
+    {
+        m_serial = new SerialPortReplay(devicePath, baud, m_serialDevice, m_servoSerie);
+    }
+    else
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+    if (isNetworkDevicePath(devicePath))
+    {
+        m_serial = new SerialPortNet(devicePath, baud, m_serialDevice, m_servoSerie);
+    }
+    else
+#endif
+    {
 #if defined(FEATURE_QTSERIAL)
-    m_serial = new SerialPortQt(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortQt(devicePath, baud, m_serialDevice, m_servoSerie);
 #else
 #if defined(_WIN32) || defined(_WIN64)
-    m_serial = new SerialPortWindows(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortWindows(devicePath, baud, m_serialDevice, m_servoSerie);
 #elif defined(__APPLE__) || defined(__MACH__)
-    m_serial = new SerialPortMacOS(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortMacOS(devicePath, baud, m_serialDevice, m_servoSerie);
 #elif defined(__linux__) || defined(__unix__)
-    m_serial = new SerialPortLinux(devicePath, baud, m_serialDevice, m_servoSerie);
+        m_serial = new SerialPortLinux(devicePath, baud, m_serialDevice, m_servoSerie);
 #else
-    #error "No serial port implementation available..."
+        #error "No serial port implementation available..."
 #endif
 #endif
+    }
 
     // Initialize the serial link
     if (m_serial != nullptr)
@@ -193,6 +227,62 @@ void HerkuleX::serialSetLatency(int latency)
         m_serial->setLatency(latency);
 }
 
+SerialPortStats HerkuleX::serialGetStats()
+{
+    if (m_serial)
+        return m_serial->getStats();
+
+    return SerialPortStats();
+}
+
+void HerkuleX::serialResetStats()
+{
+    if (m_serial)
+        m_serial->resetStats();
+}
+
+double HerkuleX::serialGetByteTime()
+{
+    if (m_serial)
+        return m_serial->getByteTime();
+
+    return 0.0;
+}
+
+LatencyStats HerkuleX::getInstructionLatency(const int instruction)
+{
+    return m_latency.getInstructionStats(instruction);
+}
+
+LatencyStats HerkuleX::getServoLatency(const int id)
+{
+    return m_latency.getServoStats(id);
+}
+
+void HerkuleX::resetLatency()
+{
+    m_latency.reset();
+}
+
+bool HerkuleX::serialCaptureStart(const std::string &path)
+{
+    int baudrate = 0;
+    if (m_serial)
+        baudrate = m_serial->getDeviceBaudRate();
+
+    return m_capture.start(path, m_protocolVersion, baudrate);
+}
+
+void HerkuleX::serialCaptureStop()
+{
+    m_capture.stop();
+}
+
+bool HerkuleX::serialCaptureRunning()
+{
+    return m_capture.isRunning();
+}
+
 void HerkuleX::setAckPolicy(int ack)
 {
     if (m_ackPolicy >= ACK_NO_REPLY && ack <= ACK_REPLY_ALL)
@@ -242,6 +332,7 @@ void HerkuleX::hkx_tx_packet()
     // Send packet
     if (m_serial != nullptr)
     {
+        m_txTime = std::chrono::steady_clock::now();
         txPacketSizeSent = m_serial->tx(txPacket, txPacketSize);
     }
     else
@@ -253,6 +344,7 @@ void HerkuleX::hkx_tx_packet()
     // Check if we send the whole packet
     if (txPacketSize != txPacketSizeSent)
     {
+        m_serial->statsTransmit(-1);
         m_commStatus = COMM_TXFAIL;
         m_commLock = 0;
         return;
@@ -269,6 +361,8 @@ void HerkuleX::hkx_tx_packet()
         m_serial->setTimeOut(9);
     }
 
+    m_serial->statsTransmit(txPacketSizeSent);
+    m_capture.capture(CAPTURE_DIRECTION_TX, txPacket, txPacketSizeSent);
     m_commStatus = COMM_TXSUCCESS;
 }
 
@@ -289,6 +383,8 @@ void HerkuleX::hkx_rx_packet()
     // Packet sent to a broadcast address? No need to wait for a status packet.
     if (txPacket[PKT_ID] == BROADCAST_ID)
     {
+        m_serial->txNoReply();
+        m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
         m_commStatus = COMM_RXSUCCESS;
         m_commLock = 0;
         return;
@@ -307,6 +403,7 @@ void HerkuleX::hkx_rx_packet()
     if (m_serial != nullptr)
     {
         nRead = m_serial->rx((unsigned char*)&rxPacket[rxPacketSizeReceived], rxPacketSize - rxPacketSizeReceived);
+        m_capture.capture(CAPTURE_DIRECTION_RX, &rxPacket[rxPacketSizeReceived], nRead);
         rxPacketSizeReceived += nRead;
 
         // Check if we received the whole packet
@@ -316,10 +413,12 @@ void HerkuleX::hkx_rx_packet()
             {
                 if (rxPacketSizeReceived == 0)
                 {
+                    m_serial->statsComplete(0, TRANSACTION_TIMEOUT);
                     m_commStatus = COMM_RXTIMEOUT;
                 }
                 else
                 {
+                    m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_PARTIAL);
                     m_commStatus = COMM_RXCORRUPT;
                 }
 
@@ -370,6 +469,7 @@ void HerkuleX::hkx_rx_packet()
     // Check ID pairing
     if (txPacket[PKT_ID] != rxPacket[PKT_ID])
     {
+        m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_BAD_ID);
         m_commStatus = COMM_RXCORRUPT;
         m_commLock = 0;
         return;
@@ -381,6 +481,7 @@ void HerkuleX::hkx_rx_packet()
     if (rxPacketSizeReceived < rxPacketSize)
     {
         nRead = m_serial->rx(&rxPacket[rxPacketSizeReceived], rxPacketSize - rxPacketSizeReceived);
+        m_capture.capture(CAPTURE_DIRECTION_RX, &rxPacket[rxPacketSizeReceived], nRead);
         rxPacketSizeReceived += nRead;
 
         if (rxPacketSizeReceived < rxPacketSize)
@@ -398,24 +499,26 @@ void HerkuleX::hkx_rx_packet()
         if (rxPacket[PKT_CHECKSUM1] != get_lowbyte(checksum) &&
             rxPacket[PKT_CHECKSUM2] != get_highbyte(checksum))
         {
+            m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_BAD_CHECKSUM);
             m_commStatus = COMM_RXCORRUPT;
             m_commLock = 0;
             return;
         }
     }
 
+    m_serial->statsComplete(rxPacketSizeReceived, TRANSACTION_REPLY);
+
+    // Transaction latency
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_txTime).count();
+        m_latency.record(hkx_latency_instruction(txPacket[PKT_CMD]), txPacket[PKT_ID], static_cast<uint32_t>(us));
+    }
     m_commStatus = COMM_RXSUCCESS;
     m_commLock = 0;
 }
 
 void HerkuleX::hkx_txrx_packet(int ack)
 {
-#ifdef LATENCY_TIMER
-    // Latency timer for a complete transaction (instruction sent and status received)
-    std::chrono::time_point<std::chrono::high_resolution_clock> start, end;
-    start = std::chrono::high_resolution_clock::now();
-#endif
-
     hkx_tx_packet();
 
     if (m_commStatus != COMM_TXSUCCESS)
@@ -444,12 +547,16 @@ void HerkuleX::hkx_txrx_packet(int ack)
         }
         else
         {
+            m_serial->txNoReply();
+            m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
             m_commStatus = COMM_RXSUCCESS;
             m_commLock = 0;
         }
     }
     else
     {
+        m_serial->txNoReply();
+        m_serial->statsComplete(0, TRANSACTION_NO_REPLY);
         m_commStatus = COMM_RXSUCCESS;
         m_commLock = 0;
     }
@@ -458,12 +565,6 @@ void HerkuleX::hkx_txrx_packet(int ack)
     printTxPacket();
     printRxPacket();
 #endif
-
-#ifdef LATENCY_TIMER
-    end = std::chrono::high_resolution_clock::now();
-    int loopd = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-    TRACE_1(HKX, "TX > RX loop: %iµs", loopd);
-#endif
 }
 
 // Low level API
@@ -986,6 +1087,30 @@ void HerkuleX::hkx_write_word(const int id, const int address, const int value,
     hkx_txrx_packet(ack);
 }
 
+void HerkuleX::hkx_write(const int id, const int address, const unsigned char *data, const int length, const int register_type, const int ack)
+{
+    if (data == nullptr || length <= 0 || length > MAX_PACKET_LENGTH_hkx - 9)
+    {
+        TRACE_ERROR(HKX, "Cannot send 'Write' instruction for %i bytes!", length);
+        return;
+    }
+
+    while(m_commLock);
+
+    txPacket[PKT_LENGTH] = get_lowbyte(7 + 2 + length);
+    txPacket[PKT_ID] = get_lowbyte(id);
+    if (register_type == REGISTER_RAM)
+        txPacket[PKT_CMD] = CMD_RAM_WRITE;
+    else
+        txPacket[PKT_CMD] = CMD_EEP_WRITE;
+
+    txPacket[PKT_DATA] = get_lowbyte(address);
+    txPacket[PKT_DATA+1] = get_lowbyte(length);
+    std::memcpy(&txPacket[PKT_DATA+2], data, length);
+
+    hkx_txrx_packet(ack);
+}
+
 void HerkuleX::hkx_i_jog(const int id, const int mode, const int value, const int ack)
 {
     int JOG = 0;
@@ -27,13 +27,18 @@
 #include "SerialPortLinux.h"
 #include "SerialPortWindows.h"
 #include "SerialPortMacOS.h"
+#include "SerialPortNet.h"
+#include "SerialPortReplay.h"
 
 #include "ServoTools.h"
 #include "HerkuleXTools.h"
 #include "ControlTables.h"
+#include "LatencyHistogram.h"
+#include "PacketCapture.h"
 
 #include <string>
 #include <vector>
+#include <chrono>
 
 /*!
  * \brief The HerkuleX communication protocol implementation
@@ -69,6 +74,10 @@ private:
     int m_commLock = 0;
     int m_commStatus = COMM_RXSUCCESS;      //!< Last communication status
 
+    std::chrono::steady_clock::time_point m_txTime;     //!< When the last instruction packet has been sent
+    LatencyMonitor m_latency;               //!< Transaction latency histograms
+    PacketCapture m_capture;                //!< Binary capture of the serial traffic
+
     // Serial communication methods, using one of the SerialPort[Linux/Mac/Windows] implementations.
     void hkx_tx_packet();
     void hkx_rx_packet();
@@ -151,6 +160,7 @@ protected:
     void hkx_write_byte(const int id, const int address, const int value, const int register_type, const int ack = ACK_DEFAULT);
     int hkx_read_word(const int id, const int address, const int register_type, const int ack = ACK_DEFAULT);
     void hkx_write_word(const int id, const int address, const int value, const int register_type, const int ack = ACK_DEFAULT);
+    void hkx_write(const int id, const int address, const unsigned char *data, const int length, const int register_type, const int ack = ACK_DEFAULT);
     void hkx_i_jog(const int id, const int mode, const int value, const int ack = ACK_DEFAULT);
     void hkx_s_jog(const int id, const int mode, const int value, const int ack = ACK_DEFAULT);
 
@@ -173,6 +183,61 @@ public:
      */
     void serialSetLatency(int latency);
 
+    /*!
+     * \brief Get the bus utilization of the serial port associated with this HerkuleX instance.
+     * \return A snapshot of the serial port counters, or an empty one if no serial port is open.
+     */
+    SerialPortStats serialGetStats();
+
+    /*!
+     * \brief Reset the bus utilization counters of the serial port.
+     */
+    void serialResetStats();
+
+    /*!
+     * \brief Get the estimated time needed to read/write one byte on the serial port.
+     * \return The time per byte in milliseconds, or 0 if no serial port is open.
+     */
+    double serialGetByteTime();
+
+    /*!
+     * \brief Get the latency histogram summary of a transaction type, between the instruction packet and the end of its status packet.
+     * \param instruction: Transaction type (using ::LatencyInstructions_e).
+     * \return The latency summary, in microseconds.
+     */
+    LatencyStats getInstructionLatency(const int instruction);
+
+    /*!
+     * \brief Get the latency histogram summary of the transactions answered by a device.
+     * \param id: Device ID.
+     * \return The latency summary, in microseconds.
+     */
+    LatencyStats getServoLatency(const int id);
+
+    /*!
+     * \brief Clear the latency histograms.
+     */
+    void resetLatency();
+
+    /*!
+     * \brief Start recording every instruction and status packet exchanged on the serial port into a binary capture file.
+     * \param path: Path of the capture file.
+     * \return True if the capture has started.
+     *
+     * Captures can be replayed later by opening a "replay://<path>" device.
+     */
+    bool serialCaptureStart(const std::string &path);
+
+    /*!
+     * \brief Stop the capture and close the capture file.
+     */
+    void serialCaptureStop();
+
+    /*!
+     * \brief Check if the serial traffic is being captured.
+     */
+    bool serialCaptureRunning();
+
     /*!
      * \brief setAckPolicy
      * \param ack: Ack policy value, using '::AckPolicy_e' enum.
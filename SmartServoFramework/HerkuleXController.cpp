@@ -28,13 +28,11 @@
 #include <thread>
 #include <mutex>
 
-// Enable latency timer
-//#define LATENCY_TIMER
-
 HerkuleXController::HerkuleXController(int servoSerie, int ctrlFrequency):
     ServoController(ctrlFrequency)
 {
     m_servoSerie = servoSerie;
+    setDefaultPollingRates();
 }
 
 HerkuleXController::~HerkuleXController()
@@ -42,6 +40,18 @@ HerkuleXController::~HerkuleXController()
     disconnect();
 }
 
+void HerkuleXController::setDefaultPollingRates()
+{
+    // "full speed" update loop (every loop, even if the adaptive frequency raises it)
+    setPollingRate({REG_ABSOLUTE_POSITION, REG_ABSOLUTE_GOAL_POSITION}, SYNCLOOP_MAX_FREQUENCY);
+
+    // x/4 Hz "feedback" update loop (differential position and PWM stand for the speed and load)
+    setPollingRate({REG_DIFFERENTIAL_POSITION, REG_PWM, REG_STATUS_ERROR, REG_STATUS_DETAIL}, syncloopFrequency / 4.0);
+
+    // 1 Hz "low priority" update loop
+    setPollingRate({REG_CURRENT_VOLTAGE, REG_CURRENT_TEMPERATURE}, 1.0);
+}
+
 void HerkuleXController::updateInternalSettings()
 {
     if (m_servoSerie != SERVO_UNKNOWN)
@@ -139,6 +149,64 @@ void HerkuleXController::serialSetLatency_wrapper(int latency)
     serialSetLatency(latency);
 }
 
+SerialPortStats HerkuleXController::serialGetStats_wrapper()
+{
+    return serialGetStats();
+}
+
+void HerkuleXController::serialResetStats_wrapper()
+{
+    serialResetStats();
+}
+
+LatencyStats HerkuleXController::getInstructionLatency_wrapper(const int instruction)
+{
+    return getInstructionLatency(instruction);
+}
+
+LatencyStats HerkuleXController::getServoLatency_wrapper(const int id)
+{
+    return getServoLatency(id);
+}
+
+void HerkuleXController::resetLatency_wrapper()
+{
+    resetLatency();
+    syncloopHistogram.reset();
+}
+
+bool HerkuleXController::serialCaptureStart_wrapper(const std::string &path)
+{
+    // The controller's thread captures the frames, so it must (re)start the capture itself
+    if (getState() >= state_started)
+    {
+        {
+            std::lock_guard <std::mutex> lock(capturePathLock);
+            capturePath = path;
+        }
+
+        miniMessages m {ctrl_capture_start, std::chrono::steady_clock::time_point(), nullptr, 0, 0, 0};
+        sendMessageAndWait(&m);
+
+        return serialCaptureRunning();
+    }
+
+    return serialCaptureStart(path);
+}
+
+void HerkuleXController::serialCaptureStop_wrapper()
+{
+    if (getState() >= state_started)
+    {
+        miniMessages m {ctrl_capture_stop, std::chrono::steady_clock::time_point(), nullptr, 0, 0, 0};
+        sendMessageAndWait(&m);
+    }
+    else
+    {
+        serialCaptureStop();
+    }
+}
+
 void HerkuleXController::autodetect_internal(int start, int stop, int bail)
 {
     setState(state_scanning);
@@ -199,12 +267,8 @@ void HerkuleXController::autodetect_internal(int start, int stop, int bail)
             {
                 servoListLock.lock();
 
-                // Add the servo to the controller
-                servoList.push_back(servo);
-
-                // Mark it for an "initial read" and synchronization
-                updateList.push_back(servo->getId());
-                syncList.push_back(servo->getId());
+                // Add the servo to the controller, and mark it for an "initial read" and synchronization
+                addServo_internal(servo);
 
                 servoListLock.unlock();
 
@@ -235,24 +299,19 @@ void HerkuleXController::run()
     TRACE_INFO(MAPI, "HerkuleXController::run(port: '%s' / tid: '%i')",
                serialGetCurrentDevice().c_str(), std::this_thread::get_id());
 
-    std::chrono::time_point<std::chrono::system_clock> start, end;
-
     while (getState() >= state_started)
     {
         // Loop timer
-        start = std::chrono::system_clock::now();
+        beginSyncLoop();
+        syncloopByteTime = serialGetByteTime() * 1000.0;
 
         // MESSAGE PARSING
         ////////////////////////////////////////////////////////////////////////
 
-        unsigned ignoreMsg = 0;
+        miniMessages m;
 
-        m_mutex.lock();
-        while (m_queue.empty() == false && m_queue.size() != ignoreMsg)
+        while (receiveMessage(m) || receiveDelayedMessage(m))
         {
-            miniMessages m = m_queue.front();
-            m_mutex.unlock();
-
             switch (m.msg)
             {
             case ctrl_device_autodetect:
@@ -271,25 +330,25 @@ void HerkuleXController::run()
                 break;
 
             case ctrl_device_delayed_add:
-                if (delayedAddServos_internal(m.delay, m.p1, m.p2) == 1)
-                {
-                    ignoreMsg++;
-                    sendMessage(&m);
-                }
+                delayedAddServos_internal(m.p1, m.p2);
+                break;
+
+            case ctrl_capture_start:
+            {
+                std::lock_guard <std::mutex> lock(capturePathLock);
+                serialCaptureStart(capturePath);
+                break;
+            }
+            case ctrl_capture_stop:
+                serialCaptureStop();
                 break;
 
             case ctrl_state_pause:
                 TRACE_INFO(MAPI, ">> THREAD (tid: '%i') paused by message", std::this_thread::get_id());
-                m_mutex.lock();
-                m_queue.pop_front();
-                m_mutex.unlock();
                 return;
                 break;
             case ctrl_state_stop:
                 TRACE_INFO(MAPI, ">> THREAD (tid: '%i') termination by 'stop message'", std::this_thread::get_id());
-                m_mutex.lock();
-                m_queue.pop_front();
-                m_mutex.unlock();
                 return;
                 break;
 
@@ -297,17 +356,16 @@ void HerkuleXController::run()
                 TRACE_WARNING(HKX, "Unknown message type: '%i'", m.msg);
                 break;
             }
-
-            m_mutex.lock();
-            m_queue.pop_front();
         }
-        m_mutex.unlock();
 
         // ACTION LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        servoListLock.lock();
-        for (auto s: servoList)
+        // Devices registered at the beginning of this cycle; registrations happening
+        // during this cycle (ex: from a user thread) will be visible at the next one
+        std::shared_ptr <const ServoSnapshot> servos = getServoSnapshot();
+
+        for (auto s: servos->servos)
         {
             int id = s->getId();
             int ack = s->getStatusReturnLevel();
@@ -325,61 +383,33 @@ void HerkuleXController::run()
             if (rebootProgrammed == 1)
             {
                 // Remove servo from sync/update lists; Need to be added again after reboot!
-                for (std::vector <int>::iterator it = updateList.begin(); it != updateList.end();)
-                {
-                    if (*it == id)
-                    { updateList.erase(it); }
-                    else
-                    { ++it; }
-                }
-                for (std::vector <int>::iterator it = syncList.begin(); it != syncList.end();)
-                {
-                    if (*it == id)
-                    { syncList.erase(it); }
-                    else
-                    { ++it; }
-                }
+                unsyncServo_internal(id);
 
                 // Reboot
                 hkx_reboot(id, ack);
                 TRACE_INFO(HKX, "Rebooting servo #%i...", id);
 
-                miniMessages m {ctrl_device_delayed_add, std::chrono::system_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
-                sendMessage(&m);
+                miniMessages m {ctrl_device_delayed_add, std::chrono::steady_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
+                delayMessage(m);
             }
 
             if (resetProgrammed > 0)
             {
                 // Remove servo from sync/update lists; Need to be added again after reset!
-                for (std::vector <int>::iterator it = updateList.begin(); it != updateList.end();)
-                {
-                    if (*it == id)
-                    { updateList.erase(it); }
-                    else
-                    { ++it; }
-                }
-                for (std::vector <int>::iterator it = syncList.begin(); it != syncList.end();)
-                {
-                    if (*it == id)
-                    { syncList.erase(it); }
-                    else
-                    { ++it; }
-                }
+                unsyncServo_internal(id);
 
                 // Reset
                 hkx_reset(id, resetProgrammed, ack);
                 TRACE_INFO(HKX, "Resetting servo #%i (setting: %i)...", id, resetProgrammed);
 
-                miniMessages m {ctrl_device_delayed_add, std::chrono::system_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
-                sendMessage(&m);
+                miniMessages m {ctrl_device_delayed_add, std::chrono::steady_clock::now() + std::chrono::seconds(2), nullptr, id, 1, 0};
+                delayMessage(m);
             }
         }
-        servoListLock.unlock();
 
         // INITIAL READ LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        servoListLock.lock();
         if (updateList.empty() == false)
         {
             std::vector <int>::iterator itr;
@@ -387,288 +417,269 @@ void HerkuleXController::run()
             {
                 setState(state_reading);
 
-                for (auto s: servoList)
+                Servo *s = servos->find(*itr);
+                if (s != nullptr)
                 {
-                    if (s->getId() == (*itr))
-                    {
-                        int id = s->getId();
-                        int ack = s->getStatusReturnLevel();
+                    int id = s->getId();
+                    int ack = s->getStatusReturnLevel();
 
-                        for (int ctid = 1; ctid < s->getRegisterCount(); ctid++)
-                        {
-                            struct RegisterInfos reg;
-                            int reg_name = getRegisterName(s->getControlTable(), ctid);
-                            getRegisterInfos(s->getControlTable(), reg_name, reg);
+                    for (int ctid = 1; ctid < s->getRegisterCount(); ctid++)
+                    {
+                        struct RegisterInfos reg;
+                        int reg_name = getRegisterName(s->getControlTable(), ctid);
+                        getRegisterInfos(s->getControlTable(), reg_name, reg);
 
-                            TRACE_1(HKX, "Reading value for reg [%i] name: '%s' addr: '%i' size: '%i'", ctid, getRegisterNameTxt(reg_name).c_str(), reg.reg_addr, reg.reg_size);
+                        TRACE_1(HKX, "Reading value for reg [%i] name: '%s' addr: '%i' size: '%i'", ctid, getRegisterNameTxt(reg_name).c_str(), reg.reg_addr, reg.reg_size);
 
-                            int reg_type = REGISTER_AUTO;
-                            if (reg.reg_addr_rom >= 0 && reg.reg_addr_ram >= 0)
-                                reg_type = REGISTER_BOTH;
-                            else if (reg.reg_addr_rom >= 0)
-                                reg_type = REGISTER_ROM;
-                            else if (reg.reg_addr_ram >= 0)
-                                reg_type = REGISTER_RAM;
+                        int reg_type = REGISTER_AUTO;
+                        if (reg.reg_addr_rom >= 0 && reg.reg_addr_ram >= 0)
+                            reg_type = REGISTER_BOTH;
+                        else if (reg.reg_addr_rom >= 0)
+                            reg_type = REGISTER_ROM;
+                        else if (reg.reg_addr_ram >= 0)
+                            reg_type = REGISTER_RAM;
 
-                            if (reg.reg_size == 1)
+                        if (reg.reg_size == 1)
+                        {
+                            if (reg_type == REGISTER_BOTH)
                             {
-                                if (reg_type == REGISTER_BOTH)
-                                {
-                                    s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
-                                    s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
-                                }
-                                else if (reg_type == REGISTER_ROM)
-                                {
-                                    s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
-                                }
-                                else if (reg_type == REGISTER_RAM)
-                                {
-                                    s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
-                                }
+                                s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
+                                s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
                             }
-                            else //if (reg.reg_size == 2)
+                            else if (reg_type == REGISTER_ROM)
                             {
-                                if (reg_type == REGISTER_BOTH)
-                                {
-                                    s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
-                                    s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
-                                }
-                                else if (reg_type == REGISTER_ROM)
-                                {
-                                    s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
-                                }
-                                else if (reg_type == REGISTER_RAM)
-                                {
-                                    s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
-                                }
+                                s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
+                            }
+                            else if (reg_type == REGISTER_RAM)
+                            {
+                                s->updateValue(reg_name, hkx_read_byte(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
+                            }
+                        }
+                        else //if (reg.reg_size == 2)
+                        {
+                            if (reg_type == REGISTER_BOTH)
+                            {
+                                s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
+                                s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
+                            }
+                            else if (reg_type == REGISTER_ROM)
+                            {
+                                s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_rom, REGISTER_ROM, ack), REGISTER_ROM);
+                            }
+                            else if (reg_type == REGISTER_RAM)
+                            {
+                                s->updateValue(reg_name, hkx_read_word(id, reg.reg_addr_ram, REGISTER_RAM, ack), REGISTER_RAM);
                             }
-
-                            s->setError(hkx_get_rxpacket_error());
-                            s->setStatus(hkx_get_rxpacket_status_detail());
-                            updateErrorCount(hkx_get_com_error_count());
-                            hkx_print_error();
                         }
 
-                        // Once all registers are read, remove the servo from the "updateList"
-                        itr = updateList.erase(itr);
+                        s->setError(hkx_get_rxpacket_error());
+                        s->setStatus(hkx_get_rxpacket_status_detail());
+                        updateErrorCount(hkx_get_com_error_count());
+                        hkx_print_error();
                     }
                 }
+
+                // Once all registers are read, remove the servo from the "updateList"
+                itr = updateList.erase(itr);
             }
+
             setState(state_ready);
         }
-        servoListLock.unlock();
 
         // SYNCHRONIZATION LOOP
         ////////////////////////////////////////////////////////////////////////
 
-        int cumulid = 0;
+        updatePollingSchedule();
+        updateTrajectories(*servos);
 
-        servoListLock.lock();
+        // Servos to synchronize during this cycle, in the 'syncList' order
+        syncServos.clear();
         for (auto id: syncList)
         {
-            cumulid++;
-            cumulid %= syncloopFrequency;
+            Servo *s_raw = servos->find(id);
+            if (s_raw != nullptr)
+            {
+                syncServos.push_back(static_cast<ServoHerkuleX*>(s_raw));
+            }
+        }
+
+        for (auto s: syncServos)
+        {
+            int id = s->getId();
+            int ack = s->getStatusReturnLevel();
 
-            for (auto s_raw: servoList)
+            // Unregister device if it reach an error count too high
+            // Count must be high enough to avoid "false positive": device producing a lot of errors but still present on the serial link
+            if (s->getErrorCount() > 16)
             {
-                servoListLock.unlock();
+                TRACE_ERROR(HKX, "Device #%i has an error count too high and is going to be unregistered from its controller on '%s'...", id, serialGetCurrentDevice().c_str());
+                unregisterServo(s);
+                continue;
+            }
 
-                ServoHerkuleX *s = static_cast<ServoHerkuleX*>(s_raw);
+            // Commit register modifications, only visiting the registers marked by the setters
+            uint64_t commits = s->takeCommits(REGISTER_ROM);
+            while (commits)
+            {
+                int ctid = getFirstCommit(commits);
+                commits &= commits - 1;
+
+                int regname = getRegisterName(s->getControlTable(), ctid);
+                int regsize = getRegisterSize(s->getControlTable(), regname);
+                int regaddr = getRegisterAddr(s->getControlTable(), regname, REGISTER_ROM);
+
+                TRACE_1(HKX, "Writing ROM value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
+                        s->getValue(regname, REGISTER_ROM), ctid, getRegisterNameTxt(regname).c_str(), regaddr, regsize);
 
-                if (s->getId() == id)
+                if (regsize == 1)
                 {
-                    int ack = s->getStatusReturnLevel();
+                    hkx_write_byte(id, regaddr, s->getValue(regname, REGISTER_ROM), REGISTER_ROM, ack);
+                }
+                else //if (regsize == 2)
+                {
+                    hkx_write_word(id, regaddr, s->getValue(regname, REGISTER_ROM), REGISTER_ROM, ack);
+                }
+
+                s->setError(hkx_get_rxpacket_error());
+                s->setStatus(hkx_get_rxpacket_status_detail());
+                updateErrorCount(hkx_get_com_error_count());
+                hkx_print_error();
 
-                    // Unregister device if it reach an error count too high
-                    // Count must be high enough to avoid "false positive": device producing a lot of errors but still present on the serial link
-                    if (s->getErrorCount() > 16)
+                if (regname == REG_ID)
+                {
+                    if (s->changeInternalId(s->getValue(regname)) == 1)
                     {
-                        TRACE_ERROR(HKX, "Device #%i has an error count too high and is going to be unregistered from its controller on '%s'...", id, serialGetCurrentDevice().c_str());
-                        unregisterServo(s);
-                        continue;
+                        reindexServo(s, id);
+                        s->reboot();
                     }
+                }
+            }
 
-                    // Commit register modifications
-                    for (int ctid = 0; ctid < s->getRegisterCount(); ctid++)
-                    {
-                        int regname = getRegisterName(s->getControlTable(), ctid);
-                        int regsize = getRegisterSize(s->getControlTable(), regname);
+            // RAM registers modifications are merged into as few writes as possible
+            writePlanner.clear();
+            writePlanner.setGapTolerance(commitGapTolerance);
 
-                        if (s->getValueCommit(regname, REGISTER_ROM) == 1)
-                        {
-                            int regaddr = getRegisterAddr(s->getControlTable(), regname, REGISTER_ROM);
+            commits = s->takeCommits(REGISTER_RAM);
+            while (commits)
+            {
+                int ctid = getFirstCommit(commits);
+                commits &= commits - 1;
 
-                            TRACE_1(HKX, "Writing ROM value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
-                                    s->getValue(regname, REGISTER_ROM), ctid, getRegisterNameTxt(regname).c_str(), regaddr, regsize);
+                int regname = getRegisterName(s->getControlTable(), ctid);
+                int regsize = getRegisterSize(s->getControlTable(), regname);
+                int regaddr = getRegisterAddr(s->getControlTable(), regname, REGISTER_RAM);
 
-                            if (regsize == 1)
-                            {
-                                hkx_write_byte(id, regaddr, s->getValue(regname, REGISTER_ROM), REGISTER_ROM, ack);
-                            }
-                            else //if (regsize == 2)
-                            {
-                                hkx_write_word(id, regaddr, s->getValue(regname, REGISTER_ROM), REGISTER_ROM, ack);
-                            }
+                TRACE_1(HKX, "Queuing RAM value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
+                        s->getValue(regname, REGISTER_RAM), ctid, getRegisterNameTxt(regname).c_str(), regaddr, regsize);
 
-                            s->setError(hkx_get_rxpacket_error());
-                            s->setStatus(hkx_get_rxpacket_status_detail());
-                            s->commitValue(regname, 0, REGISTER_ROM);
-                            updateErrorCount(hkx_get_com_error_count());
-                            hkx_print_error();
+                // FIXME: probably doesn't work...
+                if (regname == REG_ID)
+                {
+                    hkx_write_byte(id, regaddr, s->getValue(regname, REGISTER_RAM), REGISTER_RAM, ack);
+                    s->setError(hkx_get_rxpacket_error());
+                    s->setStatus(hkx_get_rxpacket_status_detail());
+                    updateErrorCount(hkx_get_com_error_count());
+                    hkx_print_error();
+
+                    unregisterServo(s);
+                    if (s->changeInternalId(s->getValue(regname)) == 1)
+                    {
+                        registerServo(s);
+                    }
+                    continue;
+                }
 
-                            if (regname == REG_ID)
-                            {
-                                if (s->changeInternalId(s->getValue(regname)) == 1)
-                                {
-                                    s->reboot();
-                                }
-                            }
-                        }
+                writePlanner.add(regaddr, regsize, s->getValue(regname, REGISTER_RAM));
+            }
 
-                        if (s->getValueCommit(regname, REGISTER_RAM) == 1)
-                        {
-                            int regaddr = getRegisterAddr(s->getControlTable(), regname, REGISTER_RAM);
+            size_t blockCount = writePlanner.plan(s, REGISTER_RAM);
+            for (size_t i = 0; i < blockCount; i++)
+            {
+                const WriteBlock &b = writePlanner.getBlock(i);
 
-                            TRACE_1(HKX, "Writing RAM value '%i' for reg [%i] name: '%s' addr: '%i' size: '%i'",
-                                    s->getValue(regname, REGISTER_RAM), ctid, getRegisterNameTxt(regname).c_str(), regaddr, regsize);
+                hkx_write(id, b.address, b.data.data(), static_cast<int>(b.data.size()), REGISTER_RAM, ack);
+                s->setError(hkx_get_rxpacket_error());
+                s->setStatus(hkx_get_rxpacket_status_detail());
+                updateErrorCount(hkx_get_com_error_count());
+                hkx_print_error();
+            }
 
-                            if (regsize == 1)
-                            {
-                                hkx_write_byte(id, regaddr, s->getValue(regname, REGISTER_RAM), REGISTER_RAM, ack);
-                            }
-                            else //if (regsize == 2)
-                            {
-                                hkx_write_word(id, regaddr, s->getValue(regname, REGISTER_RAM), REGISTER_RAM, ack);
-                            }
+            // Registers due during this loop
+            if (ack != ACK_NO_REPLY)
+            {
+                int due[64];
+                int priorities[64];
+                int dueCount = getDueRegisters(id, due, priorities, 64);
 
-                            s->setError(hkx_get_rxpacket_error());
-                            s->setStatus(hkx_get_rxpacket_status_detail());
-                            s->commitValue(regname, 0, REGISTER_RAM);
-                            updateErrorCount(hkx_get_com_error_count());
-                            hkx_print_error();
+                // Values read, published together once every due register has been read
+                int readRegisters[64];
+                int readValues[64];
+                int readCount = 0;
 
-                            // FIXME: probably doesn't work...
-                            if (regname == REG_ID)
-                            {
-                                unregisterServo(s);
-                                if (s->changeInternalId(s->getValue(regname)) == 1)
-                                {
-                                    registerServo(s);
-                                }
-                            }
-                        }
-                    }
+                for (int i = 0; i < dueCount; i++)
+                {
+                    int regaddr = s->gaddr(due[i], REGISTER_RAM);
+                    int regsize = getRegisterSize(s->getControlTable(), due[i]);
 
-                    // 1 Hz "low priority" update loop
-                    if (((syncloopCounter - cumulid) == 0) &&
-                        (ack != ACK_NO_REPLY))
+                    if (regaddr < 0)
                     {
-                        // Read voltage
-                        s->updateValue(REG_CURRENT_VOLTAGE, hkx_read_byte(id, s->gaddr(REG_CURRENT_VOLTAGE), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
-
-                        // Read temp
-                        s->updateValue(REG_CURRENT_TEMPERATURE, hkx_read_byte(id, s->gaddr(REG_CURRENT_TEMPERATURE), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
+                        continue;
                     }
 
-                    // x/4 Hz "feedback" update loop
-                    if (((syncloopCounter - cumulid) % 4 == 0) &&
-                        (ack != ACK_NO_REPLY))
+                    // RAM_READ instruction (9 bytes) and its ACK (13 bytes + data)
+                    int bytes = 22 + regsize;
+
+                    // Lower priority reads are deferred if they don't fit into this loop
+                    if (priorities[i] > PRIORITY_POSITION &&
+                        estimateCost(bytes, 1) > getRemainingBudget())
                     {
-                        s->updateValue(REG_STATUS_ERROR, hkx_read_byte(id, s->gaddr(REG_STATUS_ERROR), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
+                        deferRegister(id, due[i]);
+                        continue;
+                    }
 
-                        s->updateValue(REG_STATUS_DETAIL, hkx_read_byte(id, s->gaddr(REG_STATUS_DETAIL), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
-/*
-                        s->updateCurrentSpeed(hkx_read_word(id, s->gaddr(SERVO_CURRENT_SPEED), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
+                    std::chrono::steady_clock::time_point readStart = std::chrono::steady_clock::now();
 
-                        s->updateCurrentLoad(hkx_read_word(id, s->gaddr(SERVO_CURRENT_LOAD), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
-*/
+                    readRegisters[readCount] = due[i];
+                    if (regsize == 1)
+                    {
+                        readValues[readCount++] = hkx_read_byte(id, regaddr, REGISTER_RAM, ack);
                     }
-
-                    // x Hz "full speed" update loop
+                    else //if (regsize == 2)
                     {
-                        // Get "current" values from devices, and write them into corresponding objects
-                        int cpos = hkx_read_word(id, s->gaddr(REG_ABSOLUTE_POSITION), REGISTER_RAM, ack);
-                        s->updateValue(REG_ABSOLUTE_POSITION, cpos);
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
+                        readValues[readCount++] = hkx_read_word(id, regaddr, REGISTER_RAM, ack);
+                    }
 
-                        if (s->getGoalPositionCommited() == 1)
-                        {
-                            int gpos = s->getGoalPosition();
+                    updateCostModel(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - readStart).count(), bytes, 1);
+                    s->setError(hkx_get_rxpacket_error());
+                    s->setStatus(hkx_get_rxpacket_status_detail());
+                    updateErrorCount(hkx_get_com_error_count());
+                    hkx_print_error();
+                }
 
-                            hkx_i_jog(id, 0, gpos, ack);
-                            if (hkx_print_error() == 0)
-                            {
-                                s->commitGoalPosition();
-                            }
-                        }
+                s->updateValues(readRegisters, readValues, readCount, REGISTER_RAM);
+            }
 
-                        s->updateValue(REG_ABSOLUTE_GOAL_POSITION, hkx_read_word(id, s->gaddr(REG_ABSOLUTE_GOAL_POSITION), REGISTER_RAM, ack));
-                        s->setError(hkx_get_rxpacket_error());
-                        s->setStatus(hkx_get_rxpacket_status_detail());
-                        updateErrorCount(hkx_get_com_error_count());
-                        hkx_print_error();
-                    }
-                }
+            // Goal position
+            if (s->getGoalPositionCommited() == 1)
+            {
+                int gpos = s->getGoalPosition();
 
-                servoListLock.lock();
+                hkx_i_jog(id, 0, gpos, ack);
+                if (hkx_print_error() == 0)
+                {
+                    s->commitGoalPosition();
+                }
             }
         }
 
-        // Make sure we unlock servoList
-        servoListLock.unlock();
+        // Feedback of this cycle has landed, wake up the subscribers
+        publishCycle();
 
         // Loop control
         syncloopCounter++;
-        syncloopCounter %= syncloopFrequency;
 
         // Loop timer
-        end = std::chrono::system_clock::now();
-        double loopd = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-        double waitd = (syncloopDuration * 1000.0) - loopd;
-
-#ifdef LATENCY_TIMER
-        if ((loopd / 1000.0) > syncloopDuration)
-        {
-            TRACE_WARNING(HKX, "Sync loop duration: %fms of the %fms budget.", (loopd / 1000.0), syncloopDuration);
-        }
-        else
-        {
-            TRACE_INFO(HKX, "Sync loop duration: %fms of the %fms budget.", (loopd / 1000.0), syncloopDuration);
-        }
-#endif // LATENCY_TIMER
-
-        if (waitd > 0.0)
-        {
-            std::chrono::microseconds waittime(static_cast<int>(waitd));
-            std::this_thread::sleep_for(waittime);
-        }
+        endSyncLoop();
     }
 
     TRACE_INFO(HKX, ">> THREAD (tid: '%i') termination by 'loop exit'", std::this_thread::get_id());
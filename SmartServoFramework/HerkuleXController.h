@@ -43,6 +43,11 @@ class HerkuleXController: public HerkuleX, public ServoController
     //! Compute some internal settings (ackPolicy, maxId, protocolVersion) depending on current servo serie and serial device.
     void updateInternalSettings();
 
+    //! Position and goal position at every loop, status at a quarter of the loop frequency, voltage/temperature at 1 Hz.
+    void setDefaultPollingRates();
+
+    std::vector <ServoHerkuleX *> syncServos;              //!< Servos synchronized during the current cycle.
+
     //! Read/write synchronization loop, running inside its own background thread
     void run();
 
@@ -50,7 +55,7 @@ public:
     /*!
      * \brief HerkuleXController constructor.
      * \param servoSerie: The servo serie to use with this controller. Only used to choose the right communication protocol.
-     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;120], default is 30.
+     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;1000], default is 30.
      */
     HerkuleXController(int servoSerie = SERVO_DRS, int ctrlFrequency = 30);
 
@@ -93,6 +98,13 @@ public:
     std::string serialGetCurrentDevice_wrapper();
     std::vector <std::string> serialGetAvailableDevices_wrapper();
     void serialSetLatency_wrapper(int latency);
+    SerialPortStats serialGetStats_wrapper();
+    void serialResetStats_wrapper();
+    LatencyStats getInstructionLatency_wrapper(const int instruction);
+    LatencyStats getServoLatency_wrapper(const int id);
+    void resetLatency_wrapper();
+    bool serialCaptureStart_wrapper(const std::string &path);
+    void serialCaptureStop_wrapper();
 };
 
 /** @}*/
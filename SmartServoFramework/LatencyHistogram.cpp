@@ -0,0 +1,250 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file LatencyHistogram.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+/* ************************************************************************** */
+
+//! Position of the most significant bit set (value must not be 0).
+static inline int msb(uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(value);
+#else
+    int pos = 0;
+    while (value >>= 1)
+    {
+        pos++;
+    }
+    return pos;
+#endif
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(uint32_t value)
+{
+    if (value < 2 * SUB_BUCKET_COUNT)
+    {
+        return static_cast<int>(value);
+    }
+
+    // Keep the SUB_BUCKET_BITS + 1 most significant bits
+    int shift = msb(value) - SUB_BUCKET_BITS;
+    int sub = static_cast<int>(value >> shift) - SUB_BUCKET_COUNT;
+
+    return SUB_BUCKET_COUNT * (shift + 1) + sub;
+}
+
+uint32_t LatencyHistogram::bucketHighestValue(int index)
+{
+    if (index < 2 * SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(index);
+    }
+
+    int shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t top = static_cast<uint64_t>(index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT);
+
+    return static_cast<uint32_t>(((top + 1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+    counts[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(us, std::memory_order_relaxed);
+
+    uint32_t current = maxValue.load(std::memory_order_relaxed);
+    while (us > current && !maxValue.compare_exchange_weak(current, us, std::memory_order_relaxed));
+
+    current = minValue.load(std::memory_order_relaxed);
+    while (us < current && !minValue.compare_exchange_weak(current, us, std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::getCount() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::getPercentile(double percentile) const
+{
+    uint64_t count = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        count += counts[i].load(std::memory_order_relaxed);
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    uint32_t max = maxValue.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            uint32_t value = bucketHighestValue(i);
+            return (value < max) ? value : max;
+        }
+    }
+
+    return max;
+}
+
+LatencyStats LatencyHistogram::getStats() const
+{
+    LatencyStats stats;
+
+    stats.count = total.load(std::memory_order_relaxed);
+    if (stats.count > 0)
+    {
+        stats.mean = static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(stats.count);
+        stats.min = minValue.load(std::memory_order_relaxed);
+        stats.max = maxValue.load(std::memory_order_relaxed);
+        stats.p50 = getPercentile(50.0);
+        stats.p90 = getPercentile(90.0);
+        stats.p99 = getPercentile(99.0);
+        stats.p999 = getPercentile(99.9);
+    }
+
+    return stats;
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    minValue.store(UINT32_MAX, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+/* ************************************************************************** */
+
+LatencyMonitor::LatencyMonitor()
+{
+    for (int i = 0; i < MAX_ID; i++)
+    {
+        servos[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+LatencyMonitor::~LatencyMonitor()
+{
+    for (int i = 0; i < MAX_ID; i++)
+    {
+        delete servos[i].load(std::memory_order_relaxed);
+    }
+}
+
+void LatencyMonitor::record(const int instruction, const int id, const uint32_t us)
+{
+    if (instruction >= 0 && instruction < LATENCY_INSTRUCTION_COUNT)
+    {
+        instructions[instruction].record(us);
+    }
+
+    if (id >= 0 && id < MAX_ID)
+    {
+        LatencyHistogram *h = servos[id].load(std::memory_order_acquire);
+
+        if (h == nullptr)
+        {
+            // First answer from this device, publish its histogram
+            LatencyHistogram *fresh = new LatencyHistogram();
+            if (servos[id].compare_exchange_strong(h, fresh, std::memory_order_acq_rel))
+            {
+                h = fresh;
+            }
+            else
+            {
+                delete fresh;
+            }
+        }
+
+        h->record(us);
+    }
+}
+
+LatencyStats LatencyMonitor::getInstructionStats(const int instruction) const
+{
+    if (instruction >= 0 && instruction < LATENCY_INSTRUCTION_COUNT)
+    {
+        return instructions[instruction].getStats();
+    }
+
+    return LatencyStats();
+}
+
+LatencyStats LatencyMonitor::getServoStats(const int id) const
+{
+    if (id >= 0 && id < MAX_ID)
+    {
+        const LatencyHistogram *h = servos[id].load(std::memory_order_acquire);
+        if (h != nullptr)
+        {
+            return h->getStats();
+        }
+    }
+
+    return LatencyStats();
+}
+
+void LatencyMonitor::reset()
+{
+    for (int i = 0; i < LATENCY_INSTRUCTION_COUNT; i++)
+    {
+        instructions[i].reset();
+    }
+
+    // Histograms are kept allocated, a reader may still be using them
+    for (int i = 0; i < MAX_ID; i++)
+    {
+        LatencyHistogram *h = servos[i].load(std::memory_order_acquire);
+        if (h != nullptr)
+        {
+            h->reset();
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file LatencyHistogram.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief Transaction types used to sort latency measurements.
+ *
+ * HerkuleX commands are mapped to their closest Dynamixel counterpart
+ * (STAT is a PING, EEP/RAM_READ are READ, EEP/RAM_WRITE are WRITE, S_JOG is a SYNC_WRITE).
+ */
+enum LatencyInstructions_e
+{
+    LATENCY_PING        = 0,
+    LATENCY_READ        = 1,
+    LATENCY_WRITE       = 2,
+    LATENCY_SYNC_READ   = 3,
+    LATENCY_SYNC_WRITE  = 4,
+    LATENCY_BULK_READ   = 5,
+    LATENCY_BULK_WRITE  = 6,
+    LATENCY_OTHER       = 7,
+
+    LATENCY_INSTRUCTION_COUNT
+};
+
+/*!
+ * \brief Summary of a latency histogram. Values are in microseconds.
+ */
+typedef struct LatencyStats_t
+{
+    uint64_t count = 0;     //!< Number of measurements.
+    double mean = 0.0;
+    uint32_t min = 0;
+    uint32_t p50 = 0;
+    uint32_t p90 = 0;
+    uint32_t p99 = 0;
+    uint32_t p999 = 0;
+    uint32_t max = 0;
+} LatencyStats;
+
+/*!
+ * \brief A lock-free, HDR-style latency histogram.
+ *
+ * Values (in microseconds) are recorded into log-linear buckets: below 64µs
+ * each value has its own bucket, then each power of two is split into 32
+ * buckets, so every value is known with a relative precision of ~3% on the
+ * whole uint32 range.
+ *
+ * record() is wait-free (relaxed atomic increments) and can be called from the
+ * communication thread while other threads read percentiles.
+ */
+class LatencyHistogram
+{
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int BUCKET_COUNT = SUB_BUCKET_COUNT * (32 - SUB_BUCKET_BITS + 1);
+
+    std::atomic <uint32_t> counts[BUCKET_COUNT];
+    std::atomic <uint64_t> total;
+    std::atomic <uint64_t> sum;
+    std::atomic <uint32_t> minValue;
+    std::atomic <uint32_t> maxValue;
+
+    static int bucketIndex(uint32_t value);
+    static uint32_t bucketHighestValue(int index);
+
+public:
+    LatencyHistogram();
+
+    /*!
+     * \brief Record one measurement.
+     * \param us: Latency in microseconds.
+     */
+    void record(uint32_t us);
+
+    /*!
+     * \brief Get the value below which a given share of the measurements fall.
+     * \param percentile: In the range [0;100].
+     * \return The latency (in microseconds), or 0 if there is no measurement.
+     */
+    uint32_t getPercentile(double percentile) const;
+
+    uint64_t getCount() const;
+
+    /*!
+     * \brief Compute count, mean, min, max and the usual percentiles at once.
+     */
+    LatencyStats getStats() const;
+
+    /*!
+     * \brief Clear the histogram.
+     * \note Measurements recorded concurrently may be lost or partially cleared.
+     */
+    void reset();
+};
+
+/*!
+ * \brief Latency histograms of a serial link, by transaction type and by device ID.
+ *
+ * Device histograms are allocated the first time a device answers, so a link
+ * only pays for the devices it actually talks to.
+ */
+class LatencyMonitor
+{
+    static const int MAX_ID = 254;
+
+    LatencyHistogram instructions[LATENCY_INSTRUCTION_COUNT];
+    std::atomic <LatencyHistogram *> servos[MAX_ID];
+
+public:
+    LatencyMonitor();
+    ~LatencyMonitor();
+
+    /*!
+     * \brief Record the latency of a transaction.
+     * \param instruction: Transaction type (using ::LatencyInstructions_e), or LATENCY_INSTRUCTION_COUNT to only record the device.
+     * \param id: Device ID, or a broadcast ID to only record the transaction type.
+     * \param us: Latency between the instruction packet and the end of the status packet, in microseconds.
+     */
+    void record(const int instruction, const int id, const uint32_t us);
+
+    /*!
+     * \brief Get the latency summary of a transaction type.
+     * \param instruction: Transaction type (using ::LatencyInstructions_e).
+     */
+    LatencyStats getInstructionStats(const int instruction) const;
+
+    /*!
+     * \brief Get the latency summary of a device.
+     * \param id: Device ID.
+     */
+    LatencyStats getServoStats(const int id) const;
+
+    /*!
+     * \brief Clear every histogram.
+     */
+    void reset();
+};
+
+/** @}*/
+
+#endif // LATENCY_HISTOGRAM_H
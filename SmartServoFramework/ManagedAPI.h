@@ -37,4 +37,6 @@
 #include "HerkuleXController.h"
 #include "ServoDRS.h"
 
+#include "ControllerGroup.h"
+
 #endif // MANAGED_API_H
@@ -0,0 +1,142 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file MessageQueue.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief Bounded lock-free multiple producers / single consumer queue.
+ *
+ * Every slot carries a sequence number telling if it is free for the producer
+ * of a given position, or ready for the consumer. Producers claim a position
+ * with a compare-and-swap, so any number of threads may call push(), while
+ * only one thread (the consumer) may call pop().
+ *
+ * Storage is allocated once, inside the object. 'T' must be copyable, and
+ * 'Capacity' a power of two.
+ */
+template <typename T, size_t Capacity>
+class MessageQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MessageQueue capacity must be a power of two");
+
+    struct Slot
+    {
+        std::atomic <size_t> sequence;
+        T value;
+    };
+
+    Slot slots[Capacity];
+
+    std::atomic <size_t> head;              //!< Next position to write, shared by the producers.
+    char padding[64];                       //!< Keep the producers and consumer indexes on different cache lines.
+    std::atomic <size_t> tail;              //!< Next position to read, only modified by the consumer.
+
+public:
+    MessageQueue(): head(0), tail(0)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /*!
+     * \brief Push a value at the back of the queue. Can be called from any thread.
+     * \param value: The value to copy into the queue.
+     * \return False if the queue is full.
+     */
+    bool push(const T &value)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Slot &slot = slots[pos & (Capacity - 1)];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Slot not consumed yet: full
+                return false;
+            }
+            else
+            {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /*!
+     * \brief Pop a value from the front of the queue. Must only be called by the consumer thread.
+     * \param value: Where to copy the value.
+     * \return False if the queue is empty.
+     */
+    bool pop(T &value)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot &slot = slots[pos & (Capacity - 1)];
+
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            // Empty, or the producer of this slot hasn't finished its copy yet
+            return false;
+        }
+
+        value = slot.value;
+        slot.sequence.store(pos + Capacity, std::memory_order_release);
+        tail.store(pos + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /*!
+     * \brief Drop every value ready in the queue. Must only be called by the consumer thread (or while there is none).
+     */
+    void clear()
+    {
+        T value;
+        while (pop(value));
+    }
+};
+
+/** @}*/
+
+#endif // MESSAGE_QUEUE_H
@@ -0,0 +1,164 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file PacketCapture.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "PacketCapture.h"
+#include "minitraces.h"
+
+#include <cstring>
+
+/* ************************************************************************** */
+
+//! Flush period of the capture ring, in milliseconds.
+#define CAPTURE_FLUSH_PERIOD    (20)
+
+PacketCapture::PacketCapture():
+    running(false),
+    framesCaptured(0),
+    framesDropped(0)
+{
+    //
+}
+
+PacketCapture::~PacketCapture()
+{
+    stop();
+}
+
+bool PacketCapture::start(const std::string &path, const int protocol, const int baudrate, const size_t ringSize)
+{
+    stop();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        TRACE_ERROR(TOOLS, "Unable to create capture file '%s'", path.c_str());
+        return false;
+    }
+
+    unsigned char header[CAPTURE_HEADER_SIZE] = {0};
+    std::memcpy(header, CAPTURE_MAGIC, 6);
+    header[6] = CAPTURE_VERSION;
+    header[7] = static_cast<unsigned char>(protocol);
+    for (int i = 0; i < 4; i++)
+    {
+        header[8 + i] = static_cast<unsigned char>((static_cast<uint32_t>(baudrate) >> (8 * i)) & 0xFF);
+    }
+    std::fwrite(header, 1, sizeof(header), file);
+
+    if (!ring)
+    {
+        ring.reset(new RingBuffer(ringSize));
+    }
+
+    // No flush thread is running, so we are the consumer for now
+    ring->clear();
+    framesCaptured = 0;
+    framesDropped = 0;
+    lastFrame = std::chrono::steady_clock::now();
+
+    running.store(true, std::memory_order_release);
+    flushThread = std::thread(&PacketCapture::flushLoop, this);
+
+    TRACE_INFO(TOOLS, "Packet capture started into '%s'", path.c_str());
+
+    return true;
+}
+
+void PacketCapture::stop()
+{
+    if (flushThread.joinable())
+    {
+        running.store(false, std::memory_order_release);
+        flushThread.join();
+    }
+
+    if (file != nullptr)
+    {
+        std::fclose(file);
+        file = nullptr;
+
+        TRACE_INFO(TOOLS, "Packet capture stopped: %u frames captured, %u frames dropped",
+                   framesCaptured.load(), framesDropped.load());
+    }
+}
+
+void PacketCapture::capture(const int direction, const unsigned char *data, const int length)
+{
+    if (running.load(std::memory_order_acquire) == false ||
+        data == nullptr || length <= 0)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (length > CAPTURE_MAX_FRAME_LENGTH ||
+        ring->space() < static_cast<size_t>(CAPTURE_RECORD_HEADER_SIZE + length))
+    {
+        framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int64_t delta = std::chrono::duration_cast<std::chrono::microseconds>(now - lastFrame).count();
+    uint32_t delta32 = (delta > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(delta);
+    uint16_t len16 = static_cast<uint16_t>(length | ((direction == CAPTURE_DIRECTION_RX) ? CAPTURE_RX : 0));
+    lastFrame = now;
+
+    unsigned char record[CAPTURE_RECORD_HEADER_SIZE] = {
+        static_cast<unsigned char>(delta32 & 0xFF),
+        static_cast<unsigned char>((delta32 >> 8) & 0xFF),
+        static_cast<unsigned char>((delta32 >> 16) & 0xFF),
+        static_cast<unsigned char>((delta32 >> 24) & 0xFF),
+        static_cast<unsigned char>(len16 & 0xFF),
+        static_cast<unsigned char>((len16 >> 8) & 0xFF)
+    };
+
+    // The flush thread doesn't parse records, it may safely see a partial one
+    ring->write(record, sizeof(record));
+    ring->write(data, static_cast<size_t>(length));
+
+    framesCaptured.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PacketCapture::flushRing()
+{
+    unsigned char buffer[4096];
+    size_t len = 0;
+
+    while ((len = ring->read(buffer, sizeof(buffer))) > 0)
+    {
+        std::fwrite(buffer, 1, len, file);
+    }
+}
+
+void PacketCapture::flushLoop()
+{
+    while (running.load(std::memory_order_acquire))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(CAPTURE_FLUSH_PERIOD));
+        flushRing();
+    }
+
+    // Last frames
+    flushRing();
+    std::fflush(file);
+}
@@ -0,0 +1,143 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file PacketCapture.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include "RingBuffer.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief Default size of the capture ring, in bytes.
+ */
+#define CAPTURE_RING_SIZE_DEFAULT   (1024*1024)
+
+/*!
+ * \brief Capture file format.
+ *
+ * All values are little endian.
+ * - File header (16 bytes): "SSFCAP" magic, uint8 version, uint8 protocol
+ *   (::ProtocolVersion_e), uint32 baudrate, uint32 reserved.
+ * - Then one record per frame (6 bytes + data): uint32 time elapsed since the
+ *   previous frame (in microseconds, saturated), uint16 frame length with
+ *   CAPTURE_RX set for received bytes, then the frame bytes.
+ *
+ * TX records hold complete instruction packets. RX records hold the bytes as
+ * they were returned by the serial port, so a status packet can be split across
+ * several records.
+ */
+#define CAPTURE_MAGIC               "SSFCAP"
+#define CAPTURE_VERSION             (1)
+#define CAPTURE_HEADER_SIZE         (16)
+#define CAPTURE_RECORD_HEADER_SIZE  (6)
+#define CAPTURE_RX                  (0x8000)
+#define CAPTURE_MAX_FRAME_LENGTH    (0x7FFF)
+
+/*!
+ * \brief Frame direction.
+ */
+enum CaptureDirection_e
+{
+    CAPTURE_DIRECTION_TX = 0,   //!< Instruction packet, sent to the devices
+    CAPTURE_DIRECTION_RX = 1    //!< Status bytes, received from the devices
+};
+
+/*!
+ * \brief Binary capture of the serial traffic of a protocol instance.
+ *
+ * The communication thread calls capture() for every frame: the frame is
+ * timestamped and copied into a preallocated lock-free ring, without any lock,
+ * allocation or syscall. A background thread flushes the ring to the capture
+ * file. If the ring is full (the disk can't keep up), frames are dropped and
+ * counted instead of slowing down the communication.
+ *
+ * Captures can be fed back into a Dynamixel or HerkuleX instance with
+ * SerialPortReplay.
+ */
+class PacketCapture
+{
+    std::unique_ptr <RingBuffer> ring;      //!< Capture ring, allocated on first start() and kept until destruction.
+    std::FILE *file = nullptr;              //!< Capture file.
+    std::thread flushThread;                //!< Background thread writing the ring to the capture file.
+    std::atomic <bool> running;             //!< Set while capture() records frames.
+
+    std::chrono::steady_clock::time_point lastFrame; //!< Timestamp of the previous frame (producer side).
+
+    std::atomic <uint32_t> framesCaptured;
+    std::atomic <uint32_t> framesDropped;
+
+    //! Flush thread.
+    void flushLoop();
+
+    //! Write everything available in the ring to the capture file.
+    void flushRing();
+
+public:
+    PacketCapture();
+    ~PacketCapture();
+
+    PacketCapture(const PacketCapture &) = delete;
+    PacketCapture &operator=(const PacketCapture &) = delete;
+
+    /*!
+     * \brief Create a capture file and start recording frames.
+     * \param path: Path of the capture file (overwritten if it exists).
+     * \param protocol: Protocol used on the link (::ProtocolVersion_e), saved in the file header.
+     * \param baudrate: Baudrate of the link, saved in the file header.
+     * \param ringSize: Size of the capture ring, in bytes. Only used the first time a capture is started.
+     * \return True if the capture has started.
+     */
+    bool start(const std::string &path, const int protocol, const int baudrate, const size_t ringSize = CAPTURE_RING_SIZE_DEFAULT);
+
+    /*!
+     * \brief Stop recording frames, flush the ring and close the capture file.
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    /*!
+     * \brief Record a frame. Only one thread (the communication thread) may call this function.
+     * \param direction: Frame direction (::CaptureDirection_e).
+     * \param data: Frame bytes.
+     * \param length: Frame size, in bytes.
+     */
+    void capture(const int direction, const unsigned char *data, const int length);
+
+    uint32_t getFramesCaptured() const { return framesCaptured.load(std::memory_order_relaxed); }
+    uint32_t getFramesDropped() const { return framesDropped.load(std::memory_order_relaxed); }
+};
+
+/** @}*/
+
+#endif // PACKET_CAPTURE_H
@@ -0,0 +1,134 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file RingBuffer.cpp
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "RingBuffer.h"
+
+// C++ standard libraries
+#include <cstring>
+#include <algorithm>
+
+RingBuffer::RingBuffer(size_t size):
+    buffer(nullptr),
+    capacity(1),
+    head(0),
+    tail(0)
+{
+    while (capacity < size)
+    {
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+
+    buffer = new unsigned char[capacity];
+}
+
+RingBuffer::~RingBuffer()
+{
+    delete [] buffer;
+}
+
+size_t RingBuffer::available() const
+{
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+}
+
+size_t RingBuffer::space() const
+{
+    return capacity - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+}
+
+size_t RingBuffer::write(const unsigned char *data, size_t length)
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_acquire);
+
+    length = std::min(length, capacity - (h - t));
+    if (length > 0)
+    {
+        size_t first = std::min(length, capacity - (h & mask));
+        memcpy(buffer + (h & mask), data, first);
+        memcpy(buffer, data + first, length - first);
+
+        head.store(h + length, std::memory_order_release);
+    }
+
+    return length;
+}
+
+size_t RingBuffer::writeRegions(unsigned char *regions[2], size_t lengths[2])
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_acquire);
+    size_t length = capacity - (h - t);
+
+    regions[0] = buffer + (h & mask);
+    lengths[0] = std::min(length, capacity - (h & mask));
+    regions[1] = buffer;
+    lengths[1] = length - lengths[0];
+
+    return length;
+}
+
+void RingBuffer::writeCommit(size_t length)
+{
+    head.store(head.load(std::memory_order_relaxed) + length, std::memory_order_release);
+}
+
+size_t RingBuffer::peek(unsigned char *data, size_t length) const
+{
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+
+    length = std::min(length, h - t);
+    if (length > 0)
+    {
+        size_t first = std::min(length, capacity - (t & mask));
+        memcpy(data, buffer + (t & mask), first);
+        memcpy(data + first, buffer, length - first);
+    }
+
+    return length;
+}
+
+size_t RingBuffer::read(unsigned char *data, size_t length)
+{
+    length = peek(data, length);
+    tail.store(tail.load(std::memory_order_relaxed) + length, std::memory_order_release);
+
+    return length;
+}
+
+size_t RingBuffer::skip(size_t length)
+{
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+
+    length = std::min(length, h - t);
+    tail.store(t + length, std::memory_order_release);
+
+    return length;
+}
+
+void RingBuffer::clear()
+{
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+}
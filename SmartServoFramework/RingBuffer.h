@@ -0,0 +1,112 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file RingBuffer.h
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief Lock-free single producer / single consumer byte ring buffer.
+ *
+ * The capacity is rounded up to a power of two and allocated once, at
+ * construction. One thread (the producer) may call write() / writeRegions() /
+ * writeCommit(), while another thread (the consumer) calls read() / peek() /
+ * skip() / clear(), without any lock.
+ *
+ * The producer can also fill the buffer in place (ex: directly from a readv()
+ * syscall) using writeRegions() then writeCommit().
+ */
+class RingBuffer
+{
+    unsigned char *buffer;                  //!< Storage, 'capacity' bytes.
+    size_t capacity;                        //!< Storage size, always a power of two.
+    size_t mask;                            //!< capacity - 1.
+
+    std::atomic <size_t> head;              //!< Write index, only modified by the producer.
+    char padding[64];                       //!< Keep the producer and consumer indexes on different cache lines.
+    std::atomic <size_t> tail;              //!< Read index, only modified by the consumer.
+
+public:
+    /*!
+     * \brief RingBuffer constructor.
+     * \param size: Minimum capacity of the ring, in bytes. Will be rounded up to a power of two.
+     */
+    RingBuffer(size_t size);
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    //! Capacity of the ring, in bytes.
+    size_t size() const { return capacity; }
+
+    //! Number of bytes ready to be read (consumer side).
+    size_t available() const;
+
+    //! Number of bytes that can be written (producer side).
+    size_t space() const;
+
+    /*!
+     * \brief Producer: copy up to 'length' bytes into the ring.
+     * \return The number of bytes actually written.
+     */
+    size_t write(const unsigned char *data, size_t length);
+
+    /*!
+     * \brief Producer: get the free space of the ring as (at most) two contiguous regions.
+     * \param[out] regions: Pointers to the regions. Fill them in order, then call writeCommit().
+     * \param[out] lengths: Size of the regions, in bytes. The second one is 0 if the free space doesn't wrap.
+     * \return The total free space, in bytes.
+     */
+    size_t writeRegions(unsigned char *regions[2], size_t lengths[2]);
+
+    //! Producer: publish 'length' bytes previously written into writeRegions().
+    void writeCommit(size_t length);
+
+    /*!
+     * \brief Consumer: copy up to 'length' bytes out of the ring.
+     * \return The number of bytes actually read.
+     */
+    size_t read(unsigned char *data, size_t length);
+
+    /*!
+     * \brief Consumer: copy up to 'length' bytes out of the ring, without consuming them.
+     * \return The number of bytes actually copied.
+     */
+    size_t peek(unsigned char *data, size_t length) const;
+
+    //! Consumer: discard up to 'length' bytes.
+    size_t skip(size_t length);
+
+    //! Consumer: discard every byte currently in the ring.
+    void clear();
+};
+
+/** @}*/
+
+#endif // RING_BUFFER_H
@@ -25,6 +25,8 @@
 #include "HerkuleXTools.h"
 #include "minitraces.h"
 
+#include <algorithm>
+
 // Include the OS specific serialPortsScanner()
 #include "SerialPortQt.h"
 #include "SerialPortLinux.h"
@@ -37,7 +39,20 @@ SerialPort::SerialPort(const int serialDevice, const int servoDevices):
     ttyDeviceLatencyTime(LATENCY_TIME_DEFAULT),
     ttyDeviceLockPath("null"),
     serialDevice(serialDevice),
-    servoDevices(servoDevices)
+    servoDevices(servoDevices),
+    statsBytesTx(0),
+    statsBytesRx(0),
+    statsTransactions(0),
+    statsReplies(0),
+    statsTxErrors(0),
+    statsTimeouts(0),
+    statsTimeoutsPartial(0),
+    statsErrorsId(0),
+    statsErrorsChecksum(0),
+    statsTxWireUs(0),
+    statsRxWireUs(0),
+    statsWaitUs(0),
+    statsStartTime(0.0)
 {
     //
 }
@@ -252,6 +267,11 @@ bool SerialPort::removeLock()
     return false;
 }
 
+void SerialPort::txNoReply()
+{
+    // Nothing to do, replies are not tracked by default
+}
+
 void SerialPort::setLatency(int latency)
 {
     if (latency >= 1 && latency <= 128)
@@ -278,3 +298,122 @@ int SerialPort::getDeviceBaudRate()
 {
     return ttyDeviceBaudRate;
 }
+
+void SerialPort::statsTransmit(int bytes)
+{
+    if (statsStartTime.load(std::memory_order_relaxed) == 0.0)
+    {
+        statsStartTime.store(getTime(), std::memory_order_relaxed);
+    }
+
+    if (bytes < 0)
+    {
+        statsTxErrors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // packetStartTime has been set by setTimeOut(), right after the instruction
+    // packet was handed to the OS, so it still had to go on the wire
+    statsWaitFrom = packetStartTime + byteTransfertTime * bytes;
+    statsTransactions.fetch_add(1, std::memory_order_relaxed);
+    statsBytesTx.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    statsTxWireUs.fetch_add(static_cast<uint64_t>(byteTransfertTime * 1000.0 * bytes), std::memory_order_relaxed);
+}
+
+void SerialPort::statsComplete(int bytes, int status)
+{
+    if (bytes < 0)
+    {
+        bytes = 0;
+    }
+
+    double rxWire = byteTransfertTime * bytes;
+    statsBytesRx.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    statsRxWireUs.fetch_add(static_cast<uint64_t>(rxWire * 1000.0), std::memory_order_relaxed);
+
+    if (status != TRANSACTION_NO_REPLY)
+    {
+        // Several status packets may answer the same instruction packet, each
+        // one only accounts for the time since the previous one
+        double now = getTime();
+        double wait = now - statsWaitFrom - rxWire;
+        if (wait > 0.0)
+        {
+            statsWaitUs.fetch_add(static_cast<uint64_t>(wait * 1000.0), std::memory_order_relaxed);
+        }
+        statsWaitFrom = now;
+    }
+
+    switch (status)
+    {
+    case TRANSACTION_REPLY:
+        statsReplies.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case TRANSACTION_TIMEOUT:
+        statsTimeouts.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case TRANSACTION_PARTIAL:
+        statsTimeoutsPartial.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case TRANSACTION_BAD_ID:
+        statsErrorsId.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case TRANSACTION_BAD_CHECKSUM:
+        statsErrorsChecksum.fetch_add(1, std::memory_order_relaxed);
+        break;
+    default:
+        break;
+    }
+}
+
+SerialPortStats SerialPort::getStats()
+{
+    SerialPortStats stats;
+
+    stats.bytesTx = statsBytesTx.load(std::memory_order_relaxed);
+    stats.bytesRx = statsBytesRx.load(std::memory_order_relaxed);
+    stats.transactions = statsTransactions.load(std::memory_order_relaxed);
+    stats.replies = statsReplies.load(std::memory_order_relaxed);
+    stats.txErrors = statsTxErrors.load(std::memory_order_relaxed);
+    stats.timeouts = statsTimeouts.load(std::memory_order_relaxed);
+    stats.timeoutsPartial = statsTimeoutsPartial.load(std::memory_order_relaxed);
+    stats.errorsId = statsErrorsId.load(std::memory_order_relaxed);
+    stats.errorsChecksum = statsErrorsChecksum.load(std::memory_order_relaxed);
+
+    stats.txWireTime = statsTxWireUs.load(std::memory_order_relaxed) / 1000.0;
+    stats.rxWireTime = statsRxWireUs.load(std::memory_order_relaxed) / 1000.0;
+    stats.waitTime = statsWaitUs.load(std::memory_order_relaxed) / 1000.0;
+
+    double start = statsStartTime.load(std::memory_order_relaxed);
+    if (start > 0.0)
+    {
+        stats.elapsedTime = getTime() - start;
+    }
+
+    double busy = stats.txWireTime + stats.rxWireTime + stats.waitTime;
+    if (stats.elapsedTime > 0.0)
+    {
+        stats.idleTime = std::max(0.0, stats.elapsedTime - busy);
+        stats.percentBusy = std::min(100.0, busy / stats.elapsedTime * 100.0);
+        stats.percentWire = std::min(100.0, (stats.txWireTime + stats.rxWireTime) / stats.elapsedTime * 100.0);
+    }
+
+    return stats;
+}
+
+void SerialPort::resetStats()
+{
+    statsBytesTx.store(0, std::memory_order_relaxed);
+    statsBytesRx.store(0, std::memory_order_relaxed);
+    statsTransactions.store(0, std::memory_order_relaxed);
+    statsReplies.store(0, std::memory_order_relaxed);
+    statsTxErrors.store(0, std::memory_order_relaxed);
+    statsTimeouts.store(0, std::memory_order_relaxed);
+    statsTimeoutsPartial.store(0, std::memory_order_relaxed);
+    statsErrorsId.store(0, std::memory_order_relaxed);
+    statsErrorsChecksum.store(0, std::memory_order_relaxed);
+    statsTxWireUs.store(0, std::memory_order_relaxed);
+    statsRxWireUs.store(0, std::memory_order_relaxed);
+    statsWaitUs.store(0, std::memory_order_relaxed);
+    statsStartTime.store(getTime(), std::memory_order_relaxed);
+}
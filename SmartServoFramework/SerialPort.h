@@ -26,6 +26,8 @@
 #include "ServoTools.h"
 #include <string>
 #include <vector>
+#include <atomic>
+#include <cstdint>
 
 /*!
  * \brief Latency time (in milliseconds) on the serial port.
@@ -80,6 +82,49 @@ enum SerialErrorCodes_e
     COMM_RXCORRUPT  = -7                     //!< Status packet corrupted
 };
 
+/*!
+ * \brief How a transaction ended, used for bus utilization accounting.
+ */
+enum SerialTransactionStatus_e
+{
+    TRANSACTION_REPLY       = 0,    //!< A valid status packet has been received
+    TRANSACTION_NO_REPLY    = 1,    //!< No status packet expected (broadcast or ack policy)
+    TRANSACTION_TIMEOUT     = 2,    //!< Timeout reached, nothing received
+    TRANSACTION_PARTIAL     = 3,    //!< Timeout reached, incomplete status packet received
+    TRANSACTION_BAD_ID      = 4,    //!< Status packet received from another device
+    TRANSACTION_BAD_CHECKSUM= 5     //!< Status packet received with a wrong checksum
+};
+
+/*!
+ * \brief Bus utilization snapshot of a serial port.
+ *
+ * Times are in milliseconds, since the first transaction or the last call to
+ * SerialPort::resetStats(). The elapsed time is split into:
+ * - wire time: bytes actually transmitted on the bus, computed from the baud rate.
+ * - wait time: the rest of the transactions (device return delay, adapter and OS latency, timeouts).
+ * - idle time: nothing going on.
+ */
+typedef struct SerialPortStats_t
+{
+    uint64_t bytesTx = 0;           //!< Bytes sent.
+    uint64_t bytesRx = 0;           //!< Bytes received.
+    uint64_t transactions = 0;      //!< Instruction packets sent.
+    uint64_t replies = 0;           //!< Valid status packets received (a sync or bulk read gets several).
+    uint64_t txErrors = 0;          //!< Instruction packets not (entirely) sent.
+    uint64_t timeouts = 0;          //!< Timeouts with no reply at all.
+    uint64_t timeoutsPartial = 0;   //!< Timeouts with an incomplete reply.
+    uint64_t errorsId = 0;          //!< Replies coming from the wrong device.
+    uint64_t errorsChecksum = 0;    //!< Replies with a wrong checksum.
+
+    double elapsedTime = 0.0;       //!< Duration of the accounting window.
+    double txWireTime = 0.0;        //!< Time spent sending bytes.
+    double rxWireTime = 0.0;        //!< Time spent receiving bytes.
+    double waitTime = 0.0;          //!< Time spent waiting for replies, minus wire time.
+    double idleTime = 0.0;          //!< Time with no transaction in progress.
+    double percentBusy = 0.0;       //!< Share of the elapsed time the bus has been busy (wire + wait), in %.
+    double percentWire = 0.0;       //!< Share of the elapsed time bytes have been on the wire, in %.
+} SerialPortStats;
+
 /*!
  * \brief The SerialPort base class.
  *
@@ -119,6 +164,22 @@ protected:
     double packetWaitTime = 0.0;    //!< Time (in millisecond) to wait for an answer.
     double byteTransfertTime = 0.0; //!< Estimation of the time (in millisecond) needed to read/write one byte on the serial link.
 
+    // Bus utilization accounting (relaxed atomics, times in microseconds)
+    std::atomic <uint64_t> statsBytesTx;
+    std::atomic <uint64_t> statsBytesRx;
+    std::atomic <uint64_t> statsTransactions;
+    std::atomic <uint64_t> statsReplies;
+    std::atomic <uint64_t> statsTxErrors;
+    std::atomic <uint64_t> statsTimeouts;
+    std::atomic <uint64_t> statsTimeoutsPartial;
+    std::atomic <uint64_t> statsErrorsId;
+    std::atomic <uint64_t> statsErrorsChecksum;
+    std::atomic <uint64_t> statsTxWireUs;
+    std::atomic <uint64_t> statsRxWireUs;
+    std::atomic <uint64_t> statsWaitUs;
+    std::atomic <double> statsStartTime; //!< Start of the accounting window (in millisecond), 0 if not started.
+    double statsWaitFrom = 0.0;         //!< When the last instruction packet (or status packet of a sync/bulk read) ended on the wire (in millisecond).
+
     /*!
      * \brief Get the current time.
      * \return The current time in milliseconds.
@@ -241,6 +302,12 @@ public:
      */
     virtual void flush() = 0;
 
+    /*!
+     * \brief Get the estimated time needed to read/write one byte on the serial link.
+     * \return The time per byte, in milliseconds.
+     */
+    double getByteTime() const { return byteTransfertTime; }
+
     /*!
      * \brief Set the serial port latency value, used to compute timeout duration for packet reception.
      * \param latency: The latency value in millisecond.
@@ -265,6 +332,37 @@ public:
      */
     virtual int checkTimeOut() = 0;
 
+    /*!
+     * \brief Tell the link that the last packet sent won't be answered (broadcast, or no status packet requested).
+     */
+    virtual void txNoReply();
+
+    /*!
+     * \brief Account for an instruction packet sent, right after tx() and setTimeOut().
+     * \param bytes: Number of bytes sent, or -1 if the packet couldn't be sent.
+     */
+    void statsTransmit(int bytes);
+
+    /*!
+     * \brief Account for the end of a transaction, or for each status packet of a sync or bulk read.
+     * \param bytes: Number of bytes received for this transaction.
+     * \param status: How the transaction ended (using ::SerialTransactionStatus_e).
+     */
+    void statsComplete(int bytes, int status);
+
+    /*!
+     * \brief Get a snapshot of the bus utilization of this serial port.
+     *
+     * Lock free: the values are read independently from each other, so a snapshot
+     * taken during a transaction may be slightly inconsistent.
+     */
+    SerialPortStats getStats();
+
+    /*!
+     * \brief Reset the bus utilization counters and start a new accounting window.
+     */
+    void resetStats();
+
     /*!
      * \brief Get serial device name.
      * \return A string containing the device name.
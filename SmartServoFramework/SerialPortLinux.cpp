@@ -31,6 +31,10 @@
 #include <linux/serial.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
+#include <sys/inotify.h>
+#include <sys/uio.h>
+#include <dirent.h>
+#include <climits>
 
 // Device lock support
 #define LOCK_FLOCK
@@ -54,60 +58,246 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <mutex>
+#include <algorithm>
+#include <cstdlib>
 
 #define SCAN_PORT_TYPES 2
-#define SCAN_PORT_COUNT 8
 
-int serialPortsScanner(std::vector <std::string> &availableSerialPorts)
+//! Size of the user-space RX ring, large enough to hold several status packets.
+#define RX_RING_SIZE 4096
+
+static const char *sysfsTtyPath = "/sys/class/tty";
+
+/*!
+ * \brief Read the first line of a sysfs attribute file.
+ * \param path: Path to the sysfs attribute.
+ * \return The attribute value, or an empty string if it cannot be read.
+ */
+static std::string sysfsReadAttribute(const std::string &path)
 {
-    int retcode = 0;
-    std::string portBase = "/dev/tty";
-    std::string portVariations[SCAN_PORT_TYPES] = {"USB", "ACM"};
+    std::string value;
+    std::ifstream attr(path.c_str());
 
-    TRACE_INFO(SERIAL, "serialPortsScanner() [Linux variant]");
+    if (attr.is_open())
+    {
+        std::getline(attr, value);
+    }
 
-    // Serial ports from USB adapters (/dev/ttyUSB*) (ftdi or other chips)
-    // Serial ports from USB adapters (/dev/ttyACM*) ("abstract control model")
+    return value;
+}
 
-    // Regular serial ports from motherboards (/dev/ttyS*)
-    // Regular serial ports from motherboards (/dev/tty*)
-    // /dev/ttyS* and /dev/tty* devices are not auto-detected by this function
+/*!
+ * \brief Gather driver and USB informations for a tty device from sysfs.
+ * \param[in,out] port: Infos structure, with the 'name' field already set.
+ * \return True if the tty is backed by a real device, false otherwise.
+ */
+static bool sysfsGetPortInfos(SerialPortInfos &port)
+{
+    std::string devicePath = std::string(sysfsTtyPath) + "/" + port.name + "/device";
+
+    // Virtual ttys (consoles, ptys...) have no 'device' link
+    char buf[PATH_MAX];
+    if (realpath(devicePath.c_str(), buf) == nullptr)
+    {
+        return false;
+    }
+    std::string deviceRealPath(buf);
 
-    for (int i = 0; i < SCAN_PORT_TYPES; i++)
+    // Driver name
+    ssize_t len = readlink((devicePath + "/driver").c_str(), buf, sizeof(buf) - 1);
+    if (len > 0)
     {
-        for (int j = 0; j < SCAN_PORT_COUNT; j++)
+        buf[len] = '\0';
+        std::string driverLink(buf);
+        size_t found = driverLink.rfind("/");
+        port.driver = (found != std::string::npos) ? driverLink.substr(found + 1) : driverLink;
+    }
+
+    // USB attributes live on the parent usb_device, a few levels above the usb interface
+    std::string usbPath = deviceRealPath;
+    for (int i = 0; i < 4 && usbPath.size() > 1; i++)
+    {
+        if (access((usbPath + "/idVendor").c_str(), R_OK) == 0)
         {
-            std::string portPath = portBase + portVariations[i] + std::to_string(j);
-            std::string portName = "tty" + portVariations[i] + std::to_string(j);
+            std::string vid = sysfsReadAttribute(usbPath + "/idVendor");
+            std::string pid = sysfsReadAttribute(usbPath + "/idProduct");
+            port.usbVendorId = vid.empty() ? -1 : static_cast<int>(std::strtol(vid.c_str(), nullptr, 16));
+            port.usbProductId = pid.empty() ? -1 : static_cast<int>(std::strtol(pid.c_str(), nullptr, 16));
+            port.usbManufacturer = sysfsReadAttribute(usbPath + "/manufacturer");
+            port.usbProduct = sysfsReadAttribute(usbPath + "/product");
+            port.usbSerial = sysfsReadAttribute(usbPath + "/serial");
+            break;
+        }
+
+        usbPath = usbPath.substr(0, usbPath.rfind("/"));
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Scan /sys/class/tty for USB serial ports.
+ * \param[out] ports: A list of serial ports found, sorted by name.
+ */
+static void sysfsScanPorts(std::vector <SerialPortInfos> &ports)
+{
+    const std::string portVariations[SCAN_PORT_TYPES] = {"ttyUSB", "ttyACM"};
+
+    DIR *dir = opendir(sysfsTtyPath);
+    if (dir == nullptr)
+    {
+        TRACE_ERROR(SERIAL, "Unable to open '%s', no serial ports can be scanned", sysfsTtyPath);
+        return;
+    }
 
-            // Open arguments:
-            // O_RDONLY: Request opening the file read/write
-            // O_NOCTTY: If the named file is a terminal device, don't make it the controlling terminal for the process
-            // O_NONBLOCK: Don't get stuck on invalid ports
-            int fd = open(portPath.c_str(), O_RDONLY| O_NOCTTY | O_NONBLOCK);
-            if (fd > 0)
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        std::string name(entry->d_name);
+
+        for (int i = 0; i < SCAN_PORT_TYPES; i++)
+        {
+            if (name.compare(0, portVariations[i].size(), portVariations[i]) == 0)
             {
-                // Because we only open the devices and never write anything on them,
-                // we don't try to lock them or check locks on them
+                SerialPortInfos port;
+                port.name = name;
+                port.path = "/dev/" + name;
 
-                // Used to validate existing serial port availability
-                struct serial_struct serinfo;
-                if (ioctl(fd, TIOCGSERIAL, &serinfo) > -2)
-                {
-                    TRACE_INFO(SERIAL, "- Scanning for serial port on '%s' > FOUND", portPath.c_str());
-                    availableSerialPorts.push_back(portPath);
-                    retcode++;
-                }
-                else
+                // Make sure the tty has a real device behind it, and that its node exists
+                if (sysfsGetPortInfos(port) == true &&
+                    access(port.path.c_str(), F_OK) == 0)
                 {
-                    TRACE_INFO(SERIAL, "- Scanning for serial port on '%s' > FOUND, but not available?", portPath.c_str());
+                    ports.push_back(port);
                 }
+                break;
+            }
+        }
+    }
+
+    closedir(dir);
+
+    // Sort by type, then by index (ttyUSB2 before ttyUSB10)
+    std::sort(ports.begin(), ports.end(), [](const SerialPortInfos &a, const SerialPortInfos &b)
+    {
+        std::string ta = a.name.substr(0, 6), tb = b.name.substr(0, 6);
+        if (ta != tb)
+        {
+            return tb < ta; // USB adapters first
+        }
+        return std::atoi(a.name.c_str() + 6) < std::atoi(b.name.c_str() + 6);
+    });
+}
+
+// Scanner cache, invalidated by inotify events on /dev
+static std::mutex scannerCacheLock;
+static std::vector <SerialPortInfos> scannerCache;
+static bool scannerCacheValid = false;
+static int scannerInotifyFd = -1;
+
+/*!
+ * \brief Check if the scanner cache is still valid.
+ * \return True if the cache can be used, false if a rescan is needed.
+ *
+ * Must be called with 'scannerCacheLock' held.
+ */
+static bool scannerCacheCheck()
+{
+    if (scannerInotifyFd < 0)
+    {
+        scannerInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (scannerInotifyFd < 0 ||
+            inotify_add_watch(scannerInotifyFd, "/dev", IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0)
+        {
+            TRACE_WARNING(SERIAL, "Unable to watch /dev with inotify, serial ports scanner cache disabled");
+            if (scannerInotifyFd >= 0)
+            {
+                close(scannerInotifyFd);
+            }
+            scannerInotifyFd = -2;
+        }
+        scannerCacheValid = false;
+    }
+
+    if (scannerInotifyFd == -2)
+    {
+        return false;
+    }
 
-                close(fd);
+    // Drain pending events, any tty related event invalidates the cache
+    char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len = 0;
+    while ((len = read(scannerInotifyFd, events, sizeof(events))) > 0)
+    {
+        for (char *ptr = events; ptr < events + len; )
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            if (event->len > 0 && strncmp(event->name, "tty", 3) == 0)
+            {
+                scannerCacheValid = false;
+            }
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                scannerCacheValid = false;
             }
+            ptr += sizeof(struct inotify_event) + event->len;
         }
     }
 
+    return scannerCacheValid;
+}
+
+int serialPortsScannerDetailed(std::vector <SerialPortInfos> &availableSerialPorts)
+{
+    std::lock_guard <std::mutex> lock(scannerCacheLock);
+
+    // Serial ports from USB adapters (/dev/ttyUSB*) (ftdi or other chips)
+    // Serial ports from USB adapters (/dev/ttyACM*) ("abstract control model")
+
+    // Regular serial ports from motherboards (/dev/ttyS*)
+    // Regular serial ports from motherboards (/dev/tty*)
+    // /dev/ttyS* and /dev/tty* devices are not auto-detected by this function
+
+    if (scannerCacheCheck() == false)
+    {
+        scannerCache.clear();
+        sysfsScanPorts(scannerCache);
+        scannerCacheValid = true;
+
+        for (auto const &port: scannerCache)
+        {
+            if (port.usbVendorId >= 0)
+            {
+                TRACE_INFO(SERIAL, "- Scanning for serial port on '%s' > FOUND (%s, %04x:%04x, '%s' '%s' serial '%s')",
+                           port.path.c_str(), port.driver.c_str(),
+                           port.usbVendorId, port.usbProductId,
+                           port.usbManufacturer.c_str(), port.usbProduct.c_str(), port.usbSerial.c_str());
+            }
+            else
+            {
+                TRACE_INFO(SERIAL, "- Scanning for serial port on '%s' > FOUND (%s)",
+                           port.path.c_str(), port.driver.c_str());
+            }
+        }
+    }
+
+    availableSerialPorts.insert(availableSerialPorts.end(), scannerCache.begin(), scannerCache.end());
+
+    return static_cast<int>(scannerCache.size());
+}
+
+int serialPortsScanner(std::vector <std::string> &availableSerialPorts)
+{
+    TRACE_INFO(SERIAL, "serialPortsScanner() [Linux variant]");
+
+    std::vector <SerialPortInfos> ports;
+    int retcode = serialPortsScannerDetailed(ports);
+
+    for (auto const &port: ports)
+    {
+        availableSerialPorts.push_back(port.path);
+    }
+
     return retcode;
 }
 
@@ -116,7 +306,8 @@ SerialPortLinux::SerialPortLinux(std::string &devicePath, const int baud, const
     ttyDeviceFileDescriptor(-1),
     ttyDeviceBaudRateFlag(B1000000),
     ttyCustomSpeed(false),
-    ttyLowLatency(false)
+    ttyLowLatency(false),
+    rxRing(RX_RING_SIZE)
 {
     if (devicePath.empty() == 1 || devicePath == "auto")
     {
@@ -652,6 +843,41 @@ int SerialPortLinux::tx(unsigned char *packet, int packetLength)
     return writeStatus;
 }
 
+int SerialPortLinux::rxRingFill()
+{
+    unsigned char *regions[2];
+    size_t lengths[2];
+
+    if (rxRing.writeRegions(regions, lengths) == 0)
+    {
+        // Ring is full, the protocol layer will consume it first
+        return 0;
+    }
+
+    struct iovec iov[2];
+    iov[0].iov_base = regions[0];
+    iov[0].iov_len = lengths[0];
+    iov[1].iov_base = regions[1];
+    iov[1].iov_len = lengths[1];
+
+    ssize_t readStatus = readv(ttyDeviceFileDescriptor, iov, (lengths[1] > 0) ? 2 : 1);
+
+    if (readStatus < 0)
+    {
+        if (errno == EAGAIN || errno == EINTR)
+        {
+            return 0;
+        }
+
+        TRACE_ERROR(SERIAL, "Cannot read from serial port '%s': readv() failed with error code '%i'!", ttyDevicePath.c_str(), errno);
+        return -1;
+    }
+
+    rxRing.writeCommit(static_cast<size_t>(readStatus));
+
+    return static_cast<int>(readStatus);
+}
+
 int SerialPortLinux::rx(unsigned char *packet, int packetLength)
 {
     int readStatus = -1;
@@ -660,13 +886,16 @@ int SerialPortLinux::rx(unsigned char *packet, int packetLength)
     {
         if (packet != nullptr && packetLength > 0)
         {
-            memset(packet, 0, packetLength);
-            readStatus = read(ttyDeviceFileDescriptor, packet, packetLength);
-
-            if (readStatus < 0)
+            // Only go to the kernel if the ring cannot serve the whole request
+            if (rxRing.available() < static_cast<size_t>(packetLength))
             {
-                TRACE_ERROR(SERIAL, "Cannot read from serial port '%s': read() failed with error code '%i'!", ttyDevicePath.c_str(), errno);
+                if (rxRingFill() < 0 && rxRing.available() == 0)
+                {
+                    return readStatus;
+                }
             }
+
+            readStatus = static_cast<int>(rxRing.read(packet, static_cast<size_t>(packetLength)));
         }
         else
         {
@@ -691,6 +920,9 @@ void SerialPortLinux::flush()
 
         tcflush(ttyDeviceFileDescriptor, TCIFLUSH);
     }
+
+    // Bytes already drained from the kernel must be discarded too
+    rxRing.clear();
 }
 
 double SerialPortLinux::getTime()
@@ -26,20 +26,46 @@
 #if defined(__linux__) || defined(__unix__)
 
 #include "SerialPort.h"
+#include "RingBuffer.h"
+
+/*!
+ * \brief Informations about a serial port, gathered from sysfs.
+ */
+typedef struct SerialPortInfos_t
+{
+    std::string path;           //!< Device node (ex: /dev/ttyUSB0).
+    std::string name;           //!< Device name (ex: ttyUSB0).
+    std::string driver;         //!< Kernel driver bound to the device (ex: ftdi_sio, cdc_acm).
+    int usbVendorId = -1;       //!< USB vendor ID, or -1 if the device is not an USB device.
+    int usbProductId = -1;      //!< USB product ID, or -1 if the device is not an USB device.
+    std::string usbManufacturer;//!< USB manufacturer string, if available.
+    std::string usbProduct;     //!< USB product string, if available.
+    std::string usbSerial;      //!< USB serial number string, if available.
+} SerialPortInfos;
 
 /*!
  * \brief The serial ports scanner function.
  * \param[out] availableSerialPorts: A list of serial port nodes (ex: /dev/ttyUSB0).
  * \return The number of serial ports found.
  *
- * \todo Use stat() instead of open().
- *
  * Scans for /dev/ttyUSB* and /dev/ttyACM* ports. Regular serial devices on
  * /dev/ttyS* are not scanned as they are always considered as valid even with
  * no USB2Dynamixel / USB2AX or TTL adapter attached.
+ *
+ * Ports are enumerated from /sys/class/tty, devices nodes are never opened.
  */
 int serialPortsScanner(std::vector <std::string> &availableSerialPorts);
 
+/*!
+ * \brief The detailed serial ports scanner function.
+ * \param[out] availableSerialPorts: A list of serial ports and their USB / driver informations.
+ * \return The number of serial ports found.
+ *
+ * Results are cached, and the cache is invalidated (through inotify) every time
+ * a tty node is created or removed from /dev. Repeated calls are thus very cheap.
+ */
+int serialPortsScannerDetailed(std::vector <SerialPortInfos> &availableSerialPorts);
+
 /*!
  * \brief The SerialPortLinux class.
  */
@@ -50,6 +76,17 @@ class SerialPortLinux: public SerialPort
     bool ttyCustomSpeed;           //!< Try to set custom speed on the serial port.
     bool ttyLowLatency;            //!< Try to set low latency flag on the serial port (works only on FTDI based adapters).
 
+    RingBuffer rxRing;             //!< User-space RX buffer, filled by rxRingFill() and consumed by rx().
+
+    /*!
+     * \brief Drain every byte pending in the kernel RX buffer into 'rxRing', using a single readv() call.
+     * \return The number of bytes added to the ring, or -1 if the read failed.
+     *
+     * This is the only producer of 'rxRing'. It is called by rx() when the ring
+     * cannot satisfy a request, but could also be driven by a dedicated reader thread.
+     */
+    int rxRingFill();
+
     /*!
      * \brief Get current time since the Epoch.
      * \return Current time since the Epoch in milliseconds.
@@ -0,0 +1,560 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file SerialPortNet.cpp
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "SerialPortNet.h"
+
+bool isNetworkDevicePath(const std::string &devicePath)
+{
+    return (devicePath.compare(0, 6, "tcp://") == 0 ||
+            devicePath.compare(0, 6, "udp://") == 0);
+}
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+
+#include "minitraces.h"
+
+// POSIX sockets
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+// C++ standard libraries
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+//! Size of the RX ring, large enough to hold the replies of a full pipeline.
+#define NET_RX_RING_SIZE    8192
+
+SerialPortNet::SerialPortNet(std::string &devicePath, const int baud, const int serialDevice, const int servoDevices):
+    SerialPort(serialDevice, servoDevices),
+    netSocket(-1),
+    netUdp(false),
+    rxRing(NET_RX_RING_SIZE),
+    txHead(0),
+    txCount(0),
+    rttSmoothed(0.0),
+    rttVariance(0.0),
+    rttLast(0.0),
+    rttSamples(0),
+    rtoBackoff(1)
+{
+    ttyDevicePath = devicePath;
+    ttyDeviceName = devicePath.substr(6);
+    netUdp = (devicePath.compare(0, 6, "udp://") == 0);
+
+    // Split "host:port", host can be an IPv6 address between brackets
+    std::string hostport = devicePath.substr(6);
+    size_t found = hostport.rfind(":");
+    if (found != std::string::npos && found + 1 < hostport.size())
+    {
+        netHost = hostport.substr(0, found);
+        netPort = hostport.substr(found + 1);
+
+        if (netHost.size() > 2 && netHost.front() == '[' && netHost.back() == ']')
+        {
+            netHost = netHost.substr(1, netHost.size() - 2);
+        }
+    }
+    else
+    {
+        TRACE_ERROR(SERIAL, "Invalid network device path '%s', expected 'tcp://host:port' or 'udp://host:port'", devicePath.c_str());
+        ttyDevicePath = "null";
+    }
+
+    setBaudRate(baud);
+
+    TRACE_INFO(SERIAL, "- Network link set to %s host '%s' port '%s'", netUdp ? "UDP" : "TCP", netHost.c_str(), netPort.c_str());
+    TRACE_INFO(SERIAL, "- Remote bus baud rate has been set to: '%i'", ttyDeviceBaudRate);
+}
+
+SerialPortNet::~SerialPortNet()
+{
+    closeLink();
+}
+
+void SerialPortNet::setBaudRate(const int baud)
+{
+    // Baud rate of the serial bus behind the gateway, only used for timings
+    ttyDeviceBaudRate = checkBaudRate(baud);
+    byteTransfertTime = (1000.0 / static_cast<double>(ttyDeviceBaudRate)) * 10.0;
+}
+
+double SerialPortNet::getTime()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int SerialPortNet::openLink()
+{
+    struct addrinfo hints = {};
+    struct addrinfo *results = nullptr;
+
+    closeLink();
+
+    if (ttyDevicePath == "null")
+    {
+        return -2;
+    }
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = netUdp ? SOCK_DGRAM : SOCK_STREAM;
+
+    int error = getaddrinfo(netHost.c_str(), netPort.c_str(), &hints, &results);
+    if (error != 0)
+    {
+        TRACE_ERROR(SERIAL, "Unable to resolve '%s': %s", netHost.c_str(), gai_strerror(error));
+        return -2;
+    }
+
+    for (struct addrinfo *ai = results; ai != nullptr; ai = ai->ai_next)
+    {
+        netSocket = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (netSocket < 0)
+        {
+            continue;
+        }
+
+        // A connected UDP socket only receives datagrams from the gateway
+        if (connect(netSocket, ai->ai_addr, ai->ai_addrlen) == 0)
+        {
+            break;
+        }
+
+        close(netSocket);
+        netSocket = -1;
+    }
+    freeaddrinfo(results);
+
+    if (netSocket < 0)
+    {
+        TRACE_ERROR(SERIAL, "Unable to connect to '%s': error '%i'", ttyDevicePath.c_str(), errno);
+        return -2;
+    }
+
+    if (netUdp == false)
+    {
+        // Small packets must leave immediately, don't wait to coalesce them
+        int flag = 1;
+        setsockopt(netSocket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+#ifdef TCP_QUICKACK
+        setsockopt(netSocket, IPPROTO_TCP, TCP_QUICKACK, &flag, sizeof(flag));
+#endif
+    }
+
+#ifdef SO_NOSIGPIPE
+    {
+        int flag = 1;
+        setsockopt(netSocket, SOL_SOCKET, SO_NOSIGPIPE, &flag, sizeof(flag));
+    }
+#endif
+
+    fcntl(netSocket, F_SETFL, fcntl(netSocket, F_GETFL, 0) | O_NONBLOCK);
+
+    TRACE_INFO(SERIAL, "- Network link opened on '%s'", ttyDevicePath.c_str());
+
+    return 1;
+}
+
+bool SerialPortNet::isOpen()
+{
+    return (netSocket >= 0);
+}
+
+void SerialPortNet::closeLink()
+{
+    if (isOpen() == true)
+    {
+        close(netSocket);
+        netSocket = -1;
+    }
+
+    rxRing.clear();
+    txCount = 0;
+}
+
+int SerialPortNet::tx(unsigned char *packet, int packetLength)
+{
+    int writeStatus = -1;
+
+    if (isOpen() == true)
+    {
+        if (packet != nullptr && packetLength > 0)
+        {
+            // UDP: one datagram per packet. TCP: a single segment thanks to TCP_NODELAY,
+            // but the socket is non blocking so a full send buffer may accept only part
+            // of the packet: keep sending the rest (for a bounded time) until it's all out.
+            double deadline = getTime() + getRetransmissionTimeout();
+            int sent = 0;
+
+            while (sent < packetLength)
+            {
+                ssize_t len = send(netSocket, packet + sent, static_cast<size_t>(packetLength - sent), MSG_NOSIGNAL);
+
+                if (len > 0)
+                {
+                    sent += static_cast<int>(len);
+                }
+                else if (len < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                else if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    double remaining = deadline - getTime();
+                    struct pollfd pfd = {netSocket, POLLOUT, 0};
+
+                    if (remaining <= 0.0 ||
+                        poll(&pfd, 1, static_cast<int>(std::ceil(remaining))) <= 0)
+                    {
+                        TRACE_ERROR(SERIAL, "Cannot write to network link '%s': timed out after %i/%i bytes!", ttyDevicePath.c_str(), sent, packetLength);
+                        break;
+                    }
+                }
+                else
+                {
+                    TRACE_ERROR(SERIAL, "Cannot write to network link '%s': send() failed with error code '%i'!", ttyDevicePath.c_str(), errno);
+                    break;
+                }
+            }
+
+            if (sent < packetLength)
+            {
+                if (sent > 0 && netUdp == false)
+                {
+                    // The remote end got half an instruction packet, the stream can't be resynchronized
+                    TRACE_ERROR(SERIAL, "Network link '%s' is out of sync after a partial write, closing it", ttyDevicePath.c_str());
+                    closeLink();
+                }
+            }
+            else
+            {
+                writeStatus = sent;
+
+                // Remember when this request left, to match it with its reply
+                if (txCount == NET_PIPELINE_DEPTH)
+                {
+                    txPop();
+                }
+
+                NetRequest &req = txPending[(txHead + txCount) % NET_PIPELINE_DEPTH];
+                req.sentTime = getTime();
+                req.replyLength = 0;
+                req.replyReceived = 0;
+                txCount++;
+            }
+        }
+        else
+        {
+            TRACE_ERROR(SERIAL, "Cannot write to network link '%s': invalid packet buffer or size!", ttyDevicePath.c_str());
+        }
+    }
+    else
+    {
+        TRACE_ERROR(SERIAL, "Cannot write to network link '%s': invalid device!", ttyDevicePath.c_str());
+    }
+
+    return writeStatus;
+}
+
+int SerialPortNet::rxRingFill()
+{
+    int total = 0;
+
+    for (;;)
+    {
+        unsigned char *regions[2];
+        size_t lengths[2];
+
+        if (rxRing.writeRegions(regions, lengths) == 0)
+        {
+            break;
+        }
+
+        ssize_t len = 0;
+        if (netUdp)
+        {
+            // A datagram must be read at once, it may wrap around the end of the ring.
+            // Leave it on the socket until the ring has room for a whole one.
+            unsigned char datagram[1500];
+            if (rxRing.space() < sizeof(datagram))
+            {
+                break;
+            }
+
+            len = recv(netSocket, datagram, sizeof(datagram), 0);
+            if (len > 0)
+            {
+                size_t written = rxRing.write(datagram, static_cast<size_t>(len));
+                if (written < static_cast<size_t>(len))
+                {
+                    TRACE_WARNING(SERIAL, "Network link '%s': RX ring full, dropped %i bytes of a datagram", ttyDevicePath.c_str(), static_cast<int>(len - static_cast<ssize_t>(written)));
+                }
+                len = static_cast<ssize_t>(written);
+            }
+        }
+        else
+        {
+            len = recv(netSocket, regions[0], lengths[0], 0);
+            if (len > 0)
+            {
+                rxRing.writeCommit(static_cast<size_t>(len));
+            }
+        }
+
+        if (len > 0)
+        {
+            total += static_cast<int>(len);
+        }
+        else if (len == 0 && netUdp == false)
+        {
+            TRACE_ERROR(SERIAL, "Network link '%s' has been closed by the remote host", ttyDevicePath.c_str());
+            closeLink();
+            return -1;
+        }
+        else
+        {
+            if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                TRACE_ERROR(SERIAL, "Cannot read from network link '%s': recv() failed with error code '%i'!", ttyDevicePath.c_str(), errno);
+                return -1;
+            }
+            break;
+        }
+    }
+
+    // Replies come back in order: give the received bytes to the oldest requests first
+    int bytes = total;
+    while (bytes > 0 && txCount > 0)
+    {
+        NetRequest &req = txPending[txHead];
+
+        if (req.replyLength > 0)
+        {
+            int needed = req.replyLength - req.replyReceived;
+            int used = (bytes < needed) ? bytes : needed;
+            req.replyReceived += used;
+            bytes -= used;
+        }
+        else
+        {
+            // Unknown reply length, consider it complete with the first bytes
+            bytes = 0;
+            req.replyReceived = req.replyLength;
+        }
+
+        if (req.replyReceived >= req.replyLength)
+        {
+            rttUpdate(getTime() - req.sentTime);
+            txPop();
+        }
+    }
+
+    return total;
+}
+
+void SerialPortNet::txPop()
+{
+    if (txCount > 0)
+    {
+        txHead = (txHead + 1) % NET_PIPELINE_DEPTH;
+        txCount--;
+    }
+}
+
+int SerialPortNet::rx(unsigned char *packet, int packetLength)
+{
+    int readStatus = -1;
+
+    if (isOpen() == true)
+    {
+        if (packet != nullptr && packetLength > 0)
+        {
+            if (rxRing.available() < static_cast<size_t>(packetLength))
+            {
+                rxRingFill();
+            }
+
+            readStatus = static_cast<int>(rxRing.read(packet, static_cast<size_t>(packetLength)));
+        }
+        else
+        {
+            TRACE_ERROR(SERIAL, "Cannot read from network link '%s': invalid packet buffer or size!", ttyDevicePath.c_str());
+        }
+    }
+    else
+    {
+        TRACE_ERROR(SERIAL, "Cannot read from network link '%s': invalid device!", ttyDevicePath.c_str());
+    }
+
+    return readStatus;
+}
+
+void SerialPortNet::flush()
+{
+    rxRing.clear();
+
+    if (isOpen() == true)
+    {
+        // Wait (for a bounded time) for the replies still in flight, so they
+        // can't be mistaken for the replies of the next requests
+        double deadline = getTime() + getRetransmissionTimeout();
+        while (txCount > 0)
+        {
+            double remaining = deadline - getTime();
+            struct pollfd pfd = {netSocket, POLLIN, 0};
+
+            if (remaining <= 0.0 ||
+                poll(&pfd, 1, static_cast<int>(std::ceil(remaining))) <= 0 ||
+                rxRingFill() <= 0)
+            {
+                break;
+            }
+            rxRing.clear();
+        }
+
+        // Drop everything left on the socket
+        unsigned char buf[256];
+        while (recv(netSocket, buf, sizeof(buf), 0) > 0);
+    }
+
+    rxRing.clear();
+    txCount = 0;
+}
+
+void SerialPortNet::rttUpdate(double sample)
+{
+    rttLast = sample;
+
+    if (rttSamples == 0)
+    {
+        rttSmoothed = sample;
+        rttVariance = sample / 2.0;
+    }
+    else
+    {
+        rttVariance = 0.75 * rttVariance + 0.25 * std::fabs(rttSmoothed - sample);
+        rttSmoothed = 0.875 * rttSmoothed + 0.125 * sample;
+    }
+
+    rttSamples++;
+    rtoBackoff = 1;
+}
+
+double SerialPortNet::getRoundTripTime() const
+{
+    return (rttSamples > 0) ? rttSmoothed : -1.0;
+}
+
+double SerialPortNet::getRoundTripTimeVariance() const
+{
+    return (rttSamples > 0) ? rttVariance : -1.0;
+}
+
+double SerialPortNet::getRetransmissionTimeout() const
+{
+    if (rttSamples == 0)
+    {
+        return 2.0 * static_cast<double>(ttyDeviceLatencyTime);
+    }
+
+    // Network round trip and its variation, backed off after each timeout
+    double rto = rttSmoothed + 4.0 * rttVariance;
+    if (rto < NET_MIN_RTO)
+    {
+        rto = NET_MIN_RTO;
+    }
+    if (rto < static_cast<double>(ttyDeviceLatencyTime))
+    {
+        rto = static_cast<double>(ttyDeviceLatencyTime);
+    }
+
+    return rto * static_cast<double>(rtoBackoff);
+}
+
+void SerialPortNet::setTimeOut(int packetLength)
+{
+    packetStartTime = getTime();
+
+    // The expected reply length of the last request sent
+    if (txCount > 0)
+    {
+        txPending[(txHead + txCount - 1) % NET_PIPELINE_DEPTH].replyLength = packetLength;
+    }
+
+    // Wire time on the remote bus, plus the network delays
+    packetWaitTime = byteTransfertTime * static_cast<double>(packetLength) + getRetransmissionTimeout();
+}
+
+void SerialPortNet::setTimeOut(double msec)
+{
+    packetStartTime = getTime();
+    packetWaitTime  = msec;
+}
+
+int SerialPortNet::checkTimeOut()
+{
+    int status = 0;
+    double time_elapsed = getTime() - packetStartTime;
+
+    if (time_elapsed > packetWaitTime)
+    {
+        status = 1;
+
+        // The request stays in flight: its late reply will be drained by flush()
+        if (rtoBackoff < 8)
+        {
+            rtoBackoff *= 2;
+        }
+    }
+    else if (time_elapsed < 0)
+    {
+        packetStartTime = getTime();
+    }
+
+    return status;
+}
+
+void SerialPortNet::txNoReply()
+{
+    // Forget the last request sent, so it doesn't take the bytes of the next replies
+    if (txCount > 0)
+    {
+        NetRequest &req = txPending[(txHead + txCount - 1) % NET_PIPELINE_DEPTH];
+        if (req.replyReceived == 0)
+        {
+            txCount--;
+        }
+    }
+}
+
+#endif // defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
@@ -0,0 +1,162 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file SerialPortNet.h
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef SERIALPORT_NET_H
+#define SERIALPORT_NET_H
+
+#include <string>
+
+/*!
+ * \brief Check if a device path designates a network serial bridge.
+ * \param devicePath: Device path (ex: "tcp://192.168.1.10:4001" or "udp://gateway:4001").
+ * \return True if the path uses a "tcp://" or "udp://" scheme.
+ */
+bool isNetworkDevicePath(const std::string &devicePath);
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+
+#include "SerialPort.h"
+#include "RingBuffer.h"
+
+/*!
+ * \brief Maximum number of requests in flight on a network link.
+ */
+#define NET_PIPELINE_DEPTH      (16)
+
+/*!
+ * \brief Minimum network part of a reception timeout, in milliseconds.
+ *
+ * The latency time of the link (see SerialPort::setLatency()) is also used as
+ * a floor, as the remote gateway has its own serial converter to go through.
+ */
+#define NET_MIN_RTO             (5.0)
+
+/*!
+ * \brief The SerialPortNet class, a serial link tunneled over TCP or UDP.
+ *
+ * Used to reach servo buses behind Ethernet to RS485/TTL gateways (ser2net-style),
+ * without going through a pty. The device path selects the transport:
+ * - "tcp://host:port": raw TCP stream, with TCP_NODELAY set.
+ * - "udp://host:port": raw UDP datagrams.
+ *
+ * tx() never waits for previous requests to be answered, so several requests
+ * can be pipelined across the network hop. Every reply is matched (in order)
+ * with its request to estimate the round trip time of the link, which is then
+ * used to compute reception timeouts instead of the serial latency time.
+ */
+class SerialPortNet: public SerialPort
+{
+    int netSocket;                  //!< Socket file descriptor.
+    bool netUdp;                    //!< True for UDP transport, false for TCP.
+    std::string netHost;            //!< Remote host name or address.
+    std::string netPort;            //!< Remote port.
+
+    RingBuffer rxRing;              //!< Bytes received from the socket, not yet consumed by rx().
+
+    /*!
+     * \brief A request sent on the link, waiting for its reply.
+     */
+    struct NetRequest
+    {
+        double sentTime;            //!< Emission time, in milliseconds.
+        int replyLength;            //!< Expected reply length (0 if unknown).
+        int replyReceived;          //!< Reply bytes received so far.
+    };
+
+    NetRequest txPending[NET_PIPELINE_DEPTH]; //!< Requests in flight (FIFO).
+    int txHead;                     //!< Oldest request in flight.
+    int txCount;                    //!< Number of requests in flight.
+
+    //! Remove the oldest request in flight.
+    void txPop();
+
+    double rttSmoothed;             //!< Smoothed round trip time, in milliseconds.
+    double rttVariance;             //!< Round trip time variation, in milliseconds.
+    double rttLast;                 //!< Last round trip time sample, in milliseconds.
+    unsigned rttSamples;            //!< Number of round trip time samples.
+    int rtoBackoff;                 //!< Timeout multiplier, doubled after each timeout and reset by the next reply.
+
+    /*!
+     * \brief Get current time from a monotonic clock.
+     * \return Current time in milliseconds.
+     */
+    double getTime();
+
+    void setBaudRate(const int baud);
+
+    /*!
+     * \brief Read everything pending on the socket into 'rxRing', and match the received bytes with the requests in flight.
+     * \return The number of bytes added to the ring, or -1 if the connection is broken.
+     */
+    int rxRingFill();
+
+    //! Add a round trip time sample, using RFC 6298 smoothing.
+    void rttUpdate(double sample);
+
+    //! Compute the network part of a reception timeout, in milliseconds.
+    double getRetransmissionTimeout() const;
+
+public:
+    /*!
+     * \brief SerialPortNet constructor will only init some variables to default values.
+     * \param devicePath: "tcp://host:port" or "udp://host:port".
+     * \param baud: Baud rate of the remote serial bus, used to estimate wire time.
+     * \param serialDevice: Specify (if known) what TTL converter is in use.
+     * \param servoDevices: Specify if we use this serial port with Dynamixel or HerkuleX devices.
+     */
+    SerialPortNet(std::string &devicePath, const int baud, const int serialDevice = SERIAL_UNKNOWN, const int servoDevices = SERVO_UNKNOWN);
+    ~SerialPortNet();
+
+    int openLink();
+    bool isOpen();
+    void closeLink();
+
+    int tx(unsigned char *packet, int packetLength);
+    int rx(unsigned char *packet, int packetLength);
+    void flush();
+
+    void setTimeOut(int packetLength);
+    void setTimeOut(double msec);
+    int checkTimeOut();
+    void txNoReply();
+
+    /*!
+     * \brief Get the smoothed round trip time of the network link.
+     * \return The round trip time in milliseconds, or -1 if no sample has been collected yet.
+     */
+    double getRoundTripTime() const;
+
+    /*!
+     * \brief Get the round trip time variation of the network link.
+     * \return The round trip time variation in milliseconds, or -1 if no sample has been collected yet.
+     */
+    double getRoundTripTimeVariance() const;
+
+    /*!
+     * \brief Get the number of requests sent but not answered yet.
+     */
+    int getRequestsInFlight() const { return txCount; }
+};
+
+#endif // defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+
+#endif // SERIALPORT_NET_H
@@ -0,0 +1,263 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file SerialPortReplay.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "SerialPortReplay.h"
+#include "PacketCapture.h"
+#include "minitraces.h"
+
+#include <cstdio>
+#include <cstring>
+
+/* ************************************************************************** */
+
+bool isReplayDevicePath(const std::string &devicePath)
+{
+    return (devicePath.compare(0, 9, "replay://") == 0);
+}
+
+SerialPortReplay::SerialPortReplay(std::string &devicePath, const int baud, const int serialDevice, const int servoDevices):
+    SerialPort(serialDevice, servoDevices)
+{
+    ttyDevicePath = devicePath;
+    captureFile = devicePath.substr(9);
+
+    size_t found = captureFile.rfind("?fast");
+    if (found != std::string::npos && found + 5 == captureFile.size())
+    {
+        captureFile = captureFile.substr(0, found);
+        fast = true;
+    }
+
+    found = captureFile.rfind("/");
+    ttyDeviceName = (found != std::string::npos) ? captureFile.substr(found + 1) : captureFile;
+
+    setBaudRate(baud);
+}
+
+SerialPortReplay::~SerialPortReplay()
+{
+    closeLink();
+}
+
+void SerialPortReplay::setBaudRate(const int baud)
+{
+    ttyDeviceBaudRate = checkBaudRate(baud);
+    byteTransfertTime = (1000.0 / static_cast<double>(ttyDeviceBaudRate)) * 10.0;
+}
+
+double SerialPortReplay::getTime()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool SerialPortReplay::loadCapture()
+{
+    std::FILE *f = std::fopen(captureFile.c_str(), "rb");
+    if (f == nullptr)
+    {
+        TRACE_ERROR(SERIAL, "Unable to open capture file '%s'", captureFile.c_str());
+        return false;
+    }
+
+    unsigned char header[CAPTURE_HEADER_SIZE];
+    if (std::fread(header, 1, sizeof(header), f) != sizeof(header) ||
+        std::memcmp(header, CAPTURE_MAGIC, 6) != 0 ||
+        header[6] != CAPTURE_VERSION)
+    {
+        TRACE_ERROR(SERIAL, "'%s' is not a valid capture file", captureFile.c_str());
+        std::fclose(f);
+        return false;
+    }
+
+    captureProtocol = header[7];
+    uint32_t baudrate = header[8] | (header[9] << 8) | (header[10] << 16) | (static_cast<uint32_t>(header[11]) << 24);
+    if (baudrate > 0)
+    {
+        setBaudRate(static_cast<int>(baudrate));
+    }
+
+    frames.clear();
+    uint64_t time = 0;
+    unsigned char record[CAPTURE_RECORD_HEADER_SIZE];
+
+    while (std::fread(record, 1, sizeof(record), f) == sizeof(record))
+    {
+        ReplayFrame frame;
+        uint32_t delta = record[0] | (record[1] << 8) | (record[2] << 16) | (static_cast<uint32_t>(record[3]) << 24);
+        uint16_t len16 = static_cast<uint16_t>(record[4] | (record[5] << 8));
+
+        time += delta;
+        frame.time = time;
+        frame.rx = (len16 & CAPTURE_RX) != 0;
+        frame.data.resize(len16 & CAPTURE_MAX_FRAME_LENGTH);
+
+        // A truncated last record is ignored
+        if (std::fread(frame.data.data(), 1, frame.data.size(), f) != frame.data.size())
+        {
+            break;
+        }
+
+        frames.push_back(std::move(frame));
+    }
+
+    std::fclose(f);
+
+    TRACE_INFO(SERIAL, "- Capture '%s' loaded: %zu frames, protocol %i, %i bps%s",
+               captureFile.c_str(), frames.size(), captureProtocol, ttyDeviceBaudRate, fast ? ", fast replay" : "");
+
+    return true;
+}
+
+int SerialPortReplay::openLink()
+{
+    closeLink();
+
+    if (loadCapture() == false)
+    {
+        return -2;
+    }
+
+    nextFrame = 0;
+    mismatchCount = 0;
+    pending.clear();
+    pendingOffset = 0;
+    opened = true;
+
+    return 1;
+}
+
+bool SerialPortReplay::isOpen()
+{
+    return opened;
+}
+
+void SerialPortReplay::closeLink()
+{
+    opened = false;
+    frames.clear();
+    pending.clear();
+    pendingOffset = 0;
+}
+
+int SerialPortReplay::tx(unsigned char *packet, int packetLength)
+{
+    if (isOpen() == false || packet == nullptr || packetLength <= 0)
+    {
+        TRACE_ERROR(SERIAL, "Cannot write to replay '%s': invalid device or packet!", captureFile.c_str());
+        return -1;
+    }
+
+    // Status bytes never read by the previous transaction are dropped
+    while (nextFrame < frames.size() && frames[nextFrame].rx)
+    {
+        nextFrame++;
+    }
+    pending.clear();
+    pendingOffset = 0;
+
+    txTime = std::chrono::steady_clock::now();
+
+    if (nextFrame < frames.size())
+    {
+        const ReplayFrame &frame = frames[nextFrame++];
+        txFrameTime = frame.time;
+
+        if (frame.data.size() != static_cast<size_t>(packetLength) ||
+            std::memcmp(frame.data.data(), packet, frame.data.size()) != 0)
+        {
+            mismatchCount++;
+        }
+    }
+    else
+    {
+        mismatchCount++;
+    }
+
+    return packetLength;
+}
+
+void SerialPortReplay::replayFrames()
+{
+    uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - txTime).count());
+
+    while (nextFrame < frames.size() && frames[nextFrame].rx &&
+           (fast || frames[nextFrame].time - txFrameTime <= elapsed))
+    {
+        const ReplayFrame &frame = frames[nextFrame++];
+        pending.insert(pending.end(), frame.data.begin(), frame.data.end());
+    }
+}
+
+int SerialPortReplay::rx(unsigned char *packet, int packetLength)
+{
+    if (isOpen() == false || packet == nullptr || packetLength <= 0)
+    {
+        TRACE_ERROR(SERIAL, "Cannot read from replay '%s': invalid device or packet!", captureFile.c_str());
+        return -1;
+    }
+
+    replayFrames();
+
+    size_t len = pending.size() - pendingOffset;
+    if (len > static_cast<size_t>(packetLength))
+    {
+        len = static_cast<size_t>(packetLength);
+    }
+
+    if (len > 0)
+    {
+        std::memcpy(packet, pending.data() + pendingOffset, len);
+        pendingOffset += len;
+    }
+
+    return static_cast<int>(len);
+}
+
+void SerialPortReplay::flush()
+{
+    pending.clear();
+    pendingOffset = 0;
+}
+
+void SerialPortReplay::setTimeOut(int packetLength)
+{
+    packetStartTime = getTime();
+    packetWaitTime = (byteTransfertTime * static_cast<double>(packetLength)) + (2.0 * static_cast<double>(ttyDeviceLatencyTime));
+}
+
+void SerialPortReplay::setTimeOut(double msec)
+{
+    packetStartTime = getTime();
+    packetWaitTime = msec;
+}
+
+int SerialPortReplay::checkTimeOut()
+{
+    // Fast replay: nothing left to receive for this transaction means a timeout
+    if (fast)
+    {
+        replayFrames();
+        return (pendingOffset >= pending.size()) ? 1 : 0;
+    }
+
+    return ((getTime() - packetStartTime) > packetWaitTime) ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file SerialPortReplay.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef SERIALPORT_REPLAY_H
+#define SERIALPORT_REPLAY_H
+
+#include "SerialPort.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+/*!
+ * \brief Check if a device path designates a capture file to replay.
+ * \param devicePath: Device path (ex: "replay:///tmp/bus.ssfcap" or "replay:///tmp/bus.ssfcap?fast").
+ * \return True if the path uses a "replay://" scheme.
+ */
+bool isReplayDevicePath(const std::string &devicePath);
+
+/*!
+ * \brief The SerialPortReplay class, feeding a packet capture back into a protocol instance.
+ *
+ * Opened with a "replay://<capture file>" device path, it plays the devices side
+ * of a capture recorded by PacketCapture: every instruction packet sent with tx()
+ * is matched with the next instruction packet of the capture, and the status
+ * bytes that followed it in the capture are then returned by rx().
+ *
+ * By default the status bytes become available with their original timing
+ * (relative to the instruction packet). With a "?fast" suffix, they are available
+ * immediately and missing replies time out immediately, to profile the protocol
+ * and controller code as fast as possible.
+ *
+ * Instruction packets that don't match the capture are counted (see
+ * getMismatchCount()), the replay goes on anyway.
+ */
+class SerialPortReplay: public SerialPort
+{
+    /*!
+     * \brief A frame of the capture.
+     */
+    struct ReplayFrame
+    {
+        uint64_t time;                      //!< Time since the beginning of the capture, in microseconds.
+        bool rx;                            //!< Status bytes (true) or instruction packet (false).
+        std::vector <unsigned char> data;
+    };
+
+    std::string captureFile;                //!< Path of the capture file.
+    bool fast = false;                      //!< Replay as fast as possible, ignoring the original timing.
+    bool opened = false;
+
+    int captureProtocol = 0;                //!< Protocol saved in the capture header.
+    std::vector <ReplayFrame> frames;       //!< Content of the capture.
+    size_t nextFrame = 0;                   //!< Next frame to be replayed.
+    unsigned mismatchCount = 0;             //!< Instruction packets not matching the capture.
+
+    std::chrono::steady_clock::time_point txTime; //!< When the last instruction packet has been sent.
+    uint64_t txFrameTime = 0;               //!< Capture time of the matching instruction packet.
+    std::vector <unsigned char> pending;    //!< Status bytes available to rx().
+    size_t pendingOffset = 0;
+
+    double getTime();
+    void setBaudRate(const int baud);
+
+    //! Load the capture file into 'frames'.
+    bool loadCapture();
+
+    //! Move the status bytes due by now into 'pending'.
+    void replayFrames();
+
+public:
+    /*!
+     * \brief SerialPortReplay constructor.
+     * \param devicePath: "replay://<capture file>", with an optional "?fast" suffix.
+     * \param baud: Baud rate used to compute timeouts. The capture baud rate is used instead if available.
+     * \param serialDevice: Specify (if known) what TTL converter is in use.
+     * \param servoDevices: Specify if we use this serial port with Dynamixel or HerkuleX devices.
+     */
+    SerialPortReplay(std::string &devicePath, const int baud, const int serialDevice = SERIAL_UNKNOWN, const int servoDevices = SERVO_UNKNOWN);
+    ~SerialPortReplay();
+
+    int openLink();
+    bool isOpen();
+    void closeLink();
+
+    int tx(unsigned char *packet, int packetLength);
+    int rx(unsigned char *packet, int packetLength);
+    void flush();
+
+    void setTimeOut(int packetLength);
+    void setTimeOut(double msec);
+    int checkTimeOut();
+
+    //! Number of instruction packets that didn't match the capture.
+    unsigned getMismatchCount() const { return mismatchCount; }
+
+    //! True when every frame of the capture has been replayed.
+    bool isFinished() const { return nextFrame >= frames.size(); }
+};
+
+#endif // SERIALPORT_REPLAY_H
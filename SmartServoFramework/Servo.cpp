@@ -31,7 +31,10 @@
 
 Servo::Servo()
 {
-    //
+    for (auto &c: registerTableCycles)
+    {
+        c = 0;
+    }
 }
 
 Servo::~Servo()
@@ -41,12 +44,22 @@ Servo::~Servo()
         delete [] registerTableValues;
         registerTableValues = nullptr;
     }
+}
 
-    if (registerTableCommits != nullptr)
-    {
-        delete [] registerTableCommits;
-        registerTableCommits = nullptr;
-    }
+/* ************************************************************************** */
+
+Servo::TableWriteLock::TableWriteLock(Servo &s):
+    servo(s)
+{
+    servo.access.lock();
+    servo.registerTableSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+Servo::TableWriteLock::~TableWriteLock()
+{
+    servo.registerTableSequence.fetch_add(1, std::memory_order_release);
+    servo.access.unlock();
 }
 
 /* ************************************************************************** */
@@ -83,7 +96,6 @@ int Servo::gaddr(const int reg, const int reg_mode)
 
 int Servo::getStatus()
 {
-    std::lock_guard <std::mutex> lock(access);
     return statusDetail;
 }
 
@@ -91,6 +103,7 @@ void Servo::setStatus(const int status)
 {
     std::lock_guard <std::mutex> lock(access);
     statusDetail = status;
+    statusUpdated = 1;
 }
 
 int Servo::getError()
@@ -197,7 +210,7 @@ void Servo::status()
     TRACE_INFO(SERVO, "Basic status(#%i)", servoId);
 
     TRACE_INFO(SERVO, "> model      : %i", servoModel);
-    TRACE_INFO(SERVO, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)]);
+    TRACE_INFO(SERVO, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)].load());
 }
 
 int Servo::getDeviceBrand()
@@ -243,31 +256,26 @@ int Servo::getId()
 
 int Servo::getModelNumber()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MODEL_NUMBER)];
 }
 
 int Servo::getFirmwareVersion()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_FIRMWARE_VERSION)];
 }
 
 int Servo::getBaudNum()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_BAUD_RATE)];
 }
 
 int Servo::getCwAngleLimit()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MIN_POSITION)];
 }
 
 int Servo::getCcwAngleLimit()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MAX_POSITION)];
 }
 
@@ -285,55 +293,46 @@ int Servo::getRunningDegrees()
 
 int Servo::getMaxTorque()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MAX_TORQUE)];
 }
 
 int Servo::getStatusReturnLevel()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_STATUS_RETURN_LEVEL)];
 }
 
 int Servo::getAlarmLed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_ALARM_LED)];
 }
 
 int Servo::getAlarmShutdown()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_ALARM_SHUTDOWN)];
 }
 
 int Servo::getTorqueEnabled()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_TORQUE_ENABLE)];
 }
 
 int Servo::getLed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_LED)];
 }
 
 int Servo::getCurrentPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_POSITION)];
 }
 
 int Servo::getCurrentSpeed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_SPEED)];
 }
 
 int Servo::getCurrentLoad()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_LOAD)];
 }
 
@@ -345,11 +344,11 @@ void Servo::setId(int id)
 
     if (id > -1 && id < 254)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Maybe check if new ID is not already in use ?
         registerTableValues[gid(REG_ID)] = id;
-        registerTableCommits[gid(REG_ID)] = 1;
+        markCommit(registerTableCommits, gid(REG_ID));
     }
 }
 
@@ -359,10 +358,10 @@ void Servo::setCWLimit(int limit)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MIN_POSITION)] = limit;
-        registerTableCommits[gid(REG_MIN_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MIN_POSITION));
     }
 }
 
@@ -372,10 +371,10 @@ void Servo::setCCWLimit(int limit)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MAX_POSITION)] = limit;
-        registerTableCommits[gid(REG_MAX_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MAX_POSITION));
     }
 }
 
@@ -391,8 +390,6 @@ int Servo::getValue(int reg_name, int reg_type)
     {
         if (infos.reg_index >= 0)
         {
-            std::lock_guard <std::mutex> lock(access);
-
             // Get value
             value = registerTableValues[infos.reg_index];
         }
@@ -411,6 +408,32 @@ int Servo::getValue(int reg_name, int reg_type)
     return value;
 }
 
+void Servo::getValues(const int *reg_names, int *values, const int count, const int reg_type)
+{
+    for (;;)
+    {
+        uint32_t sequence = registerTableSequence.load(std::memory_order_acquire);
+
+        if (sequence & 1)
+        {
+            // A writer is in the middle of a modification
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            values[i] = getValue(reg_names[i], reg_type);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (registerTableSequence.load(std::memory_order_relaxed) == sequence)
+        {
+            return;
+        }
+    }
+}
+
 int Servo::getValueCommit(int reg_name, int reg_type)
 {
     int commit = -1;
@@ -421,10 +444,8 @@ int Servo::getValueCommit(int reg_name, int reg_type)
     {
         if (infos.reg_index >= 0)
         {
-            std::lock_guard <std::mutex> lock(access);
-
             // Get value
-            commit = registerTableCommits[infos.reg_index];
+            commit = static_cast<int>((registerTableCommits.load() >> infos.reg_index) & 1);
         }
         else
         {
@@ -457,11 +478,11 @@ void Servo::setValue(int reg_name, int reg_value, int reg_type)
                 // Check value
                 if (reg_value >= infos.reg_value_min && reg_value <= infos.reg_value_max)
                 {
-                    std::lock_guard <std::mutex> lock(access);
+                    TableWriteLock lock(*this);
 
                     // Set value
                     registerTableValues[infos.reg_index] = reg_value;
-                    registerTableCommits[infos.reg_index] = 1;
+                    markCommit(registerTableCommits, infos.reg_index);
                 }
                 else
                 {
@@ -490,6 +511,22 @@ void Servo::setValue(int reg_name, int reg_value, int reg_type)
 }
 
 void Servo::updateValue(int reg_name, int reg_value, int reg_type)
+{
+    TableWriteLock lock(*this);
+    updateValue_internal(reg_name, reg_value, reg_type);
+}
+
+void Servo::updateValues(const int *reg_names, const int *values, const int count, const int reg_type)
+{
+    TableWriteLock lock(*this);
+
+    for (int i = 0; i < count; i++)
+    {
+        updateValue_internal(reg_names[i], values[i], reg_type);
+    }
+}
+
+void Servo::updateValue_internal(int reg_name, int reg_value, int reg_type)
 {
     // Find register's informations (addr, size...)
     RegisterInfos infos = {-1, -1, -1, -1, -1, -1, -1, -1, -1};
@@ -500,10 +537,9 @@ void Servo::updateValue(int reg_name, int reg_value, int reg_type)
             // Check value
             if (reg_value >= infos.reg_value_min && reg_value <= infos.reg_value_max)
             {
-                std::lock_guard <std::mutex> lock(access);
-
                 // Update value
                 registerTableValues[infos.reg_index] = reg_value;
+                markCommit(registerTableUpdates, infos.reg_index);
             }
             else
             {
@@ -550,7 +586,7 @@ void Servo::commitValue(int reg_name, int commit, int reg_type)
                 std::lock_guard <std::mutex> lock(access);
 
                 // Set value
-                registerTableCommits[infos.reg_index] = commit;
+                markCommit(registerTableCommits, infos.reg_index, commit);
             }
             else
             {
@@ -572,3 +608,167 @@ void Servo::commitValue(int reg_name, int commit, int reg_type)
 }
 
 /* ************************************************************************** */
+
+void Servo::markCommit(std::atomic <uint64_t> &commits, const int reg_index, const int commit)
+{
+    if (reg_index >= 0 && reg_index < 64)
+    {
+        if (commit)
+        {
+            commits.fetch_or(1ULL << reg_index);
+        }
+        else
+        {
+            commits.fetch_and(~(1ULL << reg_index));
+        }
+    }
+}
+
+uint64_t Servo::takeCommits(int reg_type)
+{
+    uint64_t commits = registerTableCommits.exchange(0);
+    if (commits)
+    {
+        commandsSent = 1;
+    }
+
+    return commits;
+}
+
+void Servo::restoreCommits(const uint64_t commits, int reg_type)
+{
+    registerTableCommits.fetch_or(commits);
+}
+
+bool Servo::hasPendingCommits()
+{
+    return registerTableCommits != 0;
+}
+
+/* ************************************************************************** */
+
+void Servo::stampCycle(const uint64_t cycle)
+{
+    uint64_t updates = registerTableUpdates.exchange(0);
+    while (updates)
+    {
+        int index = getFirstCommit(updates);
+        updates &= updates - 1;
+
+        registerTableCycles[index] = cycle;
+    }
+
+    if (statusUpdated.exchange(0))
+    {
+        statusCycle = cycle;
+    }
+
+    if (commandsSent.exchange(0))
+    {
+        commandCycle = cycle;
+    }
+}
+
+uint64_t Servo::getFeedbackCycle(const int reg)
+{
+    // Not gid(), registers missing from the control table must not fall back to the first one
+    int index = getRegisterTableIndex(ct, reg);
+    if (index < 0 || index >= 64)
+    {
+        return 0;
+    }
+
+    return registerTableCycles[index];
+}
+
+uint64_t Servo::getStatusCycle()
+{
+    return statusCycle;
+}
+
+uint64_t Servo::getCommandCycle()
+{
+    return commandCycle;
+}
+
+uint64_t Servo::getPositionCycle()
+{
+    return getFeedbackCycle(REG_CURRENT_POSITION);
+}
+
+uint64_t Servo::getMovingCycle()
+{
+    return getFeedbackCycle(REG_MOVING);
+}
+
+/* ************************************************************************** */
+
+bool Servo::enableHistory(const std::vector <int> &registers, const int capacity)
+{
+    if (registers.empty() || registers.size() > FEEDBACK_HISTORY_MAX_REGISTERS || capacity < 1)
+    {
+        TRACE_ERROR(SERVO, "[#%i] enableHistory(%i registers, %i samples) [VALUE ERROR]",
+                    servoId, static_cast<int>(registers.size()), capacity);
+        return false;
+    }
+
+    for (auto reg: registers)
+    {
+        RegisterInfos infos = {-1, -1, -1, -1, -1, -1, -1, -1, -1};
+        if (getRegisterInfos(ct, reg, infos) != 1)
+        {
+            TRACE_ERROR(SERVO, "[#%i] enableHistory(reg %i / %s) [REGISTER NAME ERROR]",
+                        servoId, reg, getRegisterNameTxt(reg).c_str());
+            return false;
+        }
+    }
+
+    std::atomic_store(&history, std::make_shared <FeedbackHistory>(registers, capacity));
+
+    return true;
+}
+
+void Servo::disableHistory()
+{
+    std::atomic_store(&history, std::shared_ptr <FeedbackHistory>());
+}
+
+std::shared_ptr <const FeedbackHistory> Servo::getHistory() const
+{
+    return std::atomic_load(&history);
+}
+
+size_t Servo::readHistory(FeedbackSample *samples, const size_t count) const
+{
+    std::shared_ptr <FeedbackHistory> h = std::atomic_load(&history);
+
+    return h ? h->read(samples, count) : 0;
+}
+
+void Servo::recordHistory(const uint64_t cycle, const std::chrono::steady_clock::time_point time)
+{
+    std::shared_ptr <FeedbackHistory> h = std::atomic_load(&history);
+
+    if (h)
+    {
+        int values[FEEDBACK_HISTORY_MAX_REGISTERS];
+        unsigned updated = 0;
+        const std::vector <int> &regs = h->getRegisters();
+
+        for (size_t i = 0; i < regs.size(); i++)
+        {
+            values[i] = getValue(regs[i]);
+
+            if (getFeedbackCycle(regs[i]) == cycle)
+            {
+                updated |= (1u << i);
+            }
+        }
+
+        // Nothing new from the device during this cycle
+        if (updated)
+        {
+            h->push(cycle, time, values, updated);
+        }
+    }
+}
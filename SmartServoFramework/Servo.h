@@ -24,10 +24,20 @@
 #define SERVO_H
 
 #include "ControlTables.h"
+#include "FeedbackHistory.h"
 
 #include <string>
 #include <map>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 /** \addtogroup ManagedAPIs
  *  @{
@@ -44,6 +54,22 @@ enum SpeedMode_e {
     SPEED_AUTO   = 1
 };
 
+/*!
+ * \brief Index of the lowest bit set into a commit bitmap.
+ * \param commits: Commit bitmap, must not be 0.
+ * \return The register table index of the first pending commit.
+ */
+inline int getFirstCommit(const uint64_t commits)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, commits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(commits);
+#endif
+}
+
 /*!
  * \brief The "Servo" device base class.
  */
@@ -55,8 +81,37 @@ protected:
     const int (*ct)[8] = nullptr;   //!< Pointer to the control table for a given servo class (selected by the constructor)
 
     int registerTableSize = 0;      //!< Number of register in the servo control table
-    int *registerTableValues = nullptr;
-    int *registerTableCommits = nullptr;
+    std::atomic <int> *registerTableValues = nullptr; //!< Register values, readable without locking 'access'
+    std::atomic <uint32_t> registerTableSequence {0}; //!< Register table seqlock sequence, odd while the table is being modified
+    std::atomic <uint64_t> registerTableCommits {0}; //!< Bitmap of the registers (by table index) with a modification to commit
+    std::atomic <uint64_t> registerTableUpdates {0}; //!< Bitmap of the registers (by table index) read from the device since the last stampCycle()
+    std::atomic <uint64_t> registerTableCycles[64];  //!< Cycle in which each register (by table index) was last read from the device
+    std::atomic <int> statusUpdated {0};            //!< Set when a status is received from the device, until the next stampCycle()
+    std::atomic <uint64_t> statusCycle {0};         //!< Cycle in which a status was last received from the device
+    std::atomic <int> commandsSent {0};             //!< Set when modifications are sent to the device, until the next stampCycle()
+    std::atomic <uint64_t> commandCycle {0};        //!< Cycle in which modifications were last sent to the device
+
+    /*!
+     * \brief Writer side of the register table seqlock.
+     *
+     * Serialize the writers with 'access', and keep the sequence odd while the
+     * table is being modified. Readers never take 'access': they read the
+     * (atomic) values directly, or use getValues() to read several registers
+     * consistently.
+     */
+    class TableWriteLock
+    {
+        Servo &servo;
+    public:
+        explicit TableWriteLock(Servo &s);
+        ~TableWriteLock();
+    };
+
+    //! Set or clear the bit of a register (by table index) into a commit bitmap.
+    static void markCommit(std::atomic <uint64_t> &commits, const int reg_index, const int commit = 1);
+
+    //! Update a register value read from the device. The caller must hold a TableWriteLock.
+    virtual void updateValue_internal(const int reg_name, int reg_value, int reg_type);
 
     int servoId = 0;
     int servoModel = 0;
@@ -67,10 +122,12 @@ protected:
 
     int commError = 0;              //!< Error code from the serial link (when communicating with this particular device)
     int statusError = 0;            //!< Error bitfield from the device
-    int statusDetail = 0;           //!< Additional status bitfield from the device (only available on HerkuleX devices)
+    std::atomic <int> statusDetail {0}; //!< Additional status bitfield from the device (only available on HerkuleX devices)
     int valueErrors = 0;            //!< Register value boundaries error count
     int errorCount = 0;             //!< Global error count
 
+    std::shared_ptr <FeedbackHistory> history; //!< Optional feedback history. Only accessed through std::atomic_load() / std::atomic_store().
+
     int actionProgrammed = 0;
     int rebootProgrammed = 0;
     int refreshProgrammed = 0;
@@ -139,9 +196,9 @@ public:
     virtual int getGoalPosition() = 0;
     virtual int getMovingSpeed() = 0;
 
-    int getCurrentPosition();
-    int getCurrentSpeed();
-    int getCurrentLoad();
+    virtual int getCurrentPosition();
+    virtual int getCurrentSpeed();
+    virtual int getCurrentLoad();
     virtual double getCurrentVoltage() = 0;
     virtual double getCurrentTemperature() = 0;
     virtual int getMoving() = 0;
@@ -159,9 +216,98 @@ public:
     virtual int getValue(const int reg_reg, int reg_type = REGISTER_AUTO);
     virtual int getValueCommit(const int reg_reg, int reg_type = REGISTER_AUTO);
 
+    /*!
+     * \brief Read several register values at once, all from the same version of the register table.
+     * \param reg_names: Register names.
+     * \param values: Where to store the values, 'count' of them.
+     * \param count: Number of registers to read.
+     * \param reg_type: Register type, for devices with ROM and RAM copies of the same register.
+     *
+     * Never blocks a writer (ex: the controller's thread): if the table is
+     * modified during the read, the read is simply retried.
+     */
+    void getValues(const int *reg_names, int *values, const int count, const int reg_type = REGISTER_AUTO);
+
     virtual void setValue(const int reg_reg, int reg_value, int reg_type = REGISTER_AUTO);
     virtual void updateValue(const int reg_reg, int reg_value, int reg_type = REGISTER_AUTO);
+
+    /*!
+     * \brief Update several register values read from the device, as one modification of the register table.
+     * \param reg_names: Register names.
+     * \param values: Values read from the device, 'count' of them.
+     * \param count: Number of registers to update.
+     * \param reg_type: Register type, for devices with ROM and RAM copies of the same register.
+     *
+     * Used by the controllers to publish the feedback of a device in one go:
+     * getValues() never returns some of these values without the others.
+     */
+    void updateValues(const int *reg_names, const int *values, const int count, const int reg_type = REGISTER_AUTO);
     virtual void commitValue(const int reg_reg, int commit, int reg_type = REGISTER_AUTO);
+
+    // Commits (used by controllers)
+    virtual uint64_t takeCommits(int reg_type = REGISTER_AUTO);
+    virtual void restoreCommits(const uint64_t commits, int reg_type = REGISTER_AUTO);
+    virtual bool hasPendingCommits();
+
+    // Feedback freshness
+    /*!
+     * \brief Turn the reads, status and writes since the last call into cycle stamps (used by controllers, once per cycle).
+     * \param cycle: The synchronization cycle being published.
+     */
+    void stampCycle(const uint64_t cycle);
+
+    /*!
+     * \brief Get the cycle in which a register was last read from the device.
+     * \param reg: Register name.
+     * \return A cycle number, 0 if the register has never been read.
+     */
+    uint64_t getFeedbackCycle(const int reg);
+
+    //! Get the cycle in which a status was last received from the device, 0 if never.
+    uint64_t getStatusCycle();
+
+    //! Get the cycle in which register modifications were last sent to the device, 0 if never.
+    uint64_t getCommandCycle();
+
+    //! Get the cycle in which the register behind getCurrentPosition() was last read.
+    virtual uint64_t getPositionCycle();
+
+    //! Get the cycle in which the information behind getMoving() was last received.
+    virtual uint64_t getMovingCycle();
+
+    // Feedback history
+    /*!
+     * \brief Keep a history of the values of some registers, one sample per synchronization cycle reading them.
+     * \param registers: Register names to record (up to FEEDBACK_HISTORY_MAX_REGISTERS).
+     * \param capacity: Number of samples to keep.
+     * \return True if the history has been enabled.
+     *
+     * Samples are recorded by the controller's thread, once the feedback of a
+     * cycle has landed, so the registers must be read by the controller (see
+     * ServoController::setPollingRate()). Cycles during which none of them has
+     * been read don't add a sample, and FeedbackSample::updated tells which
+     * values of a sample are fresh. Enabling the history again replaces the
+     * previous one.
+     */
+    bool enableHistory(const std::vector <int> &registers, const int capacity);
+    void disableHistory();
+
+    /*!
+     * \brief Get the feedback history, if enabled.
+     * \return The history, or nullptr. It stays valid as long as the caller holds it, even if the history is disabled.
+     */
+    std::shared_ptr <const FeedbackHistory> getHistory() const;
+
+    /*!
+     * \brief Copy the most recent samples of the feedback history, without locking.
+     * \param samples: Where to copy the samples, oldest first.
+     * \param count: Maximum number of samples to copy.
+     * \return The number of samples copied (0 if the history isn't enabled).
+     */
+    size_t readHistory(FeedbackSample *samples, const size_t count) const;
+
+    //! Record a sample of the current register values into the history, if enabled and if one of them has been read during 'cycle' (used by controllers, after stampCycle()).
+    void recordHistory(const uint64_t cycle, const std::chrono::steady_clock::time_point time);
 };
 
 /** @}*/
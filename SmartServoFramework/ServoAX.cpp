@@ -44,24 +44,20 @@ ServoAX::~ServoAX()
 
 int ServoAX::getCwComplianceMargin()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CW_COMPLIANCE_MARGIN)];
 }
 
 int ServoAX::getCcwComplianceMargin()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CCW_COMPLIANCE_MARGIN)];
 }
 
 int ServoAX::getCwComplianceSlope()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CW_COMPLIANCE_SLOPE)];
 }
 
 int ServoAX::getCcwComplianceSlope()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CCW_COMPLIANCE_SLOPE)];
 }
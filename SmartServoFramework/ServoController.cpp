@@ -21,21 +21,34 @@
  */
 
 #include "ServoController.h"
+#include "ControllerGroup.h"
 #include "minitraces.h"
 
 // C standard library
 #include <cstring>
 #include <cstdio>
+#include <cerrno>
+
+// Real-time scheduling and cycle notifications
+#if defined(__linux__) || defined(__gnu_linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
 // C++ standard libraries
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
 /* ************************************************************************** */
 
 ServoController::ServoController(int ctrlFrequency)
 {
-    if (ctrlFrequency < 1 || ctrlFrequency > 120)
+    if (ctrlFrequency < 1 || ctrlFrequency > SYNCLOOP_MAX_FREQUENCY)
     {
         syncloopFrequency = 30;
         syncloopDuration = 1000.0 / 30.0;
@@ -45,11 +58,24 @@ ServoController::ServoController(int ctrlFrequency)
         syncloopFrequency = ctrlFrequency;
         syncloopDuration = 1000.0 / static_cast<double>(ctrlFrequency);
     }
+    // No device yet
+    servoSnapshot = std::make_shared <const ServoSnapshot>();
 }
 
 ServoController::~ServoController()
 {
-    //
+    ControllerGroup *group = syncloopGroup;
+    if (group)
+    {
+        group->removeController(this);
+    }
+
+#if defined(__linux__) || defined(__gnu_linux__)
+    if (cycleEventFd >= 0)
+    {
+        close(cycleEventFd);
+    }
+#endif
 }
 
 /* ************************************************************************** */
@@ -60,7 +86,9 @@ void ServoController::startThread()
     {
         clearErrorCount();
         setState(state_started);
+        syncloopDeadline = std::chrono::steady_clock::time_point();
         syncloopThread = std::thread(&ServoController::run, this);
+        applyThreadSettings();
     }
 }
 
@@ -85,7 +113,9 @@ void ServoController::pauseThread()
         TRACE_INFO(MAPI, ">> Unpausing thread (id: %i)...", syncloopThread.get_id());
 
         setState(state_ready);
+        syncloopDeadline = std::chrono::steady_clock::time_point();
         syncloopThread = std::thread(&ServoController::run, this);
+        applyThreadSettings();
     }
     else
     {
@@ -112,7 +142,13 @@ void ServoController::stopThread()
         unregisterServos_internal();
         clearMessageQueue();
         clearErrorCount();
-        setState(state_stopped);
+        // Wake up the threads waiting for a cycle that will never come. The
+        // state changes under the waiters' lock, so none of them can miss it.
+        {
+            std::lock_guard <std::mutex> lock(feedbackCycleLock);
+            setState(state_stopped);
+        }
+        feedbackCycleCondition.notify_all();
     }
 }
 
@@ -169,7 +205,7 @@ bool ServoController::waitUntil(int state, int timeout)
     }
 
     // If we do have results after the scan, we want to wait for every device to be properly read
-    if (getServos().size() > 0)
+    if (getServoSnapshot()->servos.empty() == false)
     {
         // Wait until the controller is in 'ready' state
         while (getState() < state)
@@ -195,6 +231,783 @@ void ServoController::updateErrorCount(int error)
     errorCount += error;
 }
 
+LatencyStats ServoController::getSyncLoopLatency()
+{
+    return syncloopHistogram.getStats();
+}
+
+void ServoController::setPollingRate(const std::vector <int> &registers, const double rate, const std::vector <int> &ids)
+{
+    std::lock_guard <std::mutex> lock(pollingLock);
+
+    PollingRate p;
+    p.registers = registers;
+    p.rate = (rate > 0.0) ? rate : 0.0;
+    p.ids = ids;
+    std::sort(p.registers.begin(), p.registers.end());
+    std::sort(p.ids.begin(), p.ids.end());
+
+    // A new rate for the same registers and devices replaces the previous one (the last rate set wins)
+    pollingRates.erase(std::remove_if(pollingRates.begin(), pollingRates.end(),
+                                      [&p](const PollingRate &r) { return r.registers == p.registers && r.ids == p.ids; }),
+                       pollingRates.end());
+
+    pollingRates.push_back(p);
+    pollingChanged = true;
+}
+
+void ServoController::resetPollingRates()
+{
+    {
+        std::lock_guard <std::mutex> lock(pollingLock);
+        pollingRates.clear();
+    }
+
+    setDefaultPollingRates();
+}
+
+void ServoController::updatePollingSchedule()
+{
+    std::lock_guard <std::mutex> lock(pollingLock);
+
+    if (pollingChanged)
+    {
+        pollingActive = pollingRates;
+        pollingSchedule.clear();
+        pollingChanged = false;
+    }
+}
+
+int ServoController::getDueRegisters(const int id, int *registers, int *priorities, const int max)
+{
+    std::map <int, std::vector <PollingSlot>>::iterator it = pollingSchedule.find(id);
+
+    if (it == pollingSchedule.end())
+    {
+        // Effective rate of every register declared, for this device
+        std::map <int, double> rates;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (const PollingRate &p: pollingActive)
+            {
+                bool concerned = (pass == 0) ? p.ids.empty() : (std::find(p.ids.begin(), p.ids.end(), id) != p.ids.end());
+                if (concerned)
+                {
+                    for (auto reg: p.registers)
+                    {
+                        rates[reg] = p.rate;
+                    }
+                }
+            }
+        }
+
+        // Devices are shifted by a golden ratio fraction of the period, so their reads spread evenly
+        double phase = std::fmod(static_cast<double>(id) * 0.618033988749895, 1.0);
+
+        std::vector <PollingSlot> slots;
+        for (auto &r: rates)
+        {
+            if (r.second > 0.0)
+            {
+                PollingSlot slot;
+                slot.reg = r.first;
+                slot.period = std::max(1.0, static_cast<double>(syncloopFrequency) / r.second);
+                slot.next = static_cast<double>(syncloopCounter) + std::floor(phase * slot.period);
+                slot.pending = false;
+                slot.deferred = 0;
+                slots.push_back(slot);
+            }
+        }
+
+        it = pollingSchedule.insert(std::make_pair(id, slots)).first;
+    }
+
+    int count = 0;
+    double now = static_cast<double>(syncloopCounter);
+
+    for (PollingSlot &slot: it->second)
+    {
+        bool due = slot.pending;
+
+        if (slot.next <= now)
+        {
+            due = true;
+
+            // A scheduled read clears the deferral history of the previous one
+            if (slot.pending == false)
+            {
+                slot.deferred = 0;
+            }
+
+            slot.next += slot.period;
+            if (slot.next <= now)
+            {
+                // Loops have been skipped, don't try to catch up
+                slot.next = now + slot.period;
+            }
+        }
+
+        if (due && count < max)
+        {
+            registers[count] = slot.reg;
+            if (priorities != nullptr)
+            {
+                priorities[count] = (slot.deferred >= POLLING_STARVATION_LIMIT) ?
+                                    std::min(static_cast<int>(PRIORITY_POSITION), getRegisterPriority(slot.reg)) :
+                                    getRegisterPriority(slot.reg);
+            }
+            count++;
+        }
+
+        slot.pending = false;
+    }
+
+    return count;
+}
+
+void ServoController::deferRegister(const int id, const int reg)
+{
+    std::map <int, std::vector <PollingSlot>>::iterator it = pollingSchedule.find(id);
+
+    if (it != pollingSchedule.end())
+    {
+        for (PollingSlot &slot: it->second)
+        {
+            if (slot.reg == reg)
+            {
+                slot.pending = true;
+                slot.deferred++;
+                deferredReads++;
+                break;
+            }
+        }
+    }
+}
+
+int ServoController::getRegisterPriority(const int reg)
+{
+    switch (reg)
+    {
+    case REG_CURRENT_POSITION:
+    case REG_ABSOLUTE_POSITION:
+    case REG_ABSOLUTE_GOAL_POSITION:
+        return PRIORITY_POSITION;
+
+    case REG_CURRENT_SPEED:
+    case REG_CURRENT_LOAD:
+    case REG_DIFFERENTIAL_POSITION:
+    case REG_PWM:
+    case REG_MOVING:
+        return PRIORITY_TELEMETRY;
+
+    default:
+        return PRIORITY_DIAGNOSTIC;
+    }
+}
+
+double ServoController::getRemainingBudget()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(syncloopDeadline - std::chrono::steady_clock::now()).count();
+}
+
+double ServoController::estimateCost(const int bytes, const int transactions)
+{
+    return (bytes * syncloopByteTime) + (transactions * syncloopOverhead);
+}
+
+void ServoController::updateCostModel(const double duration, const int bytes, const int transactions)
+{
+    if (transactions > 0)
+    {
+        double overhead = (duration - (bytes * syncloopByteTime)) / transactions;
+        if (overhead < 0.0)
+        {
+            overhead = 0.0;
+        }
+
+        // Exponential moving average, so a single timeout doesn't flush the whole history
+        syncloopOverhead += 0.2 * (overhead - syncloopOverhead);
+    }
+}
+
+void ServoController::beginSyncLoop()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(syncloopDuration));
+
+    // Part of a group: use the group cycle clock
+    ControllerGroup *group = syncloopGroup;
+    if (group)
+    {
+        period = group->getPeriod();
+    }
+
+    // First loop since the thread (re)started
+    if (syncloopDeadline == std::chrono::steady_clock::time_point())
+    {
+        syncloopDeadline = now;
+    }
+
+    syncloopStart = now;
+    syncloopNominalStart = syncloopDeadline;
+    syncloopDeadline += period;
+
+    if (syncloopDeadline <= now)
+    {
+        // The previous loop overran: skip the deadlines it missed
+        uint64_t missed = static_cast<uint64_t>((now - syncloopDeadline) / period) + 1;
+        syncloopDeadline += period * missed;
+        syncloopNominalStart += period * missed;
+        syncloopOverruns += missed;
+    }
+}
+
+void ServoController::endSyncLoop()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    syncloopHistogram.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - syncloopStart).count()));
+    adaptSyncFrequency(std::chrono::duration<double, std::milli>(now - syncloopStart).count());
+
+    // Part of a group: wait for the other controllers, then start the next cycle with them
+    ControllerGroup *group = syncloopGroup;
+    if (group)
+    {
+        syncloopDeadline = group->arrive();
+        now = std::chrono::steady_clock::now();
+    }
+
+    if (now >= syncloopDeadline)
+    {
+        // Overrun, the next loop starts right away
+        return;
+    }
+
+    std::chrono::microseconds busyWait(syncloopBusyWait);
+    if (busyWait.count() > 0)
+    {
+        std::this_thread::sleep_until(syncloopDeadline - busyWait);
+        while (std::chrono::steady_clock::now() < syncloopDeadline);
+    }
+    else
+    {
+        std::this_thread::sleep_until(syncloopDeadline);
+    }
+
+    now = std::chrono::steady_clock::now();
+    syncloopJitter.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - syncloopDeadline).count()));
+}
+
+void ServoController::adaptSyncFrequency(const double cost)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (syncloopWindowLoops == 0)
+    {
+        syncloopWindowStart = now;
+        syncloopWindowCost = 0.0;
+        syncloopWindowSlow = 0;
+    }
+
+    syncloopWindowLoops++;
+    syncloopWindowCost += cost;
+    if (cost > syncloopDuration * SYNCLOOP_ADAPTIVE_HIGH)
+    {
+        syncloopWindowSlow++;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(now - syncloopWindowStart).count();
+    if (elapsed < SYNCLOOP_ADAPTIVE_WINDOW_MS || syncloopWindowLoops < 8)
+    {
+        return;
+    }
+
+    // End of the measurement window
+    double average = syncloopWindowCost / syncloopWindowLoops;
+    bool slow = syncloopWindowSlow > syncloopWindowLoops * SYNCLOOP_ADAPTIVE_SLOW;
+    bool idle = syncloopWindowSlow == 0 && average < syncloopDuration * SYNCLOOP_ADAPTIVE_LOW;
+
+    syncloopAchieved = (syncloopWindowLoops - 1) * 1000.0 / elapsed;
+    syncloopWindowLoops = 0;
+
+    int fmin = syncloopAdaptiveMin, fmax = syncloopAdaptiveMax;
+    if (fmin < 1 || syncloopGroup != nullptr || average <= 0.0)
+    {
+        return;
+    }
+
+    int current = syncloopFrequency;
+    int target = static_cast<int>(SYNCLOOP_ADAPTIVE_TARGET * 1000.0 / average);
+
+    int frequency = current;
+    if (slow)
+    {
+        frequency = std::min(current - 1, target);
+    }
+    else if (idle)
+    {
+        // At most double the frequency at once: the cost of a loop doesn't only depend on the bus traffic
+        frequency = std::min(current * 2, target);
+    }
+    frequency = std::max(fmin, std::min(frequency, fmax));
+
+    if (frequency != current)
+    {
+        TRACE_INFO(MAPI, "Adapting synchronization loop frequency: %iHz > %iHz (average loop cost %.2fms)", current, frequency, average);
+
+        syncloopFrequency = frequency;
+        syncloopDuration = 1000.0 / static_cast<double>(frequency);
+
+        // Polling periods are expressed in loops
+        pollingSchedule.clear();
+    }
+}
+
+void ServoController::setAdaptiveSyncFrequency(const int minFrequency, const int maxFrequency)
+{
+    if (minFrequency < 1)
+    {
+        syncloopAdaptiveMin = 0;
+        return;
+    }
+
+    int fmin = std::min(minFrequency, SYNCLOOP_MAX_FREQUENCY);
+    int fmax = std::max(fmin, std::min(maxFrequency, SYNCLOOP_MAX_FREQUENCY));
+
+    syncloopAdaptiveMax = fmax;
+    syncloopAdaptiveMin = fmin;
+}
+
+int ServoController::getSyncFrequency()
+{
+    return syncloopFrequency;
+}
+
+double ServoController::getAchievedSyncFrequency()
+{
+    return syncloopAchieved;
+}
+
+LatencyStats ServoController::getSyncLoopJitter()
+{
+    return syncloopJitter.getStats();
+}
+
+uint64_t ServoController::getSyncLoopOverruns()
+{
+    return syncloopOverruns;
+}
+
+void ServoController::setSyncLoopBusyWait(const int usec)
+{
+    syncloopBusyWait = (usec > 0) ? usec : 0;
+}
+
+bool ServoController::setSyncLoopRealTime(const int priority, const int cpu, const bool lockMemory)
+{
+#if defined(__linux__) || defined(__gnu_linux__)
+    bool status = true;
+
+    if (lockMemory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            TRACE_WARNING(MAPI, "Unable to lock the process memory (mlockall): %s", strerror(errno));
+            status = false;
+        }
+    }
+
+    {
+        std::lock_guard <std::mutex> lock(syncloopRtLock);
+        syncloopRtPriority = std::max(0, std::min(priority, 99));
+        syncloopRtCpu = cpu;
+        syncloopRtConfigured = true;
+    }
+
+    if (syncloopThread.joinable())
+    {
+        status &= applyThreadSettings();
+    }
+
+    return status;
+#else
+    TRACE_WARNING(MAPI, "Real-time scheduling options are only available on Linux");
+    return false;
+#endif
+}
+
+bool ServoController::applyThreadSettings()
+{
+    bool status = true;
+
+#if defined(__linux__) || defined(__gnu_linux__)
+    std::lock_guard <std::mutex> lock(syncloopRtLock);
+    pthread_t thread = syncloopThread.native_handle();
+
+    // Nothing configured, the thread keeps the scheduling and affinity it inherited
+    if (syncloopRtConfigured == false)
+    {
+        return status;
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = syncloopRtPriority;
+
+    int err = pthread_setschedparam(thread, (syncloopRtPriority > 0) ? SCHED_FIFO : SCHED_OTHER, &param);
+    if (err != 0)
+    {
+        TRACE_WARNING(MAPI, "Unable to set the controller's thread scheduling (priority %i): %s", syncloopRtPriority, strerror(err));
+        status = false;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    err = 0;
+    if (syncloopRtCpu >= 0)
+    {
+        CPU_SET(syncloopRtCpu, &cpuset);
+    }
+    else
+    {
+        // Not pinned (anymore): same CPUs as the threads of the application
+        err = pthread_getaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    }
+
+    if (err == 0)
+    {
+        err = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+    }
+    if (err != 0)
+    {
+        TRACE_WARNING(MAPI, "Unable to set the controller's thread CPU affinity (cpu %i): %s", syncloopRtCpu, strerror(err));
+        status = false;
+    }
+#endif
+
+    return status;
+}
+
+void ServoController::publishCycle()
+{
+    // Only this thread increments the counter
+    const uint64_t cycle = feedbackCycle + 1;
+
+    // Capture the feedback of this cycle (and record the histories), then swap it in (no allocation under the lock)
+    {
+        std::shared_ptr <const ServoSnapshot> servos = getServoSnapshot();
+
+        cycleStatesBack.cycle = cycle;
+        cycleStatesBack.rxTime = std::chrono::steady_clock::now();
+        cycleStatesBack.states.resize(servos->servos.size());
+
+        for (size_t i = 0; i < servos->servos.size(); i++)
+        {
+            Servo *s = servos->servos[i];
+            ServoState &st = cycleStatesBack.states[i];
+
+            s->stampCycle(cycle);
+
+            st.id = s->getId();
+            st.position = s->getCurrentPosition();
+            st.speed = s->getCurrentSpeed();
+            st.load = s->getCurrentLoad();
+            st.voltage = s->getCurrentVoltage();
+            st.temperature = s->getCurrentTemperature();
+            st.error = s->getError();
+
+            s->recordHistory(cycleStatesBack.cycle, cycleStatesBack.rxTime);
+        }
+
+        std::lock_guard <std::mutex> lock(cycleStatesLock);
+        std::swap(cycleStates, cycleStatesBack);
+    }
+
+    {
+        std::lock_guard <std::mutex> lock(feedbackCycleLock);
+        feedbackCycle = cycle;
+
+        for (auto w: motionWaits)
+        {
+            if (w->done == false)
+            {
+                w->done = true;
+                for (auto s: *w->servos)
+                {
+                    // Modifications pending, or sent during this cycle: the feedback predates them
+                    if (s->hasPendingCommits() ||
+                        s->getCommandCycle() >= cycle ||
+                        w->predicate(s) == false)
+                    {
+                        w->done = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    feedbackCycleCondition.notify_all();
+
+    {
+        std::lock_guard <std::mutex> lock(cycleCallbacksLock);
+        for (auto &c: cycleCallbacks)
+        {
+            c.second(cycle);
+        }
+    }
+
+#if defined(__linux__) || defined(__gnu_linux__)
+    int fd = cycleEventFd;
+    if (fd >= 0)
+    {
+        uint64_t one = 1;
+        if (write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        {
+            TRACE_WARNING(MAPI, "Unable to signal the cycle eventfd: %s", strerror(errno));
+        }
+    }
+#endif
+}
+
+bool ServoController::setTrajectory(const int id, std::shared_ptr <const Trajectory> trajectory,
+                                    const std::chrono::steady_clock::time_point start)
+{
+    if (id < 0 || id > 253 || !trajectory || trajectory->isValid() == false)
+    {
+        TRACE_ERROR(MAPI, "setTrajectory(#%i) [VALUE ERROR]", id);
+        return false;
+    }
+
+    std::lock_guard <std::mutex> lock(trajectoryLock);
+
+    TrajectoryRun run;
+    run.trajectory = trajectory;
+    run.start = start;
+
+    trajectoryChanges.push_back(std::make_pair(id, run));
+    trajectoryRunning[id] = true;
+
+    return true;
+}
+
+void ServoController::cancelTrajectory(const int id)
+{
+    if (id >= 0 && id < 256)
+    {
+        std::lock_guard <std::mutex> lock(trajectoryLock);
+
+        trajectoryChanges.push_back(std::make_pair(id, TrajectoryRun()));
+        trajectoryRunning[id] = false;
+    }
+}
+
+bool ServoController::isTrajectoryRunning(const int id)
+{
+    if (id >= 0 && id < 256)
+    {
+        std::lock_guard <std::mutex> lock(trajectoryLock);
+        return trajectoryRunning[id];
+    }
+
+    return false;
+}
+
+void ServoController::updateTrajectories(const ServoSnapshot &servos)
+{
+    {
+        std::lock_guard <std::mutex> lock(trajectoryLock);
+
+        for (auto &c: trajectoryChanges)
+        {
+            if (c.second.trajectory)
+            {
+                // Start at the beginning of this cycle, if no start time was given
+                if (c.second.start == std::chrono::steady_clock::time_point())
+                {
+                    c.second.start = syncloopNominalStart;
+                }
+                trajectoriesActive[c.first] = c.second;
+            }
+            else
+            {
+                trajectoriesActive.erase(c.first);
+            }
+        }
+        trajectoryChanges.clear();
+    }
+
+    for (std::map <int, TrajectoryRun>::iterator it = trajectoriesActive.begin(); it != trajectoriesActive.end();)
+    {
+        Servo *s = servos.find(it->first);
+        double t = std::chrono::duration<double>(syncloopNominalStart - it->second.start).count();
+        bool done = (s == nullptr) || (t >= it->second.trajectory->getDuration());
+
+        if (s != nullptr && t >= 0.0)
+        {
+            int position = static_cast<int>(std::lround(it->second.trajectory->getPosition(t)));
+
+            if (position != s->getGoalPosition())
+            {
+                s->setGoalPosition(std::max(0, std::min(position, s->getSteps() - 1)));
+            }
+        }
+
+        if (done)
+        {
+            std::lock_guard <std::mutex> lock(trajectoryLock);
+
+            // Unless a new trajectory is already waiting for this device
+            bool replaced = false;
+            for (auto &c: trajectoryChanges)
+            {
+                replaced |= (c.first == it->first);
+            }
+            if (replaced == false)
+            {
+                trajectoryRunning[it->first] = false;
+            }
+
+            it = trajectoriesActive.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool ServoController::snapshot(CycleSnapshot &snap)
+{
+    std::lock_guard <std::mutex> lock(cycleStatesLock);
+
+    snap.cycle = cycleStates.cycle;
+    snap.rxTime = cycleStates.rxTime;
+    snap.states.assign(cycleStates.states.begin(), cycleStates.states.end());
+
+    return (snap.cycle > 0);
+}
+
+CycleSnapshot ServoController::snapshot()
+{
+    CycleSnapshot snap;
+    snapshot(snap);
+
+    return snap;
+}
+
+bool ServoController::waitAll(const std::vector <Servo *> &servos, std::function <bool(Servo *)> predicate, const int timeout_ms)
+{
+    MotionWait w;
+    w.servos = &servos;
+    w.predicate = predicate;
+    w.done = servos.empty();
+
+    std::unique_lock <std::mutex> lock(feedbackCycleLock);
+    motionWaits.push_back(&w);
+
+    feedbackCycleCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]()
+    {
+        return w.done || getState() < state_started;
+    });
+
+    motionWaits.erase(std::remove(motionWaits.begin(), motionWaits.end(), &w), motionWaits.end());
+
+    return w.done;
+}
+
+std::function <bool(Servo *)> ServoController::inPosition(const double margin)
+{
+    return [margin](Servo *s)
+    {
+        return s->getPositionCycle() > s->getCommandCycle() &&
+               std::abs(s->getCurrentPosition() - s->getGoalPosition()) <= (s->getSteps() * margin) / 2.0;
+    };
+}
+
+std::function <bool(Servo *)> ServoController::stopped()
+{
+    return [](Servo *s)
+    {
+        return s->getMovingCycle() > s->getCommandCycle() &&
+               s->getMoving() == 0;
+    };
+}
+
+uint64_t ServoController::getCycleCount()
+{
+    return feedbackCycle;
+}
+
+uint64_t ServoController::waitForCycle(const uint64_t lastCycle, const int timeout_ms)
+{
+    std::unique_lock <std::mutex> lock(feedbackCycleLock);
+
+    feedbackCycleCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]()
+    {
+        return feedbackCycle > lastCycle || getState() < state_started;
+    });
+
+    return feedbackCycle;
+}
+
+int ServoController::addCycleCallback(std::function <void(uint64_t)> callback)
+{
+    std::lock_guard <std::mutex> lock(cycleCallbacksLock);
+
+    cycleCallbacks.push_back(std::make_pair(++cycleCallbackHandle, callback));
+    return cycleCallbackHandle;
+}
+
+void ServoController::removeCycleCallback(const int handle)
+{
+    std::lock_guard <std::mutex> lock(cycleCallbacksLock);
+
+    for (std::vector <std::pair <int, std::function <void(uint64_t)>>>::iterator it = cycleCallbacks.begin(); it != cycleCallbacks.end(); ++it)
+    {
+        if (it->first == handle)
+        {
+            cycleCallbacks.erase(it);
+            break;
+        }
+    }
+}
+
+int ServoController::getCycleEventFd()
+{
+#if defined(__linux__) || defined(__gnu_linux__)
+    if (cycleEventFd < 0)
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0)
+        {
+            TRACE_ERROR(MAPI, "Unable to create the cycle eventfd: %s", strerror(errno));
+            return -1;
+        }
+
+        // Another thread may have created one in the meantime
+        int expected = -1;
+        if (cycleEventFd.compare_exchange_strong(expected, fd) == false)
+        {
+            close(fd);
+        }
+    }
+
+    return cycleEventFd;
+#else
+    TRACE_WARNING(MAPI, "Cycle eventfd is only available on Linux");
+    return -1;
+#endif
+}
+
+uint64_t ServoController::getDeferredReadCount()
+{
+    return deferredReads;
+}
+
+void ServoController::setCommitGapTolerance(const int bytes)
+{
+    commitGapTolerance = (bytes > 0) ? bytes : 0;
+}
+
 int ServoController::getErrorCount()
 {
     std::lock_guard <std::mutex> lock(errorCountLock);
@@ -212,6 +1025,64 @@ void ServoController::clearErrorCount()
 
 /* ************************************************************************** */
 
+Servo *ServoController::findServo_internal(const int id) const
+{
+    if (id >= 0 && id < 256)
+    {
+        return servoTable[id];
+    }
+
+    return nullptr;
+}
+
+void ServoController::publishServos_internal()
+{
+    std::shared_ptr <ServoSnapshot> snapshot = std::make_shared <ServoSnapshot>();
+    snapshot->servos = servoList;
+    std::copy(servoTable, servoTable + 256, snapshot->table);
+
+    std::atomic_store(&servoSnapshot, std::shared_ptr <const ServoSnapshot>(snapshot));
+}
+
+void ServoController::addServo_internal(Servo *servo)
+{
+    servoList.push_back(servo);
+    servoTable[servo->getId()] = servo;
+
+    publishServos_internal();
+
+    // Mark it for an "initial read" and synchronization
+    updateList.push_back(servo->getId());
+    syncList.push_back(servo->getId());
+}
+
+void ServoController::reindexServo(Servo *servo, const int oldId)
+{
+    std::lock_guard <std::mutex> lock(servoListLock);
+
+    if (findServo_internal(oldId) == servo)
+    {
+        servoTable[oldId] = nullptr;
+    }
+
+    int id = servo->getId();
+    if (id >= 0 && id < 256)
+    {
+        servoTable[id] = servo;
+    }
+
+    publishServos_internal();
+
+    // The old ID isn't valid anymore
+    unsyncServo_internal(oldId);
+}
+
+void ServoController::unsyncServo_internal(const int id)
+{
+    updateList.erase(std::remove(updateList.begin(), updateList.end(), id), updateList.end());
+    syncList.erase(std::remove(syncList.begin(), syncList.end(), id), syncList.end());
+}
+
 void ServoController::registerServo_internal(Servo *servo)
 {
     if (getState() >= state_started)
@@ -222,24 +1093,20 @@ void ServoController::registerServo_internal(Servo *servo)
             std::lock_guard <std::mutex> lock(servoListLock);
 
             // Check if the servo is already registered
-            for (std::vector <Servo *>::iterator it = servoList.begin(); it != servoList.end(); ++it)
+            if (servo->getId() < 0 || servo->getId() >= 256)
             {
-                if ((*it)->getId() == (*servo).getId())
-                {
-                    TRACE_ERROR(MAPI, "Unable to register servo #%i: already registered!", (*servo).getId());
-                    return;
-                }
+                TRACE_ERROR(MAPI, "Unable to register servo #%i: invalid ID!", servo->getId());
+                return;
             }
-            TRACE_INFO(MAPI, "Registering servo #%i", (*servo).getId());
-
-            // Add servo to the controller vector
-            servoList.push_back(servo);
-
-            // Mark it for an "initial read"
-            updateList.push_back((*servo).getId());
+            if (findServo_internal(servo->getId()) != nullptr)
+            {
+                TRACE_ERROR(MAPI, "Unable to register servo #%i: already registered!", servo->getId());
+                return;
+            }
+            TRACE_INFO(MAPI, "Registering servo #%i", servo->getId());
 
-            // Mark it for "sync"
-            syncList.push_back((*servo).getId());
+            // Add servo to the controller
+            addServo_internal(servo);
         }
         else
         {
@@ -257,41 +1124,19 @@ void ServoController::unregisterServo_internal(Servo *servo)
     // Lock servoList
     std::lock_guard <std::mutex> lock(servoListLock);
 
-    for (std::vector <Servo *>::iterator it = servoList.begin(); it != servoList.end();)
-    {
-        if ((*it)->getId() == (*servo).getId())
-        {
-            servoList.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    servoList.erase(std::remove(servoList.begin(), servoList.end(), servo), servoList.end());
 
-    for (std::vector <int>::iterator it = updateList.begin(); it != updateList.end();)
+    // The servo may still be indexed under a previous ID
+    for (int i = 0; i < 256; i++)
     {
-        if (*it == (*servo).getId())
-        {
-            updateList.erase(it);
-        }
-        else
+        if (servoTable[i] == servo)
         {
-            ++it;
+            servoTable[i] = nullptr;
         }
     }
 
-    for (std::vector <int>::iterator it = syncList.begin(); it != syncList.end();)
-    {
-        if (*it == (*servo).getId())
-        {
-            syncList.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    publishServos_internal();
+    unsyncServo_internal(servo->getId());
 
     if (servoList.empty() == true)
     {
@@ -313,6 +1158,8 @@ void ServoController::unregisterServos_internal()
     clearErrorCount();
 
     servoList.clear();
+    std::fill(servoTable, servoTable + 256, nullptr);
+    publishServos_internal();
     updateList.clear();
     syncList.clear();
 
@@ -320,52 +1167,33 @@ void ServoController::unregisterServos_internal()
     setState(state_started);
 }
 
-int ServoController::delayedAddServos_internal(std::chrono::time_point <std::chrono::system_clock> delay, int id, int update)
+void ServoController::delayedAddServos_internal(int id, int update)
 {
-    if (delay < std::chrono::system_clock::now())
-    {
-        TRACE_INFO(MAPI, "Adding back servo #%i to its controller", id);
-        servoListLock.lock();
-
-        syncList.push_back(id);
-        if (update == 1)
-        { updateList.push_back(id); }
-        servoListLock.unlock();
+    TRACE_INFO(MAPI, "Adding back servo #%i to its controller", id);
+    servoListLock.lock();
 
-        return 0;
-    }
-    else
-    {
-        return 1;
-    }
+    syncList.push_back(id);
+    if (update == 1)
+    { updateList.push_back(id); }
+    servoListLock.unlock();
 }
 
 /* ************************************************************************** */
 
 Servo *ServoController::getServo(const int id)
 {
-    // Lock servoList
-    std::lock_guard <std::mutex> lock(servoListLock);
-
-    for (std::vector <Servo *>::iterator it = servoList.begin(); it != servoList.end(); ++it)
-    {
-        if ((*it)->getId() == id)
-        {
-            return *it;
-        }
-    }
-
-    return nullptr;
+    return getServoSnapshot()->find(id);
 }
 
 const std::vector <Servo *> ServoController::getServos()
 {
-    // Lock servoList
-    std::lock_guard <std::mutex> lock(servoListLock);
-
     // We only return a copy of the list
-    const std::vector <Servo *> servos(servoList);
-    return servos;
+    return getServoSnapshot()->servos;
+}
+
+std::shared_ptr <const ServoSnapshot> ServoController::getServoSnapshot() const
+{
+    return std::atomic_load(&servoSnapshot);
 }
 
 /* ************************************************************************** */
@@ -376,8 +1204,10 @@ void ServoController::sendMessage(miniMessages *m)
     {
         TRACE_3(MAPI, "> sendMessage()");
 
-        std::lock_guard <std::mutex> lock(m_mutex);
-        m_queue.push_back(*m);
+        while (m_queue.push(*m) == false)
+        {
+            std::this_thread::yield();
+        }
     }
     else
     {
@@ -385,11 +1215,56 @@ void ServoController::sendMessage(miniMessages *m)
     }
 }
 
+void ServoController::sendMessageAndWait(miniMessages *m)
+{
+    // Messages are parsed at the top of each loop, so they are done once the loop after the current one is published
+    uint64_t cycle = getCycleCount();
+
+    sendMessage(m);
+    waitForCycle(cycle + 1, 1000 + 2000 / std::max(1, syncloopFrequency.load()));
+}
+
+bool ServoController::receiveMessage(miniMessages &m)
+{
+    while (m_queue.pop(m))
+    {
+        if (m.delay > std::chrono::steady_clock::now())
+        {
+            m_delayed.push(m);
+            continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ServoController::receiveDelayedMessage(miniMessages &m)
+{
+    if (m_delayed.empty() == false && m_delayed.top().delay <= std::chrono::steady_clock::now())
+    {
+        m = m_delayed.top();
+        m_delayed.pop();
+        return true;
+    }
+
+    return false;
+}
+
+void ServoController::delayMessage(const miniMessages &m)
+{
+    m_delayed.push(m);
+}
+
 void ServoController::clearMessageQueue()
 {
-    m_mutex.lock();
     m_queue.clear();
-    m_mutex.unlock();
+
+    while (m_delayed.empty() == false)
+    {
+        m_delayed.pop();
+    }
 }
 
 /* ************************************************************************** */
@@ -25,16 +25,111 @@
 
 #include "Servo.h"
 #include "ServoTools.h"
+#include "SerialPort.h"
+#include "LatencyHistogram.h"
+#include "WritePlanner.h"
+#include "MessageQueue.h"
+#include "Trajectory.h"
 
 #include <vector>
-#include <deque>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <queue>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 
 /** \addtogroup ManagedAPIs
  *  @{
  */
 
+/*!
+ * \brief Priority of the transactions planned by a synchronization loop, highest first.
+ *
+ * When a loop runs out of time, telemetry and diagnostic reads are deferred to
+ * the next loops. Commands and position feedback are never deferred.
+ */
+enum TransactionPriority_e
+{
+    PRIORITY_COMMAND    = 0,    //!< Register modifications.
+    PRIORITY_POSITION   = 1,    //!< Position feedback.
+    PRIORITY_TELEMETRY  = 2,    //!< Auxiliary feedback (speed, load, moving...).
+    PRIORITY_DIAGNOSTIC = 3,    //!< Everything else (voltage, temperature, status...).
+};
+
+//! Maximum frequency of the synchronization loop, in Hz.
+#define SYNCLOOP_MAX_FREQUENCY      1000
+
+//! Number of consecutive loops a read may be deferred, before being promoted to position feedback priority.
+#define POLLING_STARVATION_LIMIT    8
+
+//! Duration of the window over which the cost of the synchronization loops is measured, in adaptive frequency mode.
+#define SYNCLOOP_ADAPTIVE_WINDOW_MS 500
+
+//! Loop cost (as a fraction of the loop period) above which a loop is considered too slow, in adaptive frequency mode.
+#define SYNCLOOP_ADAPTIVE_HIGH      0.9
+
+//! Fraction of too slow loops in a measurement window above which the adaptive frequency is lowered.
+#define SYNCLOOP_ADAPTIVE_SLOW      0.1
+
+//! Loop cost (as a fraction of the loop period) below which the adaptive frequency is raised.
+#define SYNCLOOP_ADAPTIVE_LOW       0.5
+
+//! Loop cost (as a fraction of the loop period) the adaptive frequency aims for, when it changes.
+#define SYNCLOOP_ADAPTIVE_TARGET    0.7
+
+/*!
+ * \brief Immutable set of the devices managed by a controller.
+ *
+ * A new snapshot is published (atomically) every time a device is registered
+ * or unregistered, so readers never need to lock the controller: the snapshot
+ * itself stays valid for as long as a reader holds a reference to it.
+ *
+ * The snapshot doesn't own the devices though: stopping the controller, or
+ * scanning the bus again with autodetect(), deletes them and leaves the pointers
+ * of the snapshots still held dangling.
+ */
+struct ServoSnapshot
+{
+    std::vector <Servo *> servos;       //!< Devices, in registration order.
+    Servo *table[256] = {};             //!< Devices, indexed by ID.
+
+    //! Find a device by ID, in constant time. Return nullptr if no device is registered with this ID.
+    Servo *find(const int id) const
+    {
+        return (id >= 0 && id < 256) ? table[id] : nullptr;
+    }
+};
+
+class ControllerGroup;
+
+/*!
+ * \brief Feedback of one device, as seen at the end of a synchronization cycle.
+ */
+struct ServoState
+{
+    int id;                             //!< Device ID.
+    int position;                       //!< Current position, in steps.
+    int speed;                          //!< Current speed (raw register value, differential position on HerkuleX devices).
+    int load;                           //!< Current load (raw register value, PWM on HerkuleX devices).
+    double voltage;                     //!< Current voltage, in volts.
+    double temperature;                 //!< Current temperature, in °C.
+    int error;                          //!< Last error reported by the device.
+};
+
+/*!
+ * \brief Feedback of every device of a controller, all taken from the same synchronization cycle.
+ */
+struct CycleSnapshot
+{
+    uint64_t cycle = 0;                 //!< Cycle number, as counted by ServoController::getCycleCount(). 0 if no cycle has been published yet.
+    std::chrono::steady_clock::time_point rxTime; //!< Time at which the feedback of this cycle was complete.
+    std::vector <ServoState> states;    //!< One entry per device, in registration order.
+};
+
 /*!
  * \todo move that into the SerialPort class?
  */
@@ -71,6 +166,8 @@ enum controllerState_e
  */
 class ServoController
 {
+    friend class ControllerGroup;
+
     int controllerState = 0;            //!< The current state of the controller, used by client apps to know.
     std::mutex controllerStateLock;     //!< Lock for the controllerState.
 
@@ -87,6 +184,9 @@ protected:
         ctrl_device_unregister_all,
         ctrl_device_delayed_add,
 
+        ctrl_capture_start,
+        ctrl_capture_stop,
+
         ctrl_state_pause,
         ctrl_state_stop,
     };
@@ -94,27 +194,208 @@ protected:
     struct miniMessages
     {
         controllerMessage_e msg;
-        std::chrono::time_point <std::chrono::system_clock> delay; //!< Used to delay message parsing
+        std::chrono::steady_clock::time_point delay; //!< Used to delay message parsing
         void *p;
         int p1;
         int p2;
         int p3;
     };
 
-    int syncloopFrequency;              //!< Frequency of the synchronization loop, in Hz. May not be respected if there is too much traffic on the serial port.
-    int syncloopCounter = 0;
-    double syncloopDuration;            //!< Maximum duration for the synchronization loop, in milliseconds.
+    std::string capturePath;            //!< Capture file given to the controller's thread by the 'ctrl_capture_start' message.
+    std::mutex capturePathLock;         //!< Lock for the capture path.
+
+    std::atomic <int> syncloopFrequency; //!< Frequency of the synchronization loop, in Hz. May not be respected if there is too much traffic on the serial port.
+    uint64_t syncloopCounter = 0;       //!< Number of synchronization loops since the controller started.
+    std::atomic <double> syncloopDuration; //!< Maximum duration for the synchronization loop, in milliseconds.
+    LatencyHistogram syncloopHistogram; //!< Duration of the synchronization loops, in microseconds (sleep excluded).
+    LatencyHistogram syncloopJitter;    //!< Wake-up delay after each loop deadline, in microseconds.
+    std::atomic <uint64_t> syncloopOverruns {0}; //!< Number of loop deadlines missed.
+    std::chrono::steady_clock::time_point syncloopDeadline; //!< End of the current synchronization loop, and beginning of the next one.
+
+    std::atomic <int> syncloopBusyWait {0}; //!< Duration of the busy-wait before each deadline, in microseconds.
+    int syncloopRtPriority = 0;         //!< SCHED_FIFO priority of the controller's thread, 0 for the default scheduling.
+    int syncloopRtCpu = -1;             //!< CPU the controller's thread is pinned to, -1 for none.
+    bool syncloopRtConfigured = false;  //!< Set once setSyncLoopRealTime() has been called, the thread keeps the inherited settings until then.
+    std::mutex syncloopRtLock;          //!< Lock for the real-time settings.
+    std::atomic <ControllerGroup *> syncloopGroup {nullptr}; //!< Group driving the cycles of this controller, if any.
+
+    std::atomic <int> syncloopAdaptiveMin {0}; //!< Lowest frequency of the adaptive mode, in Hz, or 0 if the frequency is fixed.
+    std::atomic <int> syncloopAdaptiveMax {0}; //!< Highest frequency of the adaptive mode, in Hz.
+    std::chrono::steady_clock::time_point syncloopWindowStart; //!< Beginning of the current measurement window.
+    int syncloopWindowLoops = 0;        //!< Number of loops in the current measurement window.
+    double syncloopWindowCost = 0.0;    //!< Sum of the loop durations of the current measurement window, in milliseconds.
+    int syncloopWindowSlow = 0;         //!< Number of loops of the current measurement window above the high load threshold.
+    std::atomic <double> syncloopAchieved {0.0}; //!< Loop frequency achieved over the last measurement window, in Hz.
+
+    /*!
+     * \brief Measure the cost of a loop, and adapt the loop frequency at the end of each measurement window.
+     * \param cost: Duration of the loop that just ended, in milliseconds.
+     */
+    void adaptSyncFrequency(const double cost);
 
     std::thread syncloopThread;         //!< Controller's thread.
 
-    std::deque<struct miniMessages> m_queue; //!< Message queue.
-    std::mutex m_mutex;                 //!< Lock for the message queue.
+    WritePlanner writePlanner;          //!< Merges the register modifications of a device into as few writes as possible.
+    std::atomic <int> commitGapTolerance {0}; //!< Unchanged bytes the write planner may re-send to merge two register writes.
+
+    /*!
+     * \brief A polling rate declared with setPollingRate().
+     */
+    struct PollingRate
+    {
+        std::vector <int> registers;
+        double rate;                    //!< Polling rate, in Hz.
+        std::vector <int> ids;          //!< Devices concerned, or empty for every device.
+    };
+
+    /*!
+     * \brief Polling schedule of a register of a device.
+     */
+    struct PollingSlot
+    {
+        int reg;                        //!< Register name.
+        double period;                  //!< Polling period, in synchronization loops.
+        double next;                    //!< Next synchronization loop reading this register.
+        bool pending;                   //!< Read deferred from a previous loop, due again.
+        int deferred;                   //!< Number of consecutive loops this read has been deferred.
+    };
+
+    std::vector <PollingRate> pollingRates; //!< Polling rates declared, in order.
+    bool pollingChanged = true;         //!< Set when 'pollingRates' has changed since the schedule was computed.
+    std::mutex pollingLock;             //!< Lock for the polling rates.
+    std::vector <PollingRate> pollingActive; //!< Copy of the polling rates used by the synchronization loop.
+    std::map <int, std::vector <PollingSlot>> pollingSchedule; //!< Polling schedule of each device, by ID. Only used by the synchronization loop.
+
+    /*!
+     * \brief A trajectory followed by a device.
+     */
+    struct TrajectoryRun
+    {
+        std::shared_ptr <const Trajectory> trajectory; //!< The trajectory, or nullptr to stop following one.
+        std::chrono::steady_clock::time_point start; //!< Start time, or a default time point to start at the next cycle.
+    };
+
+    std::vector <std::pair <int, TrajectoryRun>> trajectoryChanges; //!< Trajectories set or cancelled since the last cycle, by device ID.
+    bool trajectoryRunning[256] = {};   //!< Devices with a trajectory set and not yet completed, by ID.
+    std::mutex trajectoryLock;          //!< Lock for the trajectory changes and running flags.
+    std::map <int, TrajectoryRun> trajectoriesActive; //!< Trajectories followed, by device ID. Only used by the synchronization loop.
+    std::chrono::steady_clock::time_point syncloopNominalStart; //!< Scheduled beginning of the current synchronization loop (without its wake-up jitter).
+
+    /*!
+     * \brief Pick up the trajectory changes, then set the goal position of every device following a trajectory.
+     * \param servos: Devices of the controller.
+     *
+     * To be called during each synchronization loop, before the register
+     * modifications are committed, so the new setpoints go out with that cycle.
+     */
+    void updateTrajectories(const ServoSnapshot &servos);
+
+    /*!
+     * \brief Declare the default polling rates of this controller.
+     */
+    virtual void setDefaultPollingRates() = 0;
+
+    /*!
+     * \brief Pick up the polling rates changes, to be called at the beginning of each synchronization loop.
+     */
+    void updatePollingSchedule();
+
+    /*!
+     * \brief Get the registers of a device to read during the current synchronization loop.
+     * \param id: Device ID.
+     * \param registers: Array receiving the register names.
+     * \param priorities: Array receiving the register priorities (using ::TransactionPriority_e), can be nullptr.
+     * \param max: Size of the arrays.
+     * \return The number of registers to read.
+     *
+     * Reads deferred for more than POLLING_STARVATION_LIMIT loops are given the
+     * PRIORITY_POSITION priority, so they can't be deferred forever.
+     */
+    int getDueRegisters(const int id, int *registers, int *priorities, const int max);
+
+    /*!
+     * \brief Defer the read of a due register to the next synchronization loop.
+     */
+    void deferRegister(const int id, const int reg);
+
+    /*!
+     * \brief Get the default priority of a register read.
+     * \return A priority from ::TransactionPriority_e.
+     */
+    static int getRegisterPriority(const int reg);
+
+    std::chrono::steady_clock::time_point syncloopStart; //!< Beginning of the current synchronization loop.
+    double syncloopByteTime = 0.0;      //!< Time needed to transmit one byte on the serial link, in microseconds.
+    double syncloopOverhead = 0.0;      //!< Measured time spent per transaction on top of its bytes, in microseconds.
+    std::atomic <uint64_t> deferredReads {0}; //!< Number of register reads deferred to a later loop.
+
+    std::atomic <uint64_t> feedbackCycle {0}; //!< Number of synchronization loops whose feedback has been published.
+    std::mutex feedbackCycleLock;       //!< Lock for the cycle condition variable.
+    std::condition_variable feedbackCycleCondition; //!< Notified every time a new cycle is published.
+
+    /*!
+     * \brief A waitAll() call, evaluated by the controller's thread every time a cycle is published.
+     */
+    struct MotionWait
+    {
+        const std::vector <Servo *> *servos;
+        std::function <bool(Servo *)> predicate;
+        bool done;
+    };
+    std::vector <MotionWait *> motionWaits; //!< Pending waitAll() calls, protected by feedbackCycleLock.
+
+    CycleSnapshot cycleStates;          //!< Feedback of the last published cycle, protected by cycleStatesLock.
+    CycleSnapshot cycleStatesBack;      //!< Feedback of the cycle being published. Only used by the controller's thread.
+    std::mutex cycleStatesLock;         //!< Lock for the feedback of the last published cycle.
+
+    std::vector <std::pair <int, std::function <void(uint64_t)>>> cycleCallbacks; //!< Callbacks called for every cycle, with their handles.
+    int cycleCallbackHandle = 0;        //!< Last callback handle given.
+    std::mutex cycleCallbacksLock;      //!< Lock for the callbacks.
+    std::atomic <int> cycleEventFd {-1}; //!< Linux eventfd signaled for every cycle, created on demand.
+
+    /*!
+     * \brief Publish a new cycle, once its feedback has landed into the servos, and signal the subscribers.
+     */
+    void publishCycle();
+
+    /*!
+     * \brief Get the time left before the end of the current synchronization loop.
+     * \return The remaining budget, in microseconds (negative if the loop already overran).
+     */
+    double getRemainingBudget();
+
+    /*!
+     * \brief Estimate the duration of some transactions.
+     * \param bytes: Number of bytes sent and received.
+     * \param transactions: Number of transactions.
+     * \return The estimated duration, in microseconds.
+     */
+    double estimateCost(const int bytes, const int transactions);
+
+    /*!
+     * \brief Refine the transaction overhead used by estimateCost() with a measured duration.
+     */
+    void updateCostModel(const double duration, const int bytes, const int transactions);
+
+    /*!
+     * \brief Order the delayed messages by deadline, the earliest at the top of the heap.
+     */
+    struct DelayedMessageOrder
+    {
+        bool operator()(const miniMessages &a, const miniMessages &b) const { return a.delay > b.delay; }
+    };
+
+    MessageQueue <miniMessages, 256> m_queue; //!< Message queue, filled by any thread, consumed by the controller's thread.
+    std::priority_queue <miniMessages, std::vector <miniMessages>, DelayedMessageOrder> m_delayed; //!< Delayed messages, only used by the controller's thread.
 
     std::vector <Servo *> servoList;    //!< List containing device object managed by this controller.
-    std::mutex servoListLock;           //!< Lock for the device list.
+    Servo *servoTable[256] = {};        //!< Device objects managed by this controller, indexed by ID.
+    std::mutex servoListLock;           //!< Lock for structural changes to the device list, table and update/sync lists.
+
+    std::shared_ptr <const ServoSnapshot> servoSnapshot; //!< Last published device set. Only accessed through std::atomic_load() / std::atomic_store().
 
-    std::vector <int> updateList;       //!< List of device object marked for a "full" register update.
-    std::vector <int> syncList;         //!< List of device object to keep in sync.
+    std::vector <int> updateList;       //!< List of device object marked for a "full" register update. Only accessed from the controller's thread.
+    std::vector <int> syncList;         //!< List of device object to keep in sync. Only accessed from the controller's thread.
 
     //! Read/write synchronization loop, running inside its own background thread
     virtual void run() = 0;
@@ -123,15 +404,70 @@ protected:
      * \brief Internal thread messaging system.
      * \param m: A pointer to a miniMessages structure. Will be copied.
      *
-     * Push a message into the back of a deque (if the thread is running, otherwise
-     * messages will be discarded with an error).
+     * Push a message into the back of a lock-free queue (if the thread is running,
+     * otherwise messages will be discarded with an error). If the queue is full,
+     * the calling thread yields until the controller's thread makes some room.
      */
     void sendMessage(miniMessages *m);
 
+    /*!
+     * \brief Send a message to the controller's thread, and wait (for a bounded time) until it has been parsed.
+     * \param m: A pointer to a miniMessages structure. Will be copied.
+     */
+    void sendMessageAndWait(miniMessages *m);
+
+    /*!
+     * \brief Get the next message sent to the controller's thread.
+     * \param m: Where to copy the message.
+     * \return False if there is no message left.
+     *
+     * Messages with a delay are moved into the delayed messages heap, and only
+     * returned once their delay expires (see receiveDelayedMessage()).
+     */
+    bool receiveMessage(miniMessages &m);
+
+    /*!
+     * \brief Get the next delayed message whose delay has expired.
+     * \param m: Where to copy the message.
+     * \return False if no delayed message is due yet.
+     */
+    bool receiveDelayedMessage(miniMessages &m);
+
+    /*!
+     * \brief Delay a message from the controller's thread itself, without going through the message queue.
+     */
+    void delayMessage(const miniMessages &m);
+
+    /*!
+     * \brief Find a servo by ID, in constant time. 'servoListLock' must be held by the caller.
+     * \return The servo, or nullptr if no servo is registered with this ID.
+     */
+    Servo *findServo_internal(const int id) const;
+
+    /*!
+     * \brief Publish the current device list and table as a new snapshot. 'servoListLock' must be held by the caller.
+     */
+    void publishServos_internal();
+
+    /*!
+     * \brief Add a servo to the device list and table, and mark it for an initial read and synchronization. 'servoListLock' must be held by the caller.
+     */
+    void addServo_internal(Servo *servo);
+
+    /*!
+     * \brief Index a servo under its new ID, after an ID change, and drop its old ID from the update and sync lists.
+     */
+    void reindexServo(Servo *servo, const int oldId);
+
+    /*!
+     * \brief Remove an ID from the update and sync lists. 'servoListLock' must be held by the caller.
+     */
+    void unsyncServo_internal(const int id);
+
     void registerServo_internal(Servo *servo);
     void unregisterServo_internal(Servo *servo);
     void unregisterServos_internal();
-    int delayedAddServos_internal(std::chrono::time_point<std::chrono::system_clock> delay, int id, int update);
+    void delayedAddServos_internal(int id, int update);
     virtual void autodetect_internal(int start = 0, int stop = 253, int bail = 253) = 0;
 
     /*!
@@ -139,6 +475,26 @@ protected:
      */
     void startThread();
 
+    /*!
+     * \brief Apply the real-time settings to the controller's thread, if they have been set with setSyncLoopRealTime().
+     * \return True if every setting has been applied (or if there is nothing to apply).
+     */
+    bool applyThreadSettings();
+
+    /*!
+     * \brief Begin a synchronization loop, to be called at the top of run().
+     *
+     * Loops are scheduled on absolute deadlines of a monotonic clock, so they
+     * don't drift. If the previous loop overran, the deadlines it missed are
+     * skipped (and counted) to keep the original phase.
+     */
+    void beginSyncLoop();
+
+    /*!
+     * \brief End a synchronization loop: sleep until its deadline, to be called at the bottom of run().
+     */
+    void endSyncLoop();
+
     /*!
      * \brief Stop synchronization loop thread. All servos are deleted from its internal lists.
      */
@@ -158,7 +514,7 @@ protected:
 public:
     /*!
      * \brief ServoController constructor.
-     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;120].
+     * \param ctrlFrequency: This is the synchronization frequency between the controller and the servos devices. Range is [1;1000].
      */
     ServoController(int ctrlFrequency);
 
@@ -223,6 +579,279 @@ public:
     virtual std::vector <std::string> serialGetAvailableDevices_wrapper() = 0;
     virtual void serialSetLatency_wrapper(int latency) = 0;
 
+    /*!
+     * \brief Get the bus utilization of the serial port used by this controller.
+     */
+    virtual SerialPortStats serialGetStats_wrapper() = 0;
+
+    /*!
+     * \brief Reset the bus utilization counters of the serial port used by this controller.
+     */
+    virtual void serialResetStats_wrapper() = 0;
+
+    /*!
+     * \brief Get the latency summary of a transaction type (ping/read/write/sync/bulk) on this controller's serial link.
+     * \param instruction: Transaction type (using ::LatencyInstructions_e).
+     * \return The latency summary (count, mean, min, p50, p90, p99, p999, max), in microseconds.
+     */
+    virtual LatencyStats getInstructionLatency_wrapper(const int instruction) = 0;
+
+    /*!
+     * \brief Get the latency summary of the transactions answered by a device.
+     * \param id: Device ID.
+     * \return The latency summary (count, mean, min, p50, p90, p99, p999, max), in microseconds.
+     *
+     * A device with a much higher p99 or max than its neighbours usually has a
+     * bad cable or connector, long before it starts missing cycles.
+     */
+    virtual LatencyStats getServoLatency_wrapper(const int id) = 0;
+
+    /*!
+     * \brief Clear the transaction and synchronization loop latency histograms.
+     */
+    virtual void resetLatency_wrapper() = 0;
+
+    /*!
+     * \brief Record the serial traffic of this controller into a binary capture file.
+     * \param path: Path of the capture file, that can be replayed later with a "replay://<path>" device.
+     * \return True if the capture has started.
+     *
+     * Frames are captured by the controller's thread, so if it is running, the
+     * capture is started by that thread (at the top of its next loop) and this
+     * call waits for it.
+     */
+    virtual bool serialCaptureStart_wrapper(const std::string &path) = 0;
+
+    /*!
+     * \brief Stop the serial traffic capture. The capture file is complete when this returns.
+     */
+    virtual void serialCaptureStop_wrapper() = 0;
+
+    /*!
+     * \brief Get the duration summary of the synchronization loops, excluding the time spent sleeping.
+     * \return The duration summary, in microseconds.
+     */
+    LatencyStats getSyncLoopLatency();
+
+    /*!
+     * \brief Set the rate at which some registers are read from the devices by the synchronization loop.
+     * \param registers: Register names (ex: REG_CURRENT_POSITION).
+     * \param rate: Polling rate, in Hz. A rate equal to or above the synchronization loop frequency reads the registers on every loop, 0 stops reading them.
+     * \param ids: IDs of the devices concerned, or an empty list for every device.
+     *
+     * A rate set for some devices takes precedence over a rate set for every
+     * device, otherwise the last rate set wins. The reads of a register are
+     * spread over the synchronization loops, so devices polled at the same rate
+     * are not all read during the same loop.
+     */
+    void setPollingRate(const std::vector <int> &registers, const double rate, const std::vector <int> &ids = std::vector <int>());
+
+    /*!
+     * \brief Restore the default polling rates of this controller.
+     */
+    void resetPollingRates();
+
+    /*!
+     * \brief Get the wake-up delay summary of the synchronization loops, after their deadlines.
+     * \return The jitter summary, in microseconds.
+     */
+    LatencyStats getSyncLoopJitter();
+
+    /*!
+     * \brief Get the number of synchronization loop deadlines missed because a loop (or the bus) was too slow.
+     */
+    uint64_t getSyncLoopOverruns();
+
+    /*!
+     * \brief Busy-wait at the end of each synchronization loop, instead of sleeping until its deadline.
+     * \param usec: Duration of the busy-wait slice, in microseconds. 0 (the default) only sleeps.
+     *
+     * Sleeping is only accurate to the OS timer slack (often 50 to 100µs or
+     * more). Sleeping until 'usec' before the deadline then spinning brings the
+     * jitter down to a few microseconds, at the price of some CPU time.
+     */
+    void setSyncLoopBusyWait(const int usec);
+
+    /*!
+     * \brief Set real-time scheduling options for the controller's thread.
+     * \param priority: SCHED_FIFO priority [1;99], or 0 for the default scheduling policy.
+     * \param cpu: CPU to pin the controller's thread to, or -1 to leave it free.
+     * \param lockMemory: Lock the process memory with mlockall(), to avoid page faults inside the loop.
+     * \return True if the settings have been applied (if the thread is running) or saved for later.
+     *
+     * Only available on Linux. SCHED_FIFO and mlockall() usually need root
+     * privileges (or CAP_SYS_NICE and CAP_IPC_LOCK capabilities). Until this
+     * is called, the controller's thread keeps the scheduling policy and the
+     * CPU affinity it inherited from the application.
+     */
+    bool setSyncLoopRealTime(const int priority, const int cpu = -1, const bool lockMemory = false);
+
+    /*!
+     * \brief Let the controller adapt its synchronization loop frequency to the capacity of the bus.
+     * \param minFrequency: Lowest frequency allowed, in Hz, or 0 to keep the current frequency fixed.
+     * \param maxFrequency: Highest frequency allowed, in Hz. Range is [minFrequency;1000].
+     *
+     * The duration of the loops is measured over windows of 500 ms. If more
+     * than 10% of the loops of a window took over 90% of the loop period, the
+     * frequency is lowered; if none did and they took less than 50% on
+     * average, the frequency is raised. In both cases the new frequency aims
+     * for an average of 70%, so it doesn't flip-flop. Registers polled at
+     * full speed follow the loop, while the other polling rates keep their
+     * frequencies. Ignored while the controller belongs to a ControllerGroup.
+     */
+    void setAdaptiveSyncFrequency(const int minFrequency, const int maxFrequency);
+
+    /*!
+     * \brief Get the frequency the synchronization loop is scheduled at, in Hz.
+     */
+    int getSyncFrequency();
+
+    /*!
+     * \brief Get the synchronization loop frequency actually achieved over the last measurement window, in Hz.
+     */
+    double getAchievedSyncFrequency();
+
+    /*!
+     * \brief Get the number of register reads deferred to a later synchronization loop, because a loop ran out of time.
+     */
+    uint64_t getDeferredReadCount();
+
+    /*!
+     * \brief Get the number of synchronization cycles published, i.e. with their feedback available into the servos.
+     */
+    uint64_t getCycleCount();
+
+    /*!
+     * \brief Wait for the controller to publish a cycle newer than 'lastCycle'.
+     * \param lastCycle: The last cycle seen by the caller, or 0.
+     * \param timeout_ms: Maximum time to wait, in milliseconds.
+     * \return The current cycle count, equal to 'lastCycle' on timeout.
+     *
+     * Calling this at the top of a control loop keeps it phase-locked with the
+     * bus updates: the feedback read is always fresh, and the commands issued
+     * are sent at the very next cycle.
+     */
+    uint64_t waitForCycle(const uint64_t lastCycle, const int timeout_ms = 1000);
+
+    /*!
+     * \brief Register a function called from the controller's thread, every time a cycle is published.
+     * \param callback: The function to call, with the cycle count as argument.
+     * \return A handle, to be used with removeCycleCallback().
+     *
+     * Callbacks run inside the synchronization loop, so they must be short, and
+     * must not add or remove cycle callbacks.
+     */
+    int addCycleCallback(std::function <void(uint64_t)> callback);
+
+    /*!
+     * \brief Unregister a cycle callback.
+     * \param handle: A handle given by addCycleCallback().
+     */
+    void removeCycleCallback(const int handle);
+
+    /*!
+     * \brief Get a file descriptor signaled every time a cycle is published, to be used with poll(), select() or epoll().
+     * \return A Linux eventfd, or -1 if unavailable.
+     *
+     * The eventfd is non-blocking, and counts the cycles published since it has
+     * last been read. It is owned by the controller: do not close it.
+     */
+    int getCycleEventFd();
+
+    /*!
+     * \brief Get the feedback of every device, all taken from the last published cycle.
+     * \param snap: Where to copy the feedback. Its storage is reused, so once it is large enough this call doesn't allocate.
+     * \return False if no cycle has been published yet.
+     *
+     * Unlike calling the getters of each device, which can return values from
+     * two different cycles if the controller's thread updates them in between,
+     * every value here comes from the same completed cycle. Registers polled
+     * at a lower rate (see setPollingRate()) hold the last value read.
+     */
+    bool snapshot(CycleSnapshot &snap);
+
+    /*!
+     * \brief Get the feedback of every device, all taken from the last published cycle.
+     * \return A new snapshot. See snapshot(CycleSnapshot &) for an allocation free version.
+     */
+    CycleSnapshot snapshot();
+
+    /*!
+     * \brief Make a device follow a trajectory, evaluated by the controller's thread every cycle.
+     * \param id: Device ID.
+     * \param trajectory: The trajectory. Positions are goal positions, in steps.
+     * \param start: When the trajectory starts. By default, at the next cycle. Give the same start time to several devices to synchronize them.
+     * \return False if the trajectory isn't valid.
+     *
+     * At every cycle, the goal position of the device is set from the
+     * trajectory, evaluated at the scheduled beginning of the cycle, so the
+     * setpoints are perfectly periodic and go out with that cycle's commits.
+     * A new trajectory replaces the previous one. Once its last waypoint is
+     * reached, the device keeps that goal position.
+     */
+    bool setTrajectory(const int id, std::shared_ptr <const Trajectory> trajectory,
+                       const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::time_point());
+
+    /*!
+     * \brief Stop following a trajectory. The device keeps its last goal position.
+     * \param id: Device ID.
+     */
+    void cancelTrajectory(const int id);
+
+    /*!
+     * \brief Check if a device is following a trajectory.
+     * \param id: Device ID.
+     * \return True if a trajectory has been set and not yet completed (or cancelled).
+     */
+    bool isTrajectoryRunning(const int id);
+
+    /*!
+     * \brief Wait until every servo of a set satisfies a condition.
+     * \param servos: The servos to watch. They must be registered to this controller.
+     * \param predicate: The condition, called with each servo. See inPosition() and stopped().
+     * \param timeout_ms: Maximum time to wait, in milliseconds.
+     * \return True if the condition is met, false on timeout or if the controller stopped.
+     *
+     * The condition is evaluated by the controller's thread, right after the
+     * feedback of a cycle has landed into the servos, so the caller wakes up
+     * during the very cycle the motion completes, instead of polling. A servo
+     * with modified registers not yet sent to the device, or sent during the
+     * cycle being published, never satisfies the condition, so a goal set just
+     * before calling this can't be missed. Custom predicates reading slowly
+     * polled registers should also compare Servo::getFeedbackCycle() with
+     * Servo::getCommandCycle(), like inPosition() and stopped() do.
+     * The predicate must be short, and must not call back into the controller.
+     */
+    bool waitAll(const std::vector <Servo *> &servos, std::function <bool(Servo *)> predicate, const int timeout_ms = 5000);
+
+    /*!
+     * \brief Condition for waitAll(): the servo position is within 'margin' of its goal position.
+     * \param margin: Tolerance, as a fraction of the servo steps (0.03 is 3%).
+     *
+     * Only a position read after the last modifications sent to the device is trusted.
+     */
+    static std::function <bool(Servo *)> inPosition(const double margin = 0.03);
+
+    /*!
+     * \brief Condition for waitAll(): the servo reports it isn't moving anymore.
+     *
+     * Uses the REG_MOVING register on Dynamixel devices (so its reading must be
+     * enabled, see setPollingRate()), and the 'moving' bit of the status detail
+     * on HerkuleX devices. Either must have been received after the last
+     * modifications sent to the device.
+     */
+    static std::function <bool(Servo *)> stopped();
+
+    /*!
+     * \brief Set how many unchanged register bytes may be re-sent to merge two register modifications into one write.
+     * \param bytes: Gap tolerance, in bytes. 0 (the default) only merges registers with contiguous addresses.
+     *
+     * The gap is filled with the current values of the registers it covers, so
+     * it only makes sense if these values are up to date. A gap that doesn't
+     * exclusively cover writable registers is never filled.
+     */
+    void setCommitGapTolerance(const int bytes);
+
     /*!
      * \brief clearMessageQueue
      */
@@ -280,6 +909,16 @@ public:
      * \return A read only list of servo instances registered to this controller.
      */
     const std::vector <Servo *> getServos();
+
+    /*!
+     * \brief Return the set of servo instances registered to this controller, without any copy or locking.
+     * \return A reference counted, read only snapshot of the devices registered to this controller.
+     *
+     * Registrations happening after this call won't change the snapshot: call it
+     * again to get an up to date one. The devices it points to are deleted by
+     * stopThread() and autodetect(), don't use them after these calls.
+     */
+    std::shared_ptr <const ServoSnapshot> getServoSnapshot() const;
 };
 
 /** @}*/
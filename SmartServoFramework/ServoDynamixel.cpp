@@ -56,9 +56,8 @@ ServoDynamixel::ServoDynamixel(const int control_table[][8], int dynamixel_id, i
         }
     }
 
-    // Init register tables (value and commit info) with value-initialization
-    registerTableValues = new int [registerTableSize]();
-    registerTableCommits = new int [registerTableSize]();
+    // Init register table with value-initialization
+    registerTableValues = new std::atomic <int> [registerTableSize]();
 
     // Set model and id because we already known them
     registerTableValues[gid(REG_MODEL_NUMBER)] = dynamixel_model;
@@ -85,12 +84,6 @@ ServoDynamixel::~ServoDynamixel()
         delete [] registerTableValues;
         registerTableValues = nullptr;
     }
-
-    if (registerTableCommits != nullptr)
-    {
-        delete [] registerTableCommits;
-        registerTableCommits = nullptr;
-    }
 }
 
 /* ************************************************************************** */
@@ -102,33 +95,32 @@ void ServoDynamixel::status()
     TRACE_INFO(DXL, "Status(#%i)", servoId);
 
     TRACE_INFO(DXL, "> model      : %i", servoModel);
-    TRACE_INFO(DXL, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)]);
-    TRACE_INFO(DXL, "> baudrate   : %i", dxl_get_baudrate(registerTableValues[gid(REG_BAUD_RATE)]));
+    TRACE_INFO(DXL, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)].load());
+    TRACE_INFO(DXL, "> baudrate   : %i", dxl_get_baudrate(registerTableValues[gid(REG_BAUD_RATE)].load()));
 
     TRACE_INFO(DXL, ">> speed mode     : %i", speedMode);
     TRACE_INFO(DXL, ">> steps          : %i", steps);
     TRACE_INFO(DXL, ">> runningDegrees : %i", runningDegrees);
 
-    TRACE_INFO(DXL, "> torque enabled  : %i", registerTableValues[gid(REG_TORQUE_ENABLE)]);
-    TRACE_INFO(DXL, "> max torque      : %i", registerTableValues[gid(REG_MAX_TORQUE)]);
-    TRACE_INFO(DXL, "> torque limit    : %i", registerTableValues[gid(REG_TORQUE_LIMIT)]);
+    TRACE_INFO(DXL, "> torque enabled  : %i", registerTableValues[gid(REG_TORQUE_ENABLE)].load());
+    TRACE_INFO(DXL, "> max torque      : %i", registerTableValues[gid(REG_MAX_TORQUE)].load());
+    TRACE_INFO(DXL, "> torque limit    : %i", registerTableValues[gid(REG_TORQUE_LIMIT)].load());
 
-    TRACE_INFO(DXL, "> goal position   : %i", registerTableValues[gid(REG_GOAL_POSITION)]);
-    TRACE_INFO(DXL, "> goal speed      : %i", registerTableValues[gid(REG_GOAL_SPEED)]);
-    TRACE_INFO(DXL, "> current position: %i", registerTableValues[gid(REG_CURRENT_POSITION)]);
-    TRACE_INFO(DXL, "> current speed   : %i", registerTableValues[gid(REG_CURRENT_SPEED)]);
-    TRACE_INFO(DXL, "> current load    : %i", registerTableValues[gid(REG_CURRENT_LOAD)]);
-    TRACE_INFO(DXL, "> current voltage : %i", registerTableValues[gid(REG_CURRENT_VOLTAGE)]);
-    TRACE_INFO(DXL, "> current temp    : %i", registerTableValues[gid(REG_CURRENT_TEMPERATURE)]);
-    TRACE_INFO(DXL, "> registered      : %i", registerTableValues[gid(REG_REGISTERED)]);
-    TRACE_INFO(DXL, "> moving          : %i", registerTableValues[gid(REG_MOVING)]);
-    TRACE_INFO(DXL, "> lock            : %i", registerTableValues[gid(REG_LOCK)]);
-    TRACE_INFO(DXL, "> punch           : %i", registerTableValues[gid(REG_PUNCH)]);
+    TRACE_INFO(DXL, "> goal position   : %i", registerTableValues[gid(REG_GOAL_POSITION)].load());
+    TRACE_INFO(DXL, "> goal speed      : %i", registerTableValues[gid(REG_GOAL_SPEED)].load());
+    TRACE_INFO(DXL, "> current position: %i", registerTableValues[gid(REG_CURRENT_POSITION)].load());
+    TRACE_INFO(DXL, "> current speed   : %i", registerTableValues[gid(REG_CURRENT_SPEED)].load());
+    TRACE_INFO(DXL, "> current load    : %i", registerTableValues[gid(REG_CURRENT_LOAD)].load());
+    TRACE_INFO(DXL, "> current voltage : %i", registerTableValues[gid(REG_CURRENT_VOLTAGE)].load());
+    TRACE_INFO(DXL, "> current temp    : %i", registerTableValues[gid(REG_CURRENT_TEMPERATURE)].load());
+    TRACE_INFO(DXL, "> registered      : %i", registerTableValues[gid(REG_REGISTERED)].load());
+    TRACE_INFO(DXL, "> moving          : %i", registerTableValues[gid(REG_MOVING)].load());
+    TRACE_INFO(DXL, "> lock            : %i", registerTableValues[gid(REG_LOCK)].load());
+    TRACE_INFO(DXL, "> punch           : %i", registerTableValues[gid(REG_PUNCH)].load());
 }
 
 std::string ServoDynamixel::getModelString()
 {
-    std::lock_guard <std::mutex> lock(access);
     return dxl_get_model_name(registerTableValues[gid(REG_MODEL_NUMBER)]);
 }
 
@@ -207,19 +199,16 @@ int ServoDynamixel::getBaudRate()
 
 int ServoDynamixel::getReturnDelay()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_RETURN_DELAY_TIME)];
 }
 
 double ServoDynamixel::getHighestLimitTemp()
 {
-    std::lock_guard <std::mutex> lock(access);
     return static_cast<double>(registerTableValues[gid(REG_TEMPERATURE_LIMIT)]);
 }
 
 double ServoDynamixel::getLowestLimitVolt()
 {
-    std::lock_guard <std::mutex> lock(access);
     int volt = registerTableValues[gid(REG_VOLTAGE_LOWEST_LIMIT)];
 
     return (volt / 10.0);
@@ -227,7 +216,6 @@ double ServoDynamixel::getLowestLimitVolt()
 
 double ServoDynamixel::getHighestLimitVolt()
 {
-    std::lock_guard <std::mutex> lock(access);
     int volt = registerTableValues[gid(REG_VOLTAGE_HIGHEST_LIMIT)];
 
     return (volt / 10.0);
@@ -235,49 +223,41 @@ double ServoDynamixel::getHighestLimitVolt()
 
 int ServoDynamixel::getMaxTorque()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MAX_TORQUE)];
 }
 
 int ServoDynamixel::getGoalPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_GOAL_POSITION)];
 }
 
 int ServoDynamixel::getMovingSpeed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_GOAL_SPEED)];
 }
 
 int ServoDynamixel::getTorqueLimit()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_TORQUE_LIMIT)];
 }
 
 int ServoDynamixel::getCurrentPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_POSITION)];
 }
 
 int ServoDynamixel::getCurrentSpeed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_SPEED)];
 }
 
 int ServoDynamixel::getCurrentLoad()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_LOAD)];
 }
 
 double ServoDynamixel::getCurrentVoltage()
 {
-    std::lock_guard <std::mutex> lock(access);
     int ivolt = registerTableValues[gid(REG_CURRENT_VOLTAGE)];
 
     return (ivolt / 10.0);
@@ -285,31 +265,26 @@ double ServoDynamixel::getCurrentVoltage()
 
 double ServoDynamixel::getCurrentTemperature()
 {
-    std::lock_guard <std::mutex> lock(access);
     return static_cast<double>(registerTableValues[gid(REG_CURRENT_TEMPERATURE)]);
 }
 
 int ServoDynamixel::getRegistered()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_REGISTERED)];
 }
 
 int ServoDynamixel::getMoving()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MOVING)];
 }
 
 int ServoDynamixel::getLock()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_LOCK)];
 }
 
 int ServoDynamixel::getPunch()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_PUNCH)];
 }
 
@@ -321,11 +296,11 @@ void ServoDynamixel::setId(int id)
 
     if (id > -1 && id < 254)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Maybe check if new ID is not already in use ?
         registerTableValues[gid(REG_ID)] = id;
-        registerTableCommits[gid(REG_ID)] = 1;
+        markCommit(registerTableCommits, gid(REG_ID));
     }
 }
 
@@ -335,10 +310,10 @@ void ServoDynamixel::setCWLimit(int limit)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MIN_POSITION)] = limit;
-        registerTableCommits[gid(REG_MIN_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MIN_POSITION));
     }
 }
 
@@ -348,10 +323,10 @@ void ServoDynamixel::setCCWLimit(int limit)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MAX_POSITION)] = limit;
-        registerTableCommits[gid(REG_MAX_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MAX_POSITION));
     }
 }
 
@@ -361,7 +336,7 @@ void ServoDynamixel::setGoalPosition(int pos)
 
     if (pos > -1 && pos < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Check min/max positions
         if (pos < registerTableValues[gid(REG_MIN_POSITION)])
@@ -375,11 +350,11 @@ void ServoDynamixel::setGoalPosition(int pos)
 
         // Set position
         registerTableValues[gid(REG_GOAL_POSITION)] = pos;
-        registerTableCommits[gid(REG_GOAL_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_GOAL_POSITION));
     }
     else
     {
-        TRACE_ERROR(DXL, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)], pos);
+        TRACE_ERROR(DXL, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)].load(), pos);
     }
 }
 
@@ -391,7 +366,7 @@ void ServoDynamixel::setGoalPosition(int pos, int time_budget_ms)
     {
         if (pos > -1 && pos < steps)
         {
-            std::lock_guard <std::mutex> lock(access);
+            TableWriteLock lock(*this);
 
             // Check min/max positions
             if (pos < registerTableValues[gid(REG_MIN_POSITION)])
@@ -418,14 +393,14 @@ void ServoDynamixel::setGoalPosition(int pos, int time_budget_ms)
 
             // Set position and speed
             registerTableValues[gid(REG_GOAL_POSITION)] = pos;
-            registerTableCommits[gid(REG_GOAL_POSITION)] = 1;
+            markCommit(registerTableCommits, gid(REG_GOAL_POSITION));
 
             registerTableValues[gid(REG_GOAL_SPEED)] = static_cast<int>(speed);
-            registerTableCommits[gid(REG_GOAL_SPEED)] = 1;
+            markCommit(registerTableCommits, gid(REG_GOAL_SPEED));
         }
         else
         {
-            TRACE_ERROR(DXL, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)], pos);
+            TRACE_ERROR(DXL, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)].load(), pos);
         }
     }
 }
@@ -459,7 +434,7 @@ void ServoDynamixel::setMovingSpeed(int speed)
 {
     TRACE_1(DXL, "[#%i] setMovingSpeed(%i)", servoId, speed);
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
 
     if (registerTableValues[gid(REG_MIN_POSITION)] == 0 &&
         registerTableValues[gid(REG_MAX_POSITION)] == 0)
@@ -467,7 +442,7 @@ void ServoDynamixel::setMovingSpeed(int speed)
         if (speed < 2048)
         {
             registerTableValues[gid(REG_GOAL_SPEED)] = speed;
-            registerTableCommits[gid(REG_GOAL_SPEED)] = 1;
+            markCommit(registerTableCommits, gid(REG_GOAL_SPEED));
         }
     }
     else
@@ -475,7 +450,7 @@ void ServoDynamixel::setMovingSpeed(int speed)
         if (speed < 1024)
         {
             registerTableValues[gid(REG_GOAL_SPEED)] = speed;
-            registerTableCommits[gid(REG_GOAL_SPEED)] = 1;
+            markCommit(registerTableCommits, gid(REG_GOAL_SPEED));
         }
     }
 }
@@ -486,10 +461,10 @@ void ServoDynamixel::setMaxTorque(int torque)
 
     if (torque < 1024)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MAX_TORQUE)] = torque;
-        registerTableCommits[gid(REG_MAX_TORQUE)] = 1;
+        markCommit(registerTableCommits, gid(REG_MAX_TORQUE));
     }
 }
 
@@ -508,10 +483,10 @@ void ServoDynamixel::setLed(int led)
         led = 0;
     }
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
 
     registerTableValues[gid(REG_LED)] = led;
-    registerTableCommits[gid(REG_LED)] = 1;
+    markCommit(registerTableCommits, gid(REG_LED));
 }
 
 void ServoDynamixel::setTorqueEnabled(int torque)
@@ -521,8 +496,8 @@ void ServoDynamixel::setTorqueEnabled(int torque)
     // Normalize value
     (torque > 0) ? torque = 1 : torque = 0;
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
 
     registerTableValues[gid(REG_TORQUE_ENABLE)] = torque;
-    registerTableCommits[gid(REG_TORQUE_ENABLE)] = 1;
+    markCommit(registerTableCommits, gid(REG_TORQUE_ENABLE));
 }
@@ -52,36 +52,30 @@ ServoEX::~ServoEX()
 
 int ServoEX::getDriveMode()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_DRIVE_MODE)];
 }
 
 int ServoEX::getCwComplianceMargin()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CW_COMPLIANCE_MARGIN)];
 }
 
 int ServoEX::getCcwComplianceMargin()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CCW_COMPLIANCE_MARGIN)];
 }
 
 int ServoEX::getCwComplianceSlope()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CW_COMPLIANCE_SLOPE)];
 }
 
 int ServoEX::getCcwComplianceSlope()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CCW_COMPLIANCE_SLOPE)];
 }
 
 int ServoEX::getSensedCurrent()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_CURRENT)];
 }
@@ -55,13 +55,11 @@ ServoHerkuleX::ServoHerkuleX(const int control_table[][8], int herkulex_id, int
         }
     }
 
-    // Init register tables (value and commit info) with value-initialization
-    registerTableValues = new int [registerTableSize]();
-    registerTableCommits = new int [registerTableSize]();
+    // Init register table with value-initialization
+    registerTableValues = new std::atomic <int> [registerTableSize]();
 
     // New table to support "dual value ROM/RAM registers"
-    registerTableValuesRAM = new int [registerTableSize]();
-    registerTableCommitsRAM = new int [registerTableSize]();
+    registerTableValuesRAM = new std::atomic <int> [registerTableSize]();
 
     gotopos = 0;
     gotopos_commit = 0;
@@ -87,23 +85,11 @@ ServoHerkuleX::~ServoHerkuleX()
         registerTableValues = nullptr;
     }
 
-    if (registerTableCommits != nullptr)
-    {
-        delete [] registerTableCommits;
-        registerTableCommits = nullptr;
-    }
-
     if (registerTableValuesRAM != nullptr)
     {
         delete [] registerTableValuesRAM;
         registerTableValuesRAM = nullptr;
     }
-
-    if (registerTableCommitsRAM != nullptr)
-    {
-        delete [] registerTableCommitsRAM;
-        registerTableCommitsRAM = nullptr;
-    }
 }
 
 /* ************************************************************************** */
@@ -115,38 +101,36 @@ void ServoHerkuleX::status()
     TRACE_INFO(HKX, "Status(#%i)", servoId);
 
     TRACE_INFO(HKX, "> model      : %i", servoModel);
-    TRACE_INFO(HKX, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)]);
-    TRACE_INFO(HKX, "> baudrate   : %i", hkx_get_baudrate(registerTableValues[gid(REG_BAUD_RATE)]));
+    TRACE_INFO(HKX, "> firmware   : %i", registerTableValues[gid(REG_FIRMWARE_VERSION)].load());
+    TRACE_INFO(HKX, "> baudrate   : %i", hkx_get_baudrate(registerTableValues[gid(REG_BAUD_RATE)].load()));
 
     TRACE_INFO(HKX, ">> steps          : %i", steps);
     TRACE_INFO(HKX, ">> runningDegrees : %i", runningDegrees);
 
-    TRACE_INFO(HKX, "> torque enabled  : %i", registerTableValues[gid(REG_TORQUE_ENABLE)]);
-    TRACE_INFO(HKX, "> max torque      : %i", registerTableValues[gid(REG_MAX_TORQUE)]);
-    TRACE_INFO(HKX, "> torque limit    : %i", registerTableValues[gid(REG_TORQUE_LIMIT)]);
+    TRACE_INFO(HKX, "> torque enabled  : %i", registerTableValues[gid(REG_TORQUE_ENABLE)].load());
+    TRACE_INFO(HKX, "> max torque      : %i", registerTableValues[gid(REG_MAX_TORQUE)].load());
+    TRACE_INFO(HKX, "> torque limit    : %i", registerTableValues[gid(REG_TORQUE_LIMIT)].load());
 
-    TRACE_INFO(HKX, "> goal position   : %i", registerTableValues[gid(REG_GOAL_POSITION)]);
-    TRACE_INFO(HKX, "> goal speed      : %i", registerTableValues[gid(REG_GOAL_SPEED)]);
-    TRACE_INFO(HKX, "> current position: %i", registerTableValues[gid(REG_CURRENT_POSITION)]);
-    TRACE_INFO(HKX, "> current speed   : %i", registerTableValues[gid(REG_CURRENT_SPEED)]);
-    TRACE_INFO(HKX, "> current load    : %i", registerTableValues[gid(REG_CURRENT_LOAD)]);
-    TRACE_INFO(HKX, "> current voltage : %i", registerTableValues[gid(REG_CURRENT_VOLTAGE)]);
-    TRACE_INFO(HKX, "> current temp    : %i", registerTableValues[gid(REG_CURRENT_TEMPERATURE)]);
-    TRACE_INFO(HKX, "> registered      : %i", registerTableValues[gid(REG_REGISTERED)]);
-    TRACE_INFO(HKX, "> moving          : %i", registerTableValues[gid(REG_MOVING)]);
-    TRACE_INFO(HKX, "> lock            : %i", registerTableValues[gid(REG_LOCK)]);
-    TRACE_INFO(HKX, "> punch           : %i", registerTableValues[gid(REG_PUNCH)]);
+    TRACE_INFO(HKX, "> goal position   : %i", registerTableValues[gid(REG_GOAL_POSITION)].load());
+    TRACE_INFO(HKX, "> goal speed      : %i", registerTableValues[gid(REG_GOAL_SPEED)].load());
+    TRACE_INFO(HKX, "> current position: %i", registerTableValues[gid(REG_CURRENT_POSITION)].load());
+    TRACE_INFO(HKX, "> current speed   : %i", registerTableValues[gid(REG_CURRENT_SPEED)].load());
+    TRACE_INFO(HKX, "> current load    : %i", registerTableValues[gid(REG_CURRENT_LOAD)].load());
+    TRACE_INFO(HKX, "> current voltage : %i", registerTableValues[gid(REG_CURRENT_VOLTAGE)].load());
+    TRACE_INFO(HKX, "> current temp    : %i", registerTableValues[gid(REG_CURRENT_TEMPERATURE)].load());
+    TRACE_INFO(HKX, "> registered      : %i", registerTableValues[gid(REG_REGISTERED)].load());
+    TRACE_INFO(HKX, "> moving          : %i", registerTableValues[gid(REG_MOVING)].load());
+    TRACE_INFO(HKX, "> lock            : %i", registerTableValues[gid(REG_LOCK)].load());
+    TRACE_INFO(HKX, "> punch           : %i", registerTableValues[gid(REG_PUNCH)].load());
 }
 
 std::string ServoHerkuleX::getModelString()
 {
-    std::lock_guard <std::mutex> lock(access);
     return hkx_get_model_name(registerTableValues[gid(REG_MODEL_NUMBER)]);
 }
 
 void ServoHerkuleX::getModelInfos(int &servo_serie, int &servo_model)
 {
-    std::lock_guard <std::mutex> lock(access);
     int model_number = registerTableValues[gid(REG_MODEL_NUMBER)];
 
     hkx_get_model_infos(model_number, servo_serie, servo_model);
@@ -186,8 +170,6 @@ int ServoHerkuleX::getBaudRate()
 
 int ServoHerkuleX::getCwAngleLimit(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_MIN_POSITION)];
     else
@@ -196,8 +178,6 @@ int ServoHerkuleX::getCwAngleLimit(const int reg_type)
 
 int ServoHerkuleX::getCcwAngleLimit(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_MAX_POSITION)];
     else
@@ -211,7 +191,6 @@ double ServoHerkuleX::getHighestLimitTemp()
 
 double ServoHerkuleX::getHighestLimitTemp(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
     int temp = 0;
 
     if (reg_type == REGISTER_RAM)
@@ -230,7 +209,6 @@ double ServoHerkuleX::getLowestLimitVolt()
 
 double ServoHerkuleX::getLowestLimitVolt(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
     int volt = 0;
 
     if (reg_type == REGISTER_RAM)
@@ -248,7 +226,6 @@ double ServoHerkuleX::getHighestLimitVolt()
 
 double ServoHerkuleX::getHighestLimitVolt(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
     int volt = 0;
 
     if (reg_type == REGISTER_RAM)
@@ -261,14 +238,11 @@ double ServoHerkuleX::getHighestLimitVolt(const int reg_type)
 /*
 int ServoHerkuleX::getMaxTorque()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(SERVO_MAX_TORQUE)];
 }
 */
 int ServoHerkuleX::getStatusReturnLevel(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_STATUS_RETURN_LEVEL)];
     else
@@ -277,8 +251,6 @@ int ServoHerkuleX::getStatusReturnLevel(const int reg_type)
 
 int ServoHerkuleX::getAlarmLed(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_ALARM_LED)];
     else
@@ -287,8 +259,6 @@ int ServoHerkuleX::getAlarmLed(const int reg_type)
 
 int ServoHerkuleX::getAlarmShutdown(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_ALARM_SHUTDOWN)];
     else
@@ -297,14 +267,11 @@ int ServoHerkuleX::getAlarmShutdown(const int reg_type)
 
 int ServoHerkuleX::getLed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValuesRAM[gid(REG_LED)];
 }
 
 int ServoHerkuleX::getTorqueEnabled(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_TORQUE_ENABLE)];
     else
@@ -313,8 +280,6 @@ int ServoHerkuleX::getTorqueEnabled(const int reg_type)
 
 int ServoHerkuleX::getDGain(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_D_GAIN)];
     else
@@ -323,8 +288,6 @@ int ServoHerkuleX::getDGain(const int reg_type)
 
 int ServoHerkuleX::getIGain(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_I_GAIN)];
     else
@@ -333,8 +296,6 @@ int ServoHerkuleX::getIGain(const int reg_type)
 
 int ServoHerkuleX::getPGain(const int reg_type)
 {
-    std::lock_guard <std::mutex> lock(access);
-
     if (reg_type == REGISTER_RAM)
         return registerTableValuesRAM[gid(REG_P_GAIN)];
     else
@@ -343,55 +304,49 @@ int ServoHerkuleX::getPGain(const int reg_type)
 
 int ServoHerkuleX::getGoalPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     return gotopos;
 }
 
 int ServoHerkuleX::getGoalPositionCommited()
 {
-    std::lock_guard <std::mutex> lock(access);
     return gotopos_commit;
 }
 
 void ServoHerkuleX::commitGoalPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     gotopos_commit = 0;
+    commandsSent = 1;
 }
 
 int ServoHerkuleX::getMovingSpeed()
 {
-    std::lock_guard <std::mutex> lock(access);
     return 0; // FIXME // registerTableValues[gid(SERVO_GOAL_SPEED)];
 }
 /*
 int ServoHerkuleX::getTorqueLimit()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(SERVO_TORQUE_LIMIT)];
 }
 */
 int ServoHerkuleX::getCurrentPosition()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValuesRAM[gid(REG_ABSOLUTE_POSITION)];
 }
-/*
+
 int ServoHerkuleX::getCurrentSpeed()
 {
-    std::lock_guard <std::mutex> lock(access);
-    return registerTableValues[gid(SERVO_CURRENT_SPEED)];
+    // Position change over the last 11.2 ms, the closest HerkuleX has to a speed
+    return registerTableValuesRAM[gid(REG_DIFFERENTIAL_POSITION)];
 }
 
 int ServoHerkuleX::getCurrentLoad()
 {
-    std::lock_guard <std::mutex> lock(access);
-    return registerTableValues[gid(SERVO_CURRENT_LOAD)];
+    // PWM output, the closest HerkuleX has to a load
+    return registerTableValuesRAM[gid(REG_PWM)];
 }
-*/
+
 double ServoHerkuleX::getCurrentVoltage()
 {
-    std::lock_guard <std::mutex> lock(access);
     int volt = registerTableValuesRAM[gid(REG_CURRENT_VOLTAGE)];
 
     return (volt * 0.074074);
@@ -399,7 +354,6 @@ double ServoHerkuleX::getCurrentVoltage()
 
 double ServoHerkuleX::getCurrentTemperature()
 {
-    std::lock_guard <std::mutex> lock(access);
     int temp = registerTableValuesRAM[gid(REG_CURRENT_TEMPERATURE)];
 
     // FIXME temperature is using a non linear scale
@@ -408,8 +362,8 @@ double ServoHerkuleX::getCurrentTemperature()
 
 int ServoHerkuleX::getMoving()
 {
-    //std::lock_guard <std::mutex> lock(access);
-    return 0;//registerTableValues[gid(SERVO_MOVING)];
+    // No moving register: use the status detail byte of the last ACK packet
+    return (statusDetail & STATBIT_MOVING) ? 1 : 0;
 }
 
 /* ************************************************************************** */
@@ -421,11 +375,11 @@ void ServoHerkuleX::setId(int id)
     // TODO use maxId
     if (id > -1 && id < 254)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Maybe check if new ID is not already in use ?
         registerTableValues[gid(REG_ID)] = id;
-        registerTableCommits[gid(REG_ID)] = 1;
+        markCommit(registerTableCommits, gid(REG_ID));
     }
 }
 
@@ -435,10 +389,10 @@ void ServoHerkuleX::setCWLimit(int limit, const int reg_type)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MIN_POSITION)] = limit;
-        registerTableCommits[gid(REG_MIN_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MIN_POSITION));
     }
 }
 
@@ -448,10 +402,10 @@ void ServoHerkuleX::setCCWLimit(int limit, const int reg_type)
 
     if (limit > -1 && limit < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(REG_MAX_POSITION)] = limit;
-        registerTableCommits[gid(REG_MAX_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(REG_MAX_POSITION));
     }
 }
 
@@ -461,14 +415,13 @@ void ServoHerkuleX::setGoalPosition(int pos)
 
     if (pos > -1 && pos < steps)
     {
-        std::lock_guard <std::mutex> lock(access);
-
+        // The position is stored before it's flagged, so the controller never sends a stale one
         gotopos = pos;
         gotopos_commit = 1;
     }
     else
     {
-        TRACE_ERROR(HKX, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)], pos);
+        TRACE_ERROR(HKX, "[#%i] setGoalPosition(%i > %i) [VALUE ERROR]", servoId, registerTableValues[gid(REG_CURRENT_POSITION)].load(), pos);
     }
 }
 
@@ -497,10 +450,10 @@ void ServoHerkuleX::setLed(int led)
         color = 0;
     }
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
 
     registerTableValuesRAM[gid(REG_LED)] = color;
-    registerTableCommitsRAM[gid(REG_LED)] = 1;
+    markCommit(registerTableCommitsRAM, gid(REG_LED));
 }
 
 void ServoHerkuleX::setTorqueEnabled(int torque)
@@ -516,10 +469,10 @@ void ServoHerkuleX::setTorqueEnabled(int torque)
     // Valid torque are in range [0:254]
     if (torque == 0x00 || torque == 0x40 || torque == 0x60)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValuesRAM[gid(REG_TORQUE_ENABLE)] = torque;
-        registerTableCommitsRAM[gid(REG_TORQUE_ENABLE)] = 1;
+        markCommit(registerTableCommitsRAM, gid(REG_TORQUE_ENABLE));
     }
     else
     {
@@ -532,7 +485,7 @@ void ServoHerkuleX::moveGoalPosition(int move)
 /*
     TRACE_1(HKX, "[#%i] moveGoalPosition(%i)", servoId, move);
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
     int curr = registerTableValues[gid(SERVO_CURRENT_POSITION)];
     int newpos = registerTableValues[gid(SERVO_CURRENT_POSITION)] + move;
 
@@ -550,7 +503,7 @@ void ServoHerkuleX::moveGoalPosition(int move)
     if (newpos > 0 && newpos < steps)
     {
         registerTableValues[gid(SERVO_GOAL_POSITION)] = registerTableValues[gid(SERVO_CURRENT_POSITION)] + move;
-        registerTableCommits[gid(SERVO_GOAL_POSITION)] = 1;
+        markCommit(registerTableCommits, gid(SERVO_GOAL_POSITION));
     }
     else
     {
@@ -563,7 +516,7 @@ void ServoHerkuleX::setMovingSpeed(int speed)
 {
     TRACE_1(HKX, "[#%i] setMovingSpeed(%i)", servoId, speed);
 
-    std::lock_guard <std::mutex> lock(access);
+    TableWriteLock lock(*this);
 
     if (registerTableValues[gid(SERVO_MIN_POSITION)] == 0 &&
         registerTableValues[gid(SERVO_MAX_POSITION)] == 0)
@@ -571,7 +524,7 @@ void ServoHerkuleX::setMovingSpeed(int speed)
         if (speed < 2048)
         {
             registerTableValues[gid(SERVO_GOAL_SPEED)] = speed;
-            registerTableCommits[gid(SERVO_GOAL_SPEED)] = 1;
+            markCommit(registerTableCommits, gid(SERVO_GOAL_SPEED));
         }
     }
     else
@@ -579,7 +532,7 @@ void ServoHerkuleX::setMovingSpeed(int speed)
         if (speed < 1024)
         {
             registerTableValues[gid(SERVO_GOAL_SPEED)] = speed;
-            registerTableCommits[gid(SERVO_GOAL_SPEED)] = 1;
+            markCommit(registerTableCommits, gid(SERVO_GOAL_SPEED));
         }
     }
 }
@@ -590,10 +543,10 @@ void ServoHerkuleX::setMaxTorque(int torque)
 
     if (torque < 1024)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         registerTableValues[gid(SERVO_MAX_TORQUE)] = torque;
-        registerTableCommits[gid(SERVO_MAX_TORQUE)] = 1;
+        markCommit(registerTableCommits, gid(SERVO_MAX_TORQUE));
     }
 }
 */
@@ -619,8 +572,6 @@ int ServoHerkuleX::getValue(int reg_name, int reg_type)
                     reg_type = REGISTER_RAM;
             }
 
-            std::lock_guard <std::mutex> lock(access);
-
             // Get value
             if (reg_type == REGISTER_RAM)
                 value = registerTableValuesRAM[infos.reg_index];
@@ -660,16 +611,14 @@ int ServoHerkuleX::getValueCommit(int reg_name, int reg_type)
                     reg_type = REGISTER_RAM;
             }
 
-            std::lock_guard <std::mutex> lock(access);
-
             // Get value
             if (reg_type == REGISTER_ROM)
             {
-                commit = registerTableCommits[infos.reg_index];
+                commit = static_cast<int>((registerTableCommits.load() >> infos.reg_index) & 1);
             }
             else // RAM is set to default fallback
             {
-                commit = registerTableCommitsRAM[infos.reg_index];
+                commit = static_cast<int>((registerTableCommitsRAM.load() >> infos.reg_index) & 1);
             }
         }
         else
@@ -701,7 +650,7 @@ void ServoHerkuleX::setValue(int reg_name, int reg_value, int reg_type)
                 // Check value
                 if (reg_value >= infos.reg_value_min && reg_value <= infos.reg_value_max)
                 {
-                    std::lock_guard <std::mutex> lock(access);
+                    TableWriteLock lock(*this);
 
                     if (reg_type == REGISTER_AUTO)
                     {
@@ -717,13 +666,13 @@ void ServoHerkuleX::setValue(int reg_name, int reg_value, int reg_type)
                     if (reg_type == REGISTER_ROM || reg_type == REGISTER_BOTH)
                     {
                         registerTableValues[infos.reg_index] = reg_value;
-                        registerTableCommits[infos.reg_index] = 1;
+                        markCommit(registerTableCommits, infos.reg_index);
                     }
 
                     if (reg_type == REGISTER_RAM || reg_type == REGISTER_BOTH)
                     {
                         registerTableValuesRAM[infos.reg_index] = reg_value;
-                        registerTableCommitsRAM[infos.reg_index] = 1;
+                        markCommit(registerTableCommitsRAM, infos.reg_index);
                     }
                 }
                 else
@@ -748,7 +697,7 @@ void ServoHerkuleX::setValue(int reg_name, int reg_value, int reg_type)
     }
 }
 
-void ServoHerkuleX::updateValue(int reg_name, int reg_value, int reg_type)
+void ServoHerkuleX::updateValue_internal(int reg_name, int reg_value, int reg_type)
 {
     // Find register's informations (addr, size...)
     RegisterInfos infos = {-1, -1, -1, -1, -1, -1, -1, -1, -1};
@@ -759,8 +708,6 @@ void ServoHerkuleX::updateValue(int reg_name, int reg_value, int reg_type)
             // Check value
             if (reg_value >= infos.reg_value_min && reg_value <= infos.reg_value_max)
             {
-                std::lock_guard <std::mutex> lock(access);
-
                 if (reg_type == REGISTER_AUTO)
                 {
                     if (infos.reg_addr_rom >= 0 && infos.reg_addr_ram >= 0)
@@ -781,6 +728,8 @@ void ServoHerkuleX::updateValue(int reg_name, int reg_value, int reg_type)
                 {
                     registerTableValuesRAM[infos.reg_index] = reg_value;
                 }
+
+                markCommit(registerTableUpdates, infos.reg_index);
             }
             else
             {
@@ -837,12 +786,12 @@ void ServoHerkuleX::commitValue(int reg_name, int commit, int reg_type)
                 // Set commit(s)
                 if (reg_type == REGISTER_RAM)
                 {
-                    registerTableCommitsRAM[infos.reg_index] = commit;
+                    markCommit(registerTableCommitsRAM, infos.reg_index, commit);
                 }
 
                 if (reg_type == REGISTER_ROM)
                 {
-                    registerTableCommits[infos.reg_index] = commit;
+                    markCommit(registerTableCommits, infos.reg_index, commit);
                 }
             }
             else
@@ -860,3 +809,55 @@ void ServoHerkuleX::commitValue(int reg_name, int commit, int reg_type)
         TRACE_ERROR(HKX, "[#%i] commitValue(reg %i / %s) [REGISTER NAME ERROR]", servoId, reg_name, getRegisterNameTxt(reg_name).c_str());
     }
 }
+
+/* ************************************************************************** */
+
+uint64_t ServoHerkuleX::takeCommits(int reg_type)
+{
+    uint64_t commits = 0;
+
+    if (reg_type == REGISTER_RAM)
+    {
+        commits = registerTableCommitsRAM.exchange(0);
+    }
+    else
+    {
+        commits = registerTableCommits.exchange(0);
+    }
+
+    if (commits)
+    {
+        commandsSent = 1;
+    }
+
+    return commits;
+}
+
+void ServoHerkuleX::restoreCommits(const uint64_t commits, int reg_type)
+{
+    if (reg_type == REGISTER_RAM)
+    {
+        registerTableCommitsRAM.fetch_or(commits);
+    }
+    else
+    {
+        registerTableCommits.fetch_or(commits);
+    }
+}
+
+bool ServoHerkuleX::hasPendingCommits()
+{
+    std::lock_guard <std::mutex> lock(access);
+    return registerTableCommits != 0 || registerTableCommitsRAM != 0 || gotopos_commit != 0;
+}
+
+uint64_t ServoHerkuleX::getPositionCycle()
+{
+    return getFeedbackCycle(REG_ABSOLUTE_POSITION);
+}
+
+uint64_t ServoHerkuleX::getMovingCycle()
+{
+    // The 'moving' bit comes with the status of every ACK
+    return getStatusCycle();
+}
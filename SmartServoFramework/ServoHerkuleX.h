@@ -47,11 +47,13 @@
 class ServoHerkuleX: public Servo
 {
 protected:
-    int *registerTableValuesRAM; //!< New table used to support "dual value (ROM/RAM) registers" values
-    int *registerTableCommitsRAM; //!< New table used to support "dual value (ROM/RAM) registers" commits
+    std::atomic <int> *registerTableValuesRAM; //!< New table used to support "dual value (ROM/RAM) registers" values
+    std::atomic <uint64_t> registerTableCommitsRAM {0}; //!< New bitmap used to support "dual value (ROM/RAM) registers" commits
 
-    int gotopos;
-    int gotopos_commit;
+    std::atomic <int> gotopos {0};
+    std::atomic <int> gotopos_commit {0};
+
+    void updateValue_internal(const int reg, int value, int reg_type);
 
 public:
     ServoHerkuleX(const int control_table[][8], int herkulex_id, int herkulex_model, int speed_mode = 0);
@@ -122,8 +124,14 @@ public:
     int getValueCommit(const int reg, int reg_type = REGISTER_AUTO);
 
     void setValue(const int reg, int value, int reg_type = REGISTER_AUTO);
-    void updateValue(const int reg, int value, int reg_type = REGISTER_AUTO);
     void commitValue(const int reg, int commit, int reg_type = REGISTER_AUTO);
+
+    uint64_t takeCommits(int reg_type = REGISTER_AUTO);
+    void restoreCommits(const uint64_t commits, int reg_type = REGISTER_AUTO);
+    bool hasPendingCommits();
+
+    uint64_t getPositionCycle();
+    uint64_t getMovingCycle();
 };
 
 /** @}*/
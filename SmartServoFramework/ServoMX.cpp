@@ -44,60 +44,50 @@ ServoMX::~ServoMX()
 
 int ServoMX::getDriveMode()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_DRIVE_MODE)];
 }
 
 int ServoMX::getMultiTurnOffset()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_MULTI_TURN_OFFSET)];
 }
 
 int ServoMX::getResolutionDivider()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_RESOLUTION_DIVIDER)];
 }
 
 int ServoMX::getDGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_D_GAIN)];
 }
 
 int ServoMX::getIGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_I_GAIN)];
 }
 
 int ServoMX::getPGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_P_GAIN)];
 }
 
 int ServoMX::getConsumingCurrent()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CURRENT_CURRENT)];
 }
 
 int ServoMX::getTorqueControlMode()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CONTROL_MODE)];
 }
 
 int ServoMX::getGoalTorque()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_GOAL_TORQUE)];
 }
 
 int ServoMX::getGoalAccel()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_GOAL_ACCELERATION)];
 }
@@ -68,31 +68,26 @@ void ServoX::setLock()
 
 int ServoX::getControlMode()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CONTROL_MODE)];
 }
 
 int ServoX::getDGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_D_GAIN)];
 }
 
 int ServoX::getIGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_I_GAIN)];
 }
 
 int ServoX::getPGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_P_GAIN)];
 }
 
 int ServoX::getHardwareErrorStatus()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_HW_ERROR_STATUS)];
 }
 
@@ -104,11 +99,11 @@ void ServoX::setId(int id)
 
     if (id > -1 && id < 253)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Maybe check if new ID is not already in use ?
         registerTableValues[gid(REG_ID)] = id;
-        registerTableCommits[gid(REG_ID)] = 1;
+        markCommit(registerTableCommits, gid(REG_ID));
     }
 }
 
@@ -68,37 +68,31 @@ void ServoXL::setLock()
 
 int ServoXL::getControlMode()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_CONTROL_MODE)];
 }
 
 int ServoXL::getDGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_D_GAIN)];
 }
 
 int ServoXL::getIGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_I_GAIN)];
 }
 
 int ServoXL::getPGain()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_P_GAIN)];
 }
 
 int ServoXL::getGoalTorque()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_TORQUE_LIMIT)];
 }
 
 int ServoXL::getHardwareErrorStatus()
 {
-    std::lock_guard <std::mutex> lock(access);
     return registerTableValues[gid(REG_HW_ERROR_STATUS)];
 }
 
@@ -110,11 +104,11 @@ void ServoXL::setId(int id)
 
     if (id > -1 && id < 253)
     {
-        std::lock_guard <std::mutex> lock(access);
+        TableWriteLock lock(*this);
 
         // Maybe check if new ID is not already in use ?
         registerTableValues[gid(REG_ID)] = id;
-        registerTableCommits[gid(REG_ID)] = 1;
+        markCommit(registerTableCommits, gid(REG_ID));
     }
 }
 
@@ -0,0 +1,178 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file Trajectory.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "Trajectory.h"
+#include "minitraces.h"
+
+#include <algorithm>
+
+/* ************************************************************************** */
+
+Trajectory::Trajectory(const std::vector <Waypoint> &wps, const int prof):
+    profile(prof),
+    waypoints(wps)
+{
+    valid = (waypoints.size() >= 2) &&
+            (profile >= TRAJECTORY_TRAPEZOIDAL && profile <= TRAJECTORY_CUBIC_SPLINE);
+
+    for (size_t i = 1; i < waypoints.size() && valid; i++)
+    {
+        if (waypoints[i].time <= waypoints[i - 1].time)
+        {
+            valid = false;
+        }
+    }
+
+    if (valid == false)
+    {
+        TRACE_ERROR(MAPI, "Trajectory(%i waypoints, profile %i) [VALUE ERROR]: at least two waypoints with increasing times are needed",
+                    static_cast<int>(waypoints.size()), profile);
+        return;
+    }
+
+    if (profile == TRAJECTORY_CUBIC_SPLINE)
+    {
+        computeSpline();
+    }
+}
+
+Trajectory::Trajectory(const double from, const double to, const double duration, const int prof):
+    Trajectory({{0.0, from}, {duration, to}}, prof)
+{
+    //
+}
+
+void Trajectory::computeSpline()
+{
+    // Tridiagonal system on the second derivatives 'M', solved with the Thomas algorithm
+    const size_t n = waypoints.size();
+    std::vector <double> sub(n, 0.0), diag(n, 0.0), sup(n, 0.0), rhs(n, 0.0);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double hPrev = (i > 0) ? waypoints[i].time - waypoints[i - 1].time : 0.0;
+        double hNext = (i < n - 1) ? waypoints[i + 1].time - waypoints[i].time : 0.0;
+        double slopePrev = (i > 0) ? (waypoints[i].position - waypoints[i - 1].position) / hPrev : 0.0;
+        double slopeNext = (i < n - 1) ? (waypoints[i + 1].position - waypoints[i].position) / hNext : 0.0;
+
+        // The end conditions (zero speeds) fall out of the same expressions
+        sub[i] = hPrev;
+        diag[i] = 2.0 * (hPrev + hNext);
+        sup[i] = hNext;
+        rhs[i] = 6.0 * (slopeNext - slopePrev);
+    }
+
+    for (size_t i = 1; i < n; i++)
+    {
+        double w = sub[i] / diag[i - 1];
+        diag[i] -= w * sup[i - 1];
+        rhs[i] -= w * rhs[i - 1];
+    }
+
+    moments.assign(n, 0.0);
+    moments[n - 1] = rhs[n - 1] / diag[n - 1];
+    for (size_t i = n - 1; i > 0; i--)
+    {
+        moments[i - 1] = (rhs[i - 1] - sup[i - 1] * moments[i]) / diag[i - 1];
+    }
+}
+
+/* ************************************************************************** */
+
+bool Trajectory::isValid() const
+{
+    return valid;
+}
+
+int Trajectory::getProfile() const
+{
+    return profile;
+}
+
+const std::vector <Waypoint> &Trajectory::getWaypoints() const
+{
+    return waypoints;
+}
+
+double Trajectory::getDuration() const
+{
+    return valid ? waypoints.back().time : 0.0;
+}
+
+double Trajectory::getPosition(const double t) const
+{
+    if (valid == false)
+    {
+        return waypoints.empty() ? 0.0 : waypoints.front().position;
+    }
+
+    if (t <= waypoints.front().time)
+    {
+        return waypoints.front().position;
+    }
+    if (t >= waypoints.back().time)
+    {
+        return waypoints.back().position;
+    }
+
+    // Segment [i;i+1] containing 't'
+    size_t i = std::upper_bound(waypoints.begin(), waypoints.end(), t,
+                                [](const double time, const Waypoint &w) { return time < w.time; }) - waypoints.begin() - 1;
+
+    const Waypoint &a = waypoints[i];
+    const Waypoint &b = waypoints[i + 1];
+    double h = b.time - a.time;
+    double u = t - a.time;
+    double d = b.position - a.position;
+
+    double position = a.position;
+
+    if (profile == TRAJECTORY_TRAPEZOIDAL)
+    {
+        // Accelerate during the first quarter, decelerate during the last one
+        double ta = h / 4.0;
+        double v = d / (h - ta);
+        double acc = v / ta;
+
+        if (u < ta)
+            position = a.position + 0.5 * acc * u * u;
+        else if (u < h - ta)
+            position = a.position + 0.5 * v * ta + v * (u - ta);
+        else
+            position = b.position - 0.5 * acc * (h - u) * (h - u);
+    }
+    else if (profile == TRAJECTORY_MINIMUM_JERK)
+    {
+        double tau = u / h;
+        double tau3 = tau * tau * tau;
+        position = a.position + d * (10.0 * tau3 - 15.0 * tau3 * tau + 6.0 * tau3 * tau * tau);
+    }
+    else if (profile == TRAJECTORY_CUBIC_SPLINE)
+    {
+        double r = h - u;
+        position = (moments[i] * r * r * r + moments[i + 1] * u * u * u) / (6.0 * h) +
+                   (a.position / h - moments[i] * h / 6.0) * r +
+                   (b.position / h - moments[i + 1] * h / 6.0) * u;
+    }
+
+    return position;
+}
@@ -0,0 +1,110 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file Trajectory.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <vector>
+
+/** \addtogroup ManagedAPIs
+ *  @{
+ */
+
+/*!
+ * \brief Interpolation used between the waypoints of a trajectory.
+ */
+enum TrajectoryProfile_e
+{
+    TRAJECTORY_TRAPEZOIDAL = 0,         //!< Constant acceleration for the first and last quarters of each segment, constant speed in between.
+    TRAJECTORY_MINIMUM_JERK = 1,        //!< Minimum jerk (quintic) curve on each segment, stopping at every waypoint.
+    TRAJECTORY_CUBIC_SPLINE = 2         //!< Cubic spline going through every waypoint without stopping, starting and ending at rest.
+};
+
+/*!
+ * \brief A time-stamped position setpoint.
+ */
+struct Waypoint
+{
+    double time;                        //!< Time, in seconds, from the start of the trajectory.
+    double position;                    //!< Position, in steps.
+};
+
+/*!
+ * \brief The Trajectory class.
+ *
+ * A position profile through time-stamped waypoints. A trajectory is
+ * immutable once created, so it can be shared by several devices, and
+ * evaluated by a controller's thread while the application builds the next
+ * one. See ServoController::setTrajectory().
+ */
+class Trajectory
+{
+    int profile = TRAJECTORY_MINIMUM_JERK;
+    std::vector <Waypoint> waypoints;
+    std::vector <double> moments;       //!< Second derivatives at each waypoint (cubic spline profile only).
+    bool valid = false;
+
+    //! Compute the second derivatives of the cubic spline at each waypoint, with zero speeds at both ends.
+    void computeSpline();
+
+public:
+    /*!
+     * \brief Trajectory constructor.
+     * \param wps: Waypoints. At least two, with strictly increasing times.
+     * \param prof: Interpolation profile, from ::TrajectoryProfile_e.
+     */
+    Trajectory(const std::vector <Waypoint> &wps, const int prof = TRAJECTORY_MINIMUM_JERK);
+
+    /*!
+     * \brief Trajectory constructor, for a point to point movement.
+     * \param from: Starting position, in steps.
+     * \param to: Goal position, in steps.
+     * \param duration: Duration of the movement, in seconds.
+     * \param prof: Interpolation profile, from ::TrajectoryProfile_e.
+     */
+    Trajectory(const double from, const double to, const double duration, const int prof = TRAJECTORY_MINIMUM_JERK);
+
+    /*!
+     * \brief Check if the waypoints given at construction make a usable trajectory.
+     */
+    bool isValid() const;
+
+    int getProfile() const;
+    const std::vector <Waypoint> &getWaypoints() const;
+
+    /*!
+     * \brief Get the time of the last waypoint.
+     * \return The duration of the trajectory, in seconds.
+     */
+    double getDuration() const;
+
+    /*!
+     * \brief Evaluate the trajectory.
+     * \param t: Time, in seconds, from the start of the trajectory.
+     * \return The position at time 't', in steps. Before the first (or after the last) waypoint, its position.
+     */
+    double getPosition(const double t) const;
+};
+
+/** @}*/
+
+#endif // TRAJECTORY_H
@@ -0,0 +1,1318 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file VirtualServoBus.cpp
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#if defined(__linux__) || defined(__unix__)
+
+#include "VirtualServoBus.h"
+#include "DynamixelTools.h"
+#include "HerkuleXTools.h"
+#include "minitraces.h"
+
+// Linux specifics
+#include <fcntl.h>
+#include <termios.h>
+#include <poll.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+/* ************************************************************************** */
+
+// Dynamixel instructions (protocol v1 and v2)
+enum {
+    DXL_PING            = 1,
+    DXL_READ            = 2,
+    DXL_WRITE           = 3,
+    DXL_REG_WRITE       = 4,
+    DXL_ACTION          = 5,
+    DXL_FACTORY_RESET   = 6,
+    DXL_REBOOT          = 8,
+    DXL_STATUS          = 85,
+    DXL_SYNC_READ       = 130,
+    DXL_SYNC_WRITE      = 131,
+    DXL_BULK_READ       = 146,
+    DXL_BULK_WRITE      = 147,
+};
+
+// Dynamixel error bits
+#define DXL1_ERRBIT_INSTRUCTION     0x40
+#define DXL1_ERRBIT_RANGE           0x08
+#define DXL2_ERR_INSTRUCTION        0x02
+#define DXL2_ERR_ACCESS             0x07
+
+// HerkuleX commands
+enum {
+    HKX_EEP_WRITE   = 1,
+    HKX_EEP_READ    = 2,
+    HKX_RAM_WRITE   = 3,
+    HKX_RAM_READ    = 4,
+    HKX_I_JOG       = 5,
+    HKX_S_JOG       = 6,
+    HKX_STAT        = 7,
+    HKX_ROLLBACK    = 8,
+    HKX_REBOOT      = 9,
+    HKX_ACK         = 0x40,
+};
+
+// HerkuleX status detail bits
+#define HKX_STATBIT_MOVING          0x01
+#define HKX_STATBIT_INPOSITION      0x02
+#define HKX_STATBIT_UNKWOWN_CMD     0x08
+#define HKX_STATBIT_TORQUE_ON       0x40
+#define HKX_ERRBIT_INVALID_PKT      0x08
+
+//! Time for a virtual device to come back after a reboot.
+#define REBOOT_DURATION_MS          100
+
+//! Incomplete packets are discarded after this much silence on the bus.
+#define RX_STALE_TIMEOUT_MS         50
+
+/* ************************************************************************** */
+
+static unsigned short dxl2_crc(const unsigned char *data, const int size)
+{
+    unsigned short crc = 0;
+
+    for (int i = 0; i < size; i++)
+    {
+        crc ^= static_cast<unsigned short>(data[i]) << 8;
+        for (int j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x8000) ? static_cast<unsigned short>((crc << 1) ^ 0x8005) : static_cast<unsigned short>(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static unsigned char dxl1_checksum(const unsigned char *packet, const int size)
+{
+    unsigned char checksum = 0;
+
+    // ID + LENGTH + INSTRUCTION + PARAMETERS
+    for (int i = 2; i < size - 1; i++)
+    {
+        checksum += packet[i];
+    }
+
+    return static_cast<unsigned char>(~checksum);
+}
+
+static void hkx_checksum(const unsigned char *packet, const int size, unsigned char &cs1, unsigned char &cs2)
+{
+    int sum = packet[2] ^ packet[3] ^ packet[4];
+    for (int i = 7; i < size; i++)
+    {
+        sum ^= packet[i];
+    }
+
+    cs1 = static_cast<unsigned char>(sum & 0xFE);
+    cs2 = static_cast<unsigned char>((~sum) & 0xFE);
+}
+
+/* ************************************************************************** */
+
+VirtualServoBus::VirtualServoBus(const int baud):
+    baudRate(baud),
+    busRunning(false),
+    rng(0x5e4b0),
+    packetsReceived(0),
+    packetsSent(0),
+    packetsCorrupted(0)
+{
+    if (baudRate < 1)
+    {
+        baudRate = 1000000;
+    }
+
+    // start bit + 8 data bits + stop bit
+    byteTimeUs = 10.0 * 1000000.0 / static_cast<double>(baudRate);
+}
+
+VirtualServoBus::~VirtualServoBus()
+{
+    stop();
+}
+
+bool VirtualServoBus::addDynamixel(const int id, const int modelNumber, const int protocolVersion)
+{
+    VirtualDevice dev;
+    int serie = SERVO_UNKNOWN;
+
+    dxl_get_model_infos(modelNumber, serie, dev.servoModel);
+    dev.ct = getRegisterTable(dev.servoModel);
+    dev.protocol = (protocolVersion == PROTOCOL_DXLv2) ? PROTOCOL_DXLv2 : PROTOCOL_DXLv1;
+    dev.modelNumber = modelNumber;
+
+    if (dev.ct == nullptr || id < 0 || id > 252)
+    {
+        TRACE_ERROR(SIM, "Unable to add virtual Dynamixel device #%i (model number: %#06x)", id, modelNumber);
+        return false;
+    }
+
+    resetDevice(dev, RESET_ALL);
+    writeRegister(dev, REG_ID, id);
+
+    std::lock_guard <std::mutex> lock(devicesLock);
+    if (findDevice(dev.protocol, id) != nullptr)
+    {
+        TRACE_ERROR(SIM, "A virtual device #%i already exists on this bus", id);
+        return false;
+    }
+    devices.push_back(dev);
+
+    TRACE_INFO(SIM, "Virtual Dynamixel device #%i added (%s, protocol v%i)",
+               id, dxl_get_model_name(modelNumber).c_str(), dev.protocol);
+
+    return true;
+}
+
+bool VirtualServoBus::addHerkuleX(const int id, const int modelNumber)
+{
+    VirtualDevice dev;
+    int serie = SERVO_UNKNOWN;
+
+    hkx_get_model_infos(modelNumber, serie, dev.servoModel);
+    dev.ct = getRegisterTable(dev.servoModel);
+    dev.protocol = PROTOCOL_HKX;
+    dev.modelNumber = modelNumber;
+
+    if (dev.ct == nullptr || id < 0 || id > 253)
+    {
+        TRACE_ERROR(SIM, "Unable to add virtual HerkuleX device #%i (model number: %#06x)", id, modelNumber);
+        return false;
+    }
+
+    resetDevice(dev, RESET_ALL);
+    writeRegister(dev, REG_ID, id);
+
+    std::lock_guard <std::mutex> lock(devicesLock);
+    if (findDevice(dev.protocol, id) != nullptr)
+    {
+        TRACE_ERROR(SIM, "A virtual device #%i already exists on this bus", id);
+        return false;
+    }
+    devices.push_back(dev);
+
+    TRACE_INFO(SIM, "Virtual HerkuleX device #%i added (%s)",
+               id, hkx_get_model_name(modelNumber).c_str());
+
+    return true;
+}
+
+bool VirtualServoBus::start()
+{
+    if (busRunning)
+    {
+        return true;
+    }
+
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+    {
+        TRACE_ERROR(SIM, "Unable to create a pseudo terminal pair: error '%i'", errno);
+        stop();
+        return false;
+    }
+
+    char *name = ptsname(masterFd);
+    if (name == nullptr)
+    {
+        TRACE_ERROR(SIM, "Unable to get the pseudo terminal slave name");
+        stop();
+        return false;
+    }
+    slavePath = name;
+
+    // Keep one slave descriptor open so the bus survives reconnections,
+    // and put the line discipline in raw mode before anyone talks to it
+    slaveFd = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+    if (slaveFd >= 0)
+    {
+        struct termios tty;
+        if (tcgetattr(slaveFd, &tty) == 0)
+        {
+            cfmakeraw(&tty);
+            tcsetattr(slaveFd, TCSANOW, &tty);
+        }
+    }
+
+    busFreeAt = std::chrono::steady_clock::now();
+    physicsLast = busFreeAt;
+    rxLastByte = busFreeAt;
+
+    busRunning = true;
+    busThread = std::thread(&VirtualServoBus::run, this);
+
+    TRACE_INFO(SIM, "Virtual servo bus started on '%s' (%i bps, %u devices)",
+               slavePath.c_str(), baudRate, static_cast<unsigned>(devices.size()));
+
+    return true;
+}
+
+void VirtualServoBus::stop()
+{
+    busRunning = false;
+
+    if (busThread.joinable())
+    {
+        busThread.join();
+    }
+
+    if (slaveFd >= 0)
+    {
+        close(slaveFd);
+        slaveFd = -1;
+    }
+    if (masterFd >= 0)
+    {
+        close(masterFd);
+        masterFd = -1;
+    }
+
+    slavePath.clear();
+    rxBuffer.clear();
+}
+
+void VirtualServoBus::setFaults(const int id, const VirtualServoFaults &faults)
+{
+    std::lock_guard <std::mutex> lock(devicesLock);
+
+    for (auto &dev: devices)
+    {
+        if (id == BROADCAST_ID || getDeviceId(dev) == id)
+        {
+            dev.faults = faults;
+        }
+    }
+}
+
+int VirtualServoBus::getRegisterValue(const int id, const int reg_name)
+{
+    std::lock_guard <std::mutex> lock(devicesLock);
+
+    for (auto &dev: devices)
+    {
+        if (getDeviceId(dev) == id)
+        {
+            return readRegister(dev, reg_name);
+        }
+    }
+
+    return -1;
+}
+
+void VirtualServoBus::setRegisterValue(const int id, const int reg_name, const int value)
+{
+    std::lock_guard <std::mutex> lock(devicesLock);
+
+    for (auto &dev: devices)
+    {
+        if (getDeviceId(dev) == id)
+        {
+            writeRegister(dev, reg_name, value);
+        }
+    }
+}
+
+/* ************************************************************************** */
+
+VirtualServoBus::VirtualDevice *VirtualServoBus::findDevice(const int protocol, const int id)
+{
+    for (auto &dev: devices)
+    {
+        if (dev.protocol == protocol && getDeviceId(dev) == id)
+        {
+            return &dev;
+        }
+    }
+
+    return nullptr;
+}
+
+int VirtualServoBus::getDeviceId(const VirtualDevice &dev) const
+{
+    // HerkuleX devices answer to the ID loaded in RAM
+    return readMem(dev, getRegisterAddr(dev.ct, REG_ID, (dev.protocol == PROTOCOL_HKX) ? REGISTER_RAM : REGISTER_AUTO), 1, REGISTER_RAM);
+}
+
+void VirtualServoBus::resetDevice(VirtualDevice &dev, const int setting)
+{
+    int id = (dev.mem.empty() == false) ? getDeviceId(dev) : 1;
+    int baud = (dev.mem.empty() == false) ? readRegister(dev, REG_BAUD_RATE) : -1;
+
+    // Size the memories after the highest address of the control table
+    size_t memSize = 0, eepSize = 0;
+    for (unsigned i = 0; i < getRegisterCount(dev.ct); i++)
+    {
+        if (dev.protocol == PROTOCOL_HKX)
+        {
+            eepSize = std::max(eepSize, static_cast<size_t>(dev.ct[i][3] + dev.ct[i][1]));
+            memSize = std::max(memSize, static_cast<size_t>(dev.ct[i][4] + dev.ct[i][1]));
+        }
+        else
+        {
+            memSize = std::max(memSize, static_cast<size_t>(std::max(dev.ct[i][3], dev.ct[i][4]) + dev.ct[i][1]));
+        }
+    }
+    dev.mem.assign(memSize + 8, 0);
+    dev.eep.assign(eepSize + 8, 0);
+
+    // Load default values
+    for (unsigned i = 0; i < getRegisterCount(dev.ct); i++)
+    {
+        int value = dev.ct[i][5];
+        if (value < 0)
+        {
+            value = 0;
+        }
+
+        if (dev.ct[i][3] >= 0)
+        {
+            writeMem(dev, dev.ct[i][3], dev.ct[i][1], value, REGISTER_ROM);
+        }
+        if (dev.ct[i][4] >= 0)
+        {
+            writeMem(dev, dev.ct[i][4], dev.ct[i][1], value, REGISTER_RAM);
+        }
+    }
+
+    writeRegister(dev, REG_MODEL_NUMBER, dev.modelNumber);
+    writeRegister(dev, REG_FIRMWARE_VERSION, 1);
+
+    if (setting == RESET_ALL_EXCEPT_ID || setting == RESET_ALL_EXCEPT_ID_BAUDRATE)
+    {
+        writeRegister(dev, REG_ID, id);
+    }
+    if (setting == RESET_ALL_EXCEPT_ID_BAUDRATE && baud >= 0)
+    {
+        writeRegister(dev, REG_BAUD_RATE, baud);
+    }
+
+    // Plausible sensors values
+    int max = readRegister(dev, REG_MAX_POSITION);
+    dev.positionMax = (max > 0) ? max : 1023;
+    if (dev.mem.empty() == false && dev.goal == 0.0)
+    {
+        dev.position = dev.positionMax / 2.0;
+        dev.goal = dev.position;
+    }
+
+    if (dev.protocol == PROTOCOL_HKX)
+    {
+        writeRegister(dev, REG_CURRENT_VOLTAGE, 162); // ~12V
+        writeRegister(dev, REG_CURRENT_TEMPERATURE, 160);
+    }
+    else
+    {
+        writeRegister(dev, REG_CURRENT_VOLTAGE, 120); // 12.0V
+        writeRegister(dev, REG_CURRENT_TEMPERATURE, 35);
+        writeRegister(dev, REG_GOAL_POSITION, static_cast<int>(dev.goal));
+    }
+    dev.speed = 2.0 * dev.positionMax;
+    dev.regWrite.clear();
+}
+
+int VirtualServoBus::readMem(const VirtualDevice &dev, const int addr, const int size, const int type) const
+{
+    const std::vector <unsigned char> &m = (dev.protocol == PROTOCOL_HKX && type == REGISTER_ROM) ? dev.eep : dev.mem;
+    int value = 0;
+
+    if (addr >= 0 && addr + size <= static_cast<int>(m.size()))
+    {
+        for (int i = size - 1; i >= 0; i--)
+        {
+            value = (value << 8) | m[addr + i];
+        }
+    }
+    else
+    {
+        value = -1;
+    }
+
+    return value;
+}
+
+void VirtualServoBus::writeMem(VirtualDevice &dev, const int addr, const int size, const int value, const int type)
+{
+    std::vector <unsigned char> &m = (dev.protocol == PROTOCOL_HKX && type == REGISTER_ROM) ? dev.eep : dev.mem;
+
+    if (addr >= 0 && addr + size <= static_cast<int>(m.size()))
+    {
+        for (int i = 0; i < size; i++)
+        {
+            m[addr + i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+}
+
+void VirtualServoBus::readBytes(const VirtualDevice &dev, const int addr, unsigned char *data, const int size, const int type) const
+{
+    const std::vector <unsigned char> &m = (dev.protocol == PROTOCOL_HKX && type == REGISTER_ROM) ? dev.eep : dev.mem;
+
+    for (int i = 0; i < size; i++)
+    {
+        data[i] = (addr + i >= 0 && addr + i < static_cast<int>(m.size())) ? m[addr + i] : 0;
+    }
+}
+
+void VirtualServoBus::writeBytes(VirtualDevice &dev, const int addr, const unsigned char *data, const int size, const int type)
+{
+    std::vector <unsigned char> &m = (dev.protocol == PROTOCOL_HKX && type == REGISTER_ROM) ? dev.eep : dev.mem;
+
+    for (int i = 0; i < size; i++)
+    {
+        if (addr + i >= 0 && addr + i < static_cast<int>(m.size()))
+        {
+            m[addr + i] = data[i];
+        }
+    }
+
+    registersWritten(dev, addr, size, type);
+}
+
+void VirtualServoBus::writeRegister(VirtualDevice &dev, const int reg_name, const int value)
+{
+    int size = getRegisterSize(dev.ct, reg_name);
+    int rom = getRegisterAddr(dev.ct, reg_name, REGISTER_ROM);
+    int ram = getRegisterAddr(dev.ct, reg_name, REGISTER_RAM);
+
+    if (rom >= 0)
+    {
+        writeMem(dev, rom, size, value, REGISTER_ROM);
+    }
+    if (ram >= 0)
+    {
+        writeMem(dev, ram, size, value, REGISTER_RAM);
+    }
+}
+
+int VirtualServoBus::readRegister(const VirtualDevice &dev, const int reg_name) const
+{
+    int size = getRegisterSize(dev.ct, reg_name);
+    int ram = getRegisterAddr(dev.ct, reg_name, REGISTER_RAM);
+
+    if (ram >= 0)
+    {
+        return readMem(dev, ram, size, REGISTER_RAM);
+    }
+
+    return readMem(dev, getRegisterAddr(dev.ct, reg_name, REGISTER_ROM), size, REGISTER_ROM);
+}
+
+void VirtualServoBus::registersWritten(VirtualDevice &dev, const int addr, const int size, const int type)
+{
+    if (dev.protocol == PROTOCOL_HKX)
+    {
+        // HerkuleX motions are only triggered by I_JOG / S_JOG
+        return;
+    }
+
+    int goalAddr = getRegisterAddr(dev.ct, REG_GOAL_POSITION, REGISTER_AUTO);
+    int goalSize = getRegisterSize(dev.ct, REG_GOAL_POSITION);
+    if (goalAddr >= 0 && addr < goalAddr + goalSize && addr + size > goalAddr)
+    {
+        dev.goal = std::min(std::max(0.0, static_cast<double>(readMem(dev, goalAddr, goalSize, type))), dev.positionMax);
+    }
+
+    int speedAddr = getRegisterAddr(dev.ct, REG_GOAL_SPEED, REGISTER_AUTO);
+    int speedSize = getRegisterSize(dev.ct, REG_GOAL_SPEED);
+    if (speedAddr >= 0 && addr < speedAddr + speedSize && addr + size > speedAddr)
+    {
+        // Approximately 114 rpm at full speed, or with a value of 0
+        int s = readMem(dev, speedAddr, speedSize, type) & 0x3FF;
+        dev.speed = 2.0 * dev.positionMax * ((s == 0) ? 1.0 : (static_cast<double>(s) / 1023.0));
+    }
+}
+
+int VirtualServoBus::getReturnDelayUs(const VirtualDevice &dev) const
+{
+    int delay = 0;
+
+    if (dev.protocol != PROTOCOL_HKX)
+    {
+        // Return delay time is expressed in units of 2µs
+        delay = readRegister(dev, REG_RETURN_DELAY_TIME) * 2;
+    }
+
+    return std::max(delay, 0) + dev.faults.extraDelayUs;
+}
+
+int VirtualServoBus::getAckPolicy(const VirtualDevice &dev) const
+{
+    int ack = readRegister(dev, REG_STATUS_RETURN_LEVEL);
+    return (ack < 0) ? 2 : ack;
+}
+
+/* ************************************************************************** */
+
+void VirtualServoBus::run()
+{
+    unsigned char buf[512];
+
+    while (busRunning)
+    {
+        struct pollfd pfd;
+        pfd.fd = masterFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ret = poll(&pfd, 1, 5);
+        if (ret > 0 && (pfd.revents & POLLIN))
+        {
+            ssize_t len = read(masterFd, buf, sizeof(buf));
+            if (len > 0)
+            {
+                auto now = std::chrono::steady_clock::now();
+                if (rxBuffer.empty())
+                {
+                    rxLastByte = now;
+                }
+                rxBuffer.insert(rxBuffer.end(), buf, buf + len);
+                rxLastByte = now;
+            }
+        }
+        else if (ret < 0 && errno != EINTR)
+        {
+            TRACE_ERROR(SIM, "poll() failed on virtual bus: error '%i'", errno);
+            break;
+        }
+
+        std::lock_guard <std::mutex> lock(devicesLock);
+        updatePhysics();
+        parse();
+
+        // Drop incomplete packets after some silence
+        if (rxBuffer.empty() == false &&
+            std::chrono::steady_clock::now() - rxLastByte > std::chrono::milliseconds(RX_STALE_TIMEOUT_MS))
+        {
+            packetsCorrupted++;
+            rxBuffer.clear();
+        }
+    }
+}
+
+void VirtualServoBus::parse()
+{
+    bool hasDxl1 = false, hasDxl2 = false, hasHkx = false;
+    for (auto const &dev: devices)
+    {
+        hasDxl1 |= (dev.protocol == PROTOCOL_DXLv1);
+        hasDxl2 |= (dev.protocol == PROTOCOL_DXLv2);
+        hasHkx |= (dev.protocol == PROTOCOL_HKX);
+    }
+
+    while (rxBuffer.size() >= 2)
+    {
+        const unsigned char *p = rxBuffer.data();
+        const int avail = static_cast<int>(rxBuffer.size());
+
+        // Resync on a packet header
+        if (p[0] != 0xFF || p[1] != 0xFF)
+        {
+            rxBuffer.erase(rxBuffer.begin());
+            continue;
+        }
+
+        int size = 0;
+        int protocol = PROTOCOL_UNKNOWN;
+        bool incomplete = false;
+
+        if (avail >= 4 && p[2] == 0xFD && p[3] == 0x00)
+        {
+            // Dynamixel protocol v2
+            if (avail < 7)
+            {
+                incomplete = true;
+            }
+            else
+            {
+                size = 7 + make_short_word(p[5], p[6]);
+                if (size < 10 || size > 1024)
+                {
+                    size = 0;
+                }
+                else if (avail < size)
+                {
+                    incomplete = true;
+                }
+                else
+                {
+                    unsigned short crc = dxl2_crc(p, size - 2);
+                    if (p[size - 2] == get_lowbyte(crc) && p[size - 1] == get_highbyte(crc))
+                    {
+                        protocol = PROTOCOL_DXLv2;
+                    }
+                }
+            }
+        }
+        else if (avail < 4)
+        {
+            incomplete = true;
+        }
+        else
+        {
+            // Dynamixel protocol v1 and HerkuleX share the same header
+            bool waitDxl1 = false, waitHkx = false;
+
+            if (hasHkx && p[2] >= 7)
+            {
+                if (avail < p[2])
+                {
+                    waitHkx = true;
+                }
+                else
+                {
+                    unsigned char cs1, cs2;
+                    hkx_checksum(p, p[2], cs1, cs2);
+                    if (p[5] == cs1 && p[6] == cs2)
+                    {
+                        protocol = PROTOCOL_HKX;
+                        size = p[2];
+                    }
+                }
+            }
+
+            if (protocol == PROTOCOL_UNKNOWN && (hasDxl1 || hasHkx == false) && p[3] >= 2)
+            {
+                if (avail < p[3] + 4)
+                {
+                    waitDxl1 = true;
+                }
+                else if (p[p[3] + 3] == dxl1_checksum(p, p[3] + 4))
+                {
+                    protocol = PROTOCOL_DXLv1;
+                    size = p[3] + 4;
+                }
+            }
+
+            if (protocol == PROTOCOL_UNKNOWN && (waitDxl1 || waitHkx))
+            {
+                incomplete = true;
+            }
+        }
+
+        if (incomplete)
+        {
+            break;
+        }
+
+        if (protocol == PROTOCOL_UNKNOWN)
+        {
+            // Not a valid packet, skip this header
+            packetsCorrupted++;
+            rxBuffer.erase(rxBuffer.begin());
+            continue;
+        }
+
+        packetsReceived++;
+
+        // The instruction packet ends on the wire after its own transfer time
+        auto now = std::chrono::steady_clock::now();
+        auto t = std::max(now, busFreeAt) + std::chrono::microseconds(static_cast<long>(size * byteTimeUs));
+
+        std::vector <unsigned char> packet(rxBuffer.begin(), rxBuffer.begin() + size);
+        rxBuffer.erase(rxBuffer.begin(), rxBuffer.begin() + size);
+
+        if (protocol == PROTOCOL_DXLv1)
+        {
+            handleDxl1(packet.data(), size, t);
+        }
+        else if (protocol == PROTOCOL_DXLv2)
+        {
+            handleDxl2(packet.data(), size, t);
+        }
+        else
+        {
+            handleHkx(packet.data(), size, t);
+        }
+
+        busFreeAt = t;
+    }
+}
+
+void VirtualServoBus::updatePhysics()
+{
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - physicsLast).count();
+    physicsLast = now;
+
+    for (auto &dev: devices)
+    {
+        double delta = dev.goal - dev.position;
+        double step = dev.speed * dt;
+        bool moving = std::fabs(delta) > 0.5;
+
+        if (std::fabs(delta) <= step)
+        {
+            dev.position = dev.goal;
+        }
+        else
+        {
+            dev.position += (delta > 0) ? step : -step;
+        }
+
+        int pos = static_cast<int>(std::lround(dev.position));
+
+        if (dev.protocol == PROTOCOL_HKX)
+        {
+            writeRegister(dev, REG_ABSOLUTE_POSITION, pos);
+            writeRegister(dev, REG_CALIBRATED_POSITION, pos);
+
+            // Position change over the last 11.2 ms, as a 16 bits signed value
+            int differential = moving ? static_cast<int>(std::lround(dev.speed * 0.0112)) : 0;
+            writeRegister(dev, REG_DIFFERENTIAL_POSITION, ((delta < 0) ? -differential : differential) & 0xFFFF);
+
+            int detail = readRegister(dev, REG_STATUS_DETAIL) & ~(HKX_STATBIT_MOVING | HKX_STATBIT_INPOSITION | HKX_STATBIT_TORQUE_ON);
+            detail |= moving ? HKX_STATBIT_MOVING : HKX_STATBIT_INPOSITION;
+            if (readRegister(dev, REG_TORQUE_ENABLE) > 0)
+            {
+                detail |= HKX_STATBIT_TORQUE_ON;
+            }
+            writeRegister(dev, REG_STATUS_DETAIL, detail);
+            writeRegister(dev, REG_STATUS_ERROR, dev.faults.errorBits & 0x7F);
+        }
+        else
+        {
+            writeRegister(dev, REG_CURRENT_POSITION, pos);
+            writeRegister(dev, REG_MOVING, moving ? 1 : 0);
+
+            int speed = moving ? static_cast<int>(dev.speed / (2.0 * dev.positionMax) * 1023.0) : 0;
+            if (moving && delta < 0)
+            {
+                speed |= 0x400; // CW direction bit
+            }
+            writeRegister(dev, REG_CURRENT_SPEED, speed);
+        }
+    }
+}
+
+void VirtualServoBus::sendStatus(VirtualDevice &dev, std::vector <unsigned char> &packet, std::chrono::steady_clock::time_point &t)
+{
+    std::uniform_int_distribution <int> percent(0, 99);
+
+    t += std::chrono::microseconds(getReturnDelayUs(dev));
+
+    if (dev.faults.dropPercent > 0 && percent(rng) < dev.faults.dropPercent)
+    {
+        return;
+    }
+    if (dev.faults.corruptPercent > 0 && percent(rng) < dev.faults.corruptPercent)
+    {
+        packet.back() ^= 0x5A;
+    }
+    if (dev.faults.truncatePercent > 0 && percent(rng) < dev.faults.truncatePercent && packet.size() > 4)
+    {
+        packet.resize(packet.size() / 2);
+    }
+
+    // The last byte reaches the host after the whole status packet transfer time
+    t += std::chrono::microseconds(static_cast<long>(packet.size() * byteTimeUs));
+
+    auto spinFrom = t - std::chrono::microseconds(200);
+    if (std::chrono::steady_clock::now() < spinFrom)
+    {
+        std::this_thread::sleep_until(spinFrom);
+    }
+    while (std::chrono::steady_clock::now() < t);
+
+    ssize_t written = write(masterFd, packet.data(), packet.size());
+    if (written == static_cast<ssize_t>(packet.size()))
+    {
+        packetsSent++;
+    }
+}
+
+/* ************************************************************************** */
+
+void VirtualServoBus::handleDxl1(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t)
+{
+    const int id = packet[2];
+    const int inst = packet[4];
+    const unsigned char *params = packet + 5;
+    const int nparams = size - 6;
+
+    // Build a v1 status packet
+    auto status = [this](VirtualDevice &dev, const unsigned char *data, const int len, const int error)
+    {
+        std::vector <unsigned char> st(6 + len);
+        st[0] = 0xFF;
+        st[1] = 0xFF;
+        st[2] = static_cast<unsigned char>(getDeviceId(dev));
+        st[3] = static_cast<unsigned char>(len + 2);
+        st[4] = static_cast<unsigned char>((error | dev.faults.errorBits) & 0x7F);
+        if (len > 0)
+        {
+            memcpy(st.data() + 5, data, len);
+        }
+        st[5 + len] = dxl1_checksum(st.data(), static_cast<int>(st.size()));
+        return st;
+    };
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (inst == DXL_SYNC_WRITE && nparams >= 2)
+    {
+        // No status packet for SYNC_WRITE
+        const int addr = params[0];
+        const int len = params[1];
+        for (int i = 2; i + len + 1 <= nparams; i += len + 1)
+        {
+            VirtualDevice *dev = findDevice(PROTOCOL_DXLv1, params[i]);
+            if (dev && dev->faults.offline == false && now >= dev->rebootUntil)
+            {
+                writeBytes(*dev, addr, params + i + 1, len, REGISTER_RAM);
+            }
+        }
+        return;
+    }
+
+    if (inst == DXL_BULK_READ && nparams >= 1)
+    {
+        // Every device answers in turn, in the requested order
+        for (int i = 1; i + 3 <= nparams; i += 3)
+        {
+            VirtualDevice *dev = findDevice(PROTOCOL_DXLv1, params[i + 1]);
+            if (dev && dev->faults.offline == false && now >= dev->rebootUntil)
+            {
+                unsigned char data[256];
+                readBytes(*dev, params[i + 2], data, params[i], REGISTER_RAM);
+                std::vector <unsigned char> st = status(*dev, data, params[i], 0);
+                sendStatus(*dev, st, t);
+            }
+        }
+        return;
+    }
+
+    for (auto &dev: devices)
+    {
+        if (dev.protocol != PROTOCOL_DXLv1 || dev.faults.offline || now < dev.rebootUntil)
+        {
+            continue;
+        }
+
+        const int devId = getDeviceId(dev);
+        if (id != devId && id != BROADCAST_ID)
+        {
+            continue;
+        }
+
+        std::vector <unsigned char> data;
+        int error = 0;
+        bool isRead = false;
+
+        switch (inst)
+        {
+        case DXL_PING:
+            isRead = true;
+            break;
+        case DXL_READ:
+            isRead = true;
+            if (nparams == 2)
+            {
+                data.resize(params[1]);
+                readBytes(dev, params[0], data.data(), params[1], REGISTER_RAM);
+            }
+            else
+            {
+                error |= DXL1_ERRBIT_INSTRUCTION;
+            }
+            break;
+        case DXL_WRITE:
+            if (nparams >= 2)
+            {
+                writeBytes(dev, params[0], params + 1, nparams - 1, REGISTER_RAM);
+            }
+            else
+            {
+                error |= DXL1_ERRBIT_INSTRUCTION;
+            }
+            break;
+        case DXL_REG_WRITE:
+            dev.regWrite.assign(params, params + nparams);
+            writeRegister(dev, REG_REGISTERED, 1);
+            break;
+        case DXL_ACTION:
+            if (dev.regWrite.size() >= 2)
+            {
+                writeBytes(dev, dev.regWrite[0], dev.regWrite.data() + 1, static_cast<int>(dev.regWrite.size()) - 1, REGISTER_RAM);
+            }
+            dev.regWrite.clear();
+            writeRegister(dev, REG_REGISTERED, 0);
+            break;
+        case DXL_FACTORY_RESET:
+            resetDevice(dev, RESET_ALL);
+            break;
+        default:
+            error |= DXL1_ERRBIT_INSTRUCTION;
+            break;
+        }
+
+        // v1 devices never answer broadcast instructions
+        int ack = getAckPolicy(dev);
+        if (id != BROADCAST_ID &&
+            (inst == DXL_PING || ack == 2 || (ack == 1 && isRead)))
+        {
+            std::vector <unsigned char> st = status(dev, data.data(), static_cast<int>(data.size()), error);
+            sendStatus(dev, st, t);
+        }
+    }
+}
+
+void VirtualServoBus::handleDxl2(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t)
+{
+    const int id = packet[4];
+    const int inst = packet[7];
+    const unsigned char *params = packet + 8;
+    const int nparams = size - 10;
+
+    // Build a v2 status packet
+    auto status = [this](VirtualDevice &dev, const unsigned char *data, const int len, const int error)
+    {
+        std::vector <unsigned char> st(11 + len);
+        st[0] = 0xFF;
+        st[1] = 0xFF;
+        st[2] = 0xFD;
+        st[3] = 0x00;
+        st[4] = static_cast<unsigned char>(getDeviceId(dev));
+        st[5] = get_lowbyte(len + 4);
+        st[6] = get_highbyte(len + 4);
+        st[7] = DXL_STATUS;
+        st[8] = static_cast<unsigned char>((error | dev.faults.errorBits) & 0xFF);
+        if (len > 0)
+        {
+            memcpy(st.data() + 9, data, len);
+        }
+        unsigned short crc = dxl2_crc(st.data(), static_cast<int>(st.size()) - 2);
+        st[9 + len] = get_lowbyte(crc);
+        st[10 + len] = get_highbyte(crc);
+        return st;
+    };
+
+    auto now = std::chrono::steady_clock::now();
+    auto alive = [now](const VirtualDevice *dev) { return dev && dev->faults.offline == false && now >= dev->rebootUntil; };
+
+    switch (inst)
+    {
+    case DXL_SYNC_WRITE:
+        if (nparams >= 4)
+        {
+            const int addr = make_short_word(params[0], params[1]);
+            const int len = make_short_word(params[2], params[3]);
+            for (int i = 4; i + len + 1 <= nparams; i += len + 1)
+            {
+                VirtualDevice *dev = findDevice(PROTOCOL_DXLv2, params[i]);
+                if (alive(dev))
+                {
+                    writeBytes(*dev, addr, params + i + 1, len, REGISTER_RAM);
+                }
+            }
+        }
+        return;
+
+    case DXL_BULK_WRITE:
+        for (int i = 0; i + 5 <= nparams; )
+        {
+            const int addr = make_short_word(params[i + 1], params[i + 2]);
+            const int len = make_short_word(params[i + 3], params[i + 4]);
+            VirtualDevice *dev = findDevice(PROTOCOL_DXLv2, params[i]);
+            if (alive(dev) && i + 5 + len <= nparams)
+            {
+                writeBytes(*dev, addr, params + i + 5, len, REGISTER_RAM);
+            }
+            i += 5 + len;
+        }
+        return;
+
+    case DXL_SYNC_READ:
+        if (nparams >= 4)
+        {
+            const int addr = make_short_word(params[0], params[1]);
+            const int len = make_short_word(params[2], params[3]);
+            for (int i = 4; i < nparams; i++)
+            {
+                VirtualDevice *dev = findDevice(PROTOCOL_DXLv2, params[i]);
+                if (alive(dev))
+                {
+                    std::vector <unsigned char> data(len);
+                    readBytes(*dev, addr, data.data(), len, REGISTER_RAM);
+                    std::vector <unsigned char> st = status(*dev, data.data(), len, 0);
+                    sendStatus(*dev, st, t);
+                }
+            }
+        }
+        return;
+
+    case DXL_BULK_READ:
+        for (int i = 0; i + 5 <= nparams; i += 5)
+        {
+            const int addr = make_short_word(params[i + 1], params[i + 2]);
+            const int len = make_short_word(params[i + 3], params[i + 4]);
+            VirtualDevice *dev = findDevice(PROTOCOL_DXLv2, params[i]);
+            if (alive(dev))
+            {
+                std::vector <unsigned char> data(len);
+                readBytes(*dev, addr, data.data(), len, REGISTER_RAM);
+                std::vector <unsigned char> st = status(*dev, data.data(), len, 0);
+                sendStatus(*dev, st, t);
+            }
+        }
+        return;
+    }
+
+    for (auto &dev: devices)
+    {
+        if (dev.protocol != PROTOCOL_DXLv2 || alive(&dev) == false)
+        {
+            continue;
+        }
+
+        const int devId = getDeviceId(dev);
+        if (id != devId && id != BROADCAST_ID)
+        {
+            continue;
+        }
+
+        std::vector <unsigned char> data;
+        int error = 0;
+        bool isRead = false;
+
+        switch (inst)
+        {
+        case DXL_PING:
+            isRead = true;
+            data.push_back(get_lowbyte(dev.modelNumber));
+            data.push_back(get_highbyte(dev.modelNumber));
+            data.push_back(static_cast<unsigned char>(readRegister(dev, REG_FIRMWARE_VERSION)));
+            break;
+        case DXL_READ:
+            isRead = true;
+            if (nparams == 4)
+            {
+                const int len = make_short_word(params[2], params[3]);
+                data.resize(len);
+                readBytes(dev, make_short_word(params[0], params[1]), data.data(), len, REGISTER_RAM);
+            }
+            else
+            {
+                error = DXL2_ERR_INSTRUCTION;
+            }
+            break;
+        case DXL_WRITE:
+            if (nparams >= 3)
+            {
+                writeBytes(dev, make_short_word(params[0], params[1]), params + 2, nparams - 2, REGISTER_RAM);
+            }
+            else
+            {
+                error = DXL2_ERR_INSTRUCTION;
+            }
+            break;
+        case DXL_REG_WRITE:
+            if (nparams >= 3)
+            {
+                // Store the address on one byte, like protocol v1 does
+                dev.regWrite.assign(params + 1, params + nparams);
+                dev.regWrite[0] = params[0];
+                writeRegister(dev, REG_REGISTERED, 1);
+            }
+            break;
+        case DXL_ACTION:
+            if (dev.regWrite.size() >= 2)
+            {
+                writeBytes(dev, dev.regWrite[0], dev.regWrite.data() + 1, static_cast<int>(dev.regWrite.size()) - 1, REGISTER_RAM);
+            }
+            dev.regWrite.clear();
+            writeRegister(dev, REG_REGISTERED, 0);
+            break;
+        case DXL_FACTORY_RESET:
+            resetDevice(dev, (nparams > 0) ? params[0] : RESET_ALL);
+            break;
+        case DXL_REBOOT:
+            resetDevice(dev, RESET_ALL_EXCEPT_ID_BAUDRATE);
+            break;
+        default:
+            error = DXL2_ERR_INSTRUCTION;
+            break;
+        }
+
+        // v2 devices only answer broadcast PING
+        int ack = getAckPolicy(dev);
+        if ((id != BROADCAST_ID || inst == DXL_PING) &&
+            (inst == DXL_PING || ack == 2 || (ack == 1 && isRead)))
+        {
+            std::vector <unsigned char> st = status(dev, data.data(), static_cast<int>(data.size()), error);
+            sendStatus(dev, st, t);
+        }
+
+        if (inst == DXL_REBOOT)
+        {
+            dev.rebootUntil = t + std::chrono::milliseconds(REBOOT_DURATION_MS);
+        }
+    }
+}
+
+void VirtualServoBus::handleHkx(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t)
+{
+    const int id = packet[3];
+    const int cmd = packet[4];
+    const unsigned char *data = packet + 7;
+    const int ndata = size - 7;
+
+    // Build a HerkuleX ack packet
+    auto ack = [this](VirtualDevice &dev, const int cmd, const unsigned char *payload, const int len, const int statusDetail)
+    {
+        std::vector <unsigned char> st(7 + len + 2);
+        st[0] = 0xFF;
+        st[1] = 0xFF;
+        st[2] = static_cast<unsigned char>(st.size());
+        st[3] = static_cast<unsigned char>(getDeviceId(dev));
+        st[4] = static_cast<unsigned char>(cmd + HKX_ACK);
+        if (len > 0)
+        {
+            memcpy(st.data() + 7, payload, len);
+        }
+        st[7 + len] = static_cast<unsigned char>((readRegister(dev, REG_STATUS_ERROR) | dev.faults.errorBits) & 0x7F);
+        st[8 + len] = static_cast<unsigned char>(readRegister(dev, REG_STATUS_DETAIL) | statusDetail);
+        hkx_checksum(st.data(), static_cast<int>(st.size()), st[5], st[6]);
+        return st;
+    };
+
+    auto now = std::chrono::steady_clock::now();
+
+    // Jog commands carry their own per-device IDs
+    if (cmd == HKX_I_JOG || cmd == HKX_S_JOG)
+    {
+        const int stride = (cmd == HKX_I_JOG) ? 5 : 4;
+        const int first = (cmd == HKX_I_JOG) ? 0 : 1;
+
+        for (int i = first; i + stride <= ndata; i += stride)
+        {
+            VirtualDevice *dev = findDevice(PROTOCOL_HKX, data[i + 3]);
+            if (dev == nullptr || dev->faults.offline || now < dev->rebootUntil)
+            {
+                continue;
+            }
+
+            const int jog = make_short_word(data[i], data[i + 1]);
+            const int set = data[i + 2];
+            const int playtime = (cmd == HKX_I_JOG) ? data[i + 4] : data[0];
+
+            if ((set & 0x02) == 0) // position control
+            {
+                dev->goal = std::min(std::max(0.0, static_cast<double>(jog & 0x7FFF)), dev->positionMax);
+                writeRegister(*dev, REG_ABSOLUTE_GOAL_POSITION, static_cast<int>(dev->goal));
+
+                // Playtime unit is 11.2ms
+                double duration = std::max(1, playtime) * 0.0112;
+                dev->speed = std::max(std::fabs(dev->goal - dev->position) / duration, 1.0);
+            }
+            writeRegister(*dev, REG_LED, (set >> 2) & 0x07);
+        }
+
+        VirtualDevice *dev = findDevice(PROTOCOL_HKX, id);
+        if (dev && dev->faults.offline == false && getAckPolicy(*dev) == 2)
+        {
+            std::vector <unsigned char> st = ack(*dev, cmd, nullptr, 0, 0);
+            sendStatus(*dev, st, t);
+        }
+        return;
+    }
+
+    for (auto &dev: devices)
+    {
+        if (dev.protocol != PROTOCOL_HKX || dev.faults.offline || now < dev.rebootUntil)
+        {
+            continue;
+        }
+
+        const int devId = getDeviceId(dev);
+        if (id != devId && id != BROADCAST_ID)
+        {
+            continue;
+        }
+
+        std::vector <unsigned char> payload;
+        int statusDetail = 0;
+        bool isRead = false;
+
+        switch (cmd)
+        {
+        case HKX_EEP_READ:
+        case HKX_RAM_READ:
+            isRead = true;
+            if (ndata == 2)
+            {
+                payload.resize(2 + data[1]);
+                payload[0] = data[0];
+                payload[1] = data[1];
+                readBytes(dev, data[0], payload.data() + 2, data[1], (cmd == HKX_EEP_READ) ? REGISTER_ROM : REGISTER_RAM);
+            }
+            break;
+        case HKX_EEP_WRITE:
+        case HKX_RAM_WRITE:
+            if (ndata >= 3 && ndata >= 2 + data[1])
+            {
+                writeBytes(dev, data[0], data + 2, data[1], (cmd == HKX_EEP_WRITE) ? REGISTER_ROM : REGISTER_RAM);
+            }
+            break;
+        case HKX_STAT:
+            isRead = true;
+            break;
+        case HKX_ROLLBACK:
+            resetDevice(dev, (ndata >= 2 && data[0]) ? (data[1] ? RESET_ALL_EXCEPT_ID_BAUDRATE : RESET_ALL_EXCEPT_ID) : RESET_ALL);
+            break;
+        case HKX_REBOOT:
+            // RAM is reloaded from EEPROM
+            for (unsigned i = 0; i < getRegisterCount(dev.ct); i++)
+            {
+                if (dev.ct[i][3] >= 0 && dev.ct[i][4] >= 0)
+                {
+                    writeMem(dev, dev.ct[i][4], dev.ct[i][1], readMem(dev, dev.ct[i][3], dev.ct[i][1], REGISTER_ROM), REGISTER_RAM);
+                }
+            }
+            break;
+        default:
+            statusDetail |= HKX_STATBIT_UNKWOWN_CMD;
+            break;
+        }
+
+        int policy = getAckPolicy(dev);
+        if (id != BROADCAST_ID &&
+            (cmd == HKX_STAT || policy == 2 || (policy == 1 && isRead)))
+        {
+            std::vector <unsigned char> st = ack(dev, cmd, payload.data(), static_cast<int>(payload.size()), statusDetail);
+            sendStatus(dev, st, t);
+        }
+
+        if (cmd == HKX_REBOOT)
+        {
+            dev.rebootUntil = t + std::chrono::milliseconds(REBOOT_DURATION_MS);
+        }
+    }
+}
+
+#endif // defined(__linux__) || defined(__unix__)
@@ -0,0 +1,236 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file VirtualServoBus.h
+ * \date 18/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef VIRTUAL_SERVO_BUS_H
+#define VIRTUAL_SERVO_BUS_H
+
+#if defined(__linux__) || defined(__unix__)
+
+#include "ControlTables.h"
+#include "ServoTools.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief Faults that can be injected into a virtual servo.
+ */
+typedef struct VirtualServoFaults_t
+{
+    int dropPercent = 0;        //!< Probability (in %) that a status packet is never sent.
+    int corruptPercent = 0;     //!< Probability (in %) that a status packet has a bad checksum.
+    int truncatePercent = 0;    //!< Probability (in %) that a status packet is cut short.
+    int extraDelayUs = 0;       //!< Additional delay before a status packet, in microseconds.
+    int errorBits = 0;          //!< Error bits reported in every status packet (Dynamixel error field / HerkuleX STATUS_ERROR).
+    bool offline = false;       //!< The device doesn't answer at all.
+} VirtualServoFaults;
+
+/*!
+ * \brief A virtual servo bus, emulating Dynamixel (v1/v2) and HerkuleX devices behind a pseudo terminal.
+ *
+ * The bus opens a pty pair and answers instruction packets written on the slave
+ * side (see getDevicePath()), so the regular SerialPortLinux and protocol layers
+ * can be used unmodified, without any hardware attached.
+ *
+ * Each virtual device owns a real control table (from ControlTablesDynamixel.h
+ * and ControlTablesHerkuleX.h) initialized with its default values. Replies are
+ * delayed to match the wire time of the request and status packets at the
+ * configured baud rate, plus the device return delay. A simple motion model
+ * moves the current position toward the goal position.
+ *
+ * Dynamixel instructions: PING, READ, WRITE, REG_WRITE, ACTION, FACTORY_RESET,
+ * REBOOT, SYNC_WRITE, SYNC_READ (v2), BULK_READ, BULK_WRITE (v2).
+ * HerkuleX commands: EEP_READ/WRITE, RAM_READ/WRITE, I_JOG, S_JOG, STAT, ROLLBACK, REBOOT.
+ *
+ * \note Dynamixel v2 byte stuffing is not emulated, as the protocol layer doesn't use it.
+ */
+class VirtualServoBus
+{
+    /*!
+     * \brief Internal state of a virtual device.
+     */
+    struct VirtualDevice
+    {
+        int protocol = PROTOCOL_UNKNOWN;
+        int modelNumber = 0;
+        int servoModel = SERVO_UNKNOWN;
+        const int (*ct)[8] = nullptr;
+
+        std::vector <unsigned char> mem;    //!< Dynamixel memory / HerkuleX RAM.
+        std::vector <unsigned char> eep;    //!< HerkuleX EEPROM.
+
+        std::vector <unsigned char> regWrite; //!< Pending REG_WRITE instruction (address and data).
+
+        double position = 0.0;              //!< Current position, in device units.
+        double goal = 0.0;                  //!< Goal position, in device units.
+        double speed = 0.0;                 //!< Motion speed, in device units per second.
+        double positionMax = 1023.0;        //!< Maximum position value.
+        std::chrono::steady_clock::time_point rebootUntil;
+
+        VirtualServoFaults faults;
+    };
+
+    std::vector <VirtualDevice> devices;    //!< Virtual devices plugged on this bus.
+    std::mutex devicesLock;                 //!< Protect 'devices' from concurrent access.
+
+    int baudRate = 1000000;                 //!< Emulated baud rate.
+    double byteTimeUs = 10.0;               //!< Time needed to transfer one byte, in microseconds.
+
+    int masterFd = -1;                      //!< Master side of the pty pair.
+    int slaveFd = -1;                       //!< Kept open so the master never sees a hangup.
+    std::string slavePath;                  //!< Slave side device node (ex: /dev/pts/3).
+
+    std::thread busThread;                  //!< Device emulation thread.
+    std::atomic <bool> busRunning;          //!< Set to false to stop the emulation thread.
+
+    std::vector <unsigned char> rxBuffer;   //!< Bytes received from the host, not yet parsed.
+    std::chrono::steady_clock::time_point rxLastByte; //!< Reception time of the last bytes.
+    std::chrono::steady_clock::time_point busFreeAt;  //!< Time at which the (virtual) wire becomes idle.
+    std::chrono::steady_clock::time_point physicsLast;
+
+    std::mt19937 rng;                       //!< Random source for fault injection.
+
+    std::atomic <unsigned> packetsReceived;
+    std::atomic <unsigned> packetsSent;
+    std::atomic <unsigned> packetsCorrupted;
+
+    //! Device emulation thread.
+    void run();
+
+    //! Extract and dispatch every complete packet from 'rxBuffer'.
+    void parse();
+
+    //! Advance the motion model of every device.
+    void updatePhysics();
+
+    //! Handle one Dynamixel protocol v1 instruction packet.
+    void handleDxl1(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t);
+    //! Handle one Dynamixel protocol v2 instruction packet.
+    void handleDxl2(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t);
+    //! Handle one HerkuleX command packet.
+    void handleHkx(const unsigned char *packet, const int size, std::chrono::steady_clock::time_point &t);
+
+    /*!
+     * \brief Send a status packet on the bus, applying timing and faults.
+     * \param dev: Device sending the packet.
+     * \param packet: Complete status packet (checksum included).
+     * \param[in,out] t: Time at which the device starts answering, updated with the time at which the bus becomes idle.
+     */
+    void sendStatus(VirtualDevice &dev, std::vector <unsigned char> &packet, std::chrono::steady_clock::time_point &t);
+
+    VirtualDevice *findDevice(const int protocol, const int id);
+    int getDeviceId(const VirtualDevice &dev) const;
+    void resetDevice(VirtualDevice &dev, const int setting);
+    int readMem(const VirtualDevice &dev, const int addr, const int size, const int type) const;
+    void writeMem(VirtualDevice &dev, const int addr, const int size, const int value, const int type);
+    void writeBytes(VirtualDevice &dev, const int addr, const unsigned char *data, const int size, const int type);
+    void readBytes(const VirtualDevice &dev, const int addr, unsigned char *data, const int size, const int type) const;
+    void writeRegister(VirtualDevice &dev, const int reg_name, const int value);
+    int readRegister(const VirtualDevice &dev, const int reg_name) const;
+    void registersWritten(VirtualDevice &dev, const int addr, const int size, const int type);
+    int getReturnDelayUs(const VirtualDevice &dev) const;
+    int getAckPolicy(const VirtualDevice &dev) const;
+
+public:
+    /*!
+     * \brief VirtualServoBus constructor.
+     * \param baud: Emulated baud rate, in bps. Only used to compute wire timings.
+     */
+    VirtualServoBus(const int baud = 1000000);
+    ~VirtualServoBus();
+
+    /*!
+     * \brief Plug a virtual Dynamixel device on the bus.
+     * \param id: Device ID.
+     * \param modelNumber: Dynamixel model number (ex: 0x000C for an AX-12A, 0x001D for a MX-28).
+     * \param protocolVersion: PROTOCOL_DXLv1 or PROTOCOL_DXLv2.
+     * \return True if the device has been added.
+     */
+    bool addDynamixel(const int id, const int modelNumber, const int protocolVersion = PROTOCOL_DXLv1);
+
+    /*!
+     * \brief Plug a virtual HerkuleX device on the bus.
+     * \param id: Device ID.
+     * \param modelNumber: HerkuleX model number (ex: 0x0101 for a DRS-0101).
+     * \return True if the device has been added.
+     */
+    bool addHerkuleX(const int id, const int modelNumber = 0x0101);
+
+    /*!
+     * \brief Open the pty pair and start the emulation thread.
+     * \return True in case of success.
+     */
+    bool start();
+
+    /*!
+     * \brief Stop the emulation thread and close the pty pair.
+     */
+    void stop();
+
+    /*!
+     * \brief Get the device node that a SerialPort can open to talk to the virtual devices.
+     * \return The pty slave path (ex: /dev/pts/3), or an empty string if the bus is not started.
+     */
+    std::string getDevicePath() const { return slavePath; }
+
+    /*!
+     * \brief Set the faults injected by a virtual device.
+     * \param id: Device ID. Use BROADCAST_ID to set the faults of every device.
+     * \param faults: Faults to inject.
+     */
+    void setFaults(const int id, const VirtualServoFaults &faults);
+
+    /*!
+     * \brief Read a register value directly from a virtual device.
+     * \param id: Device ID.
+     * \param reg_name: Register name.
+     * \return The register value, or -1 if the device or register doesn't exist.
+     */
+    int getRegisterValue(const int id, const int reg_name);
+
+    /*!
+     * \brief Write a register value directly into a virtual device.
+     * \param id: Device ID.
+     * \param reg_name: Register name.
+     * \param value: Register value.
+     */
+    void setRegisterValue(const int id, const int reg_name, const int value);
+
+    unsigned getPacketsReceived() const { return packetsReceived; }
+    unsigned getPacketsSent() const { return packetsSent; }
+    unsigned getPacketsCorrupted() const { return packetsCorrupted; }
+};
+
+/** @}*/
+
+#endif // defined(__linux__) || defined(__unix__)
+
+#endif // VIRTUAL_SERVO_BUS_H
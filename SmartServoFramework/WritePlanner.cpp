@@ -0,0 +1,140 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file WritePlanner.cpp
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#include "WritePlanner.h"
+#include "Servo.h"
+
+#include <algorithm>
+
+/* ************************************************************************** */
+
+void WritePlanner::setGapTolerance(const int bytes)
+{
+    gapTolerance = (bytes > 0) ? bytes : 0;
+}
+
+void WritePlanner::clear()
+{
+    writes.clear();
+    blockCount = 0;
+}
+
+void WritePlanner::add(const int address, const int size, const int value)
+{
+    if (address >= 0 && size > 0 && size <= 4)
+    {
+        writes.push_back({address, size, value});
+    }
+}
+
+bool WritePlanner::fillGap(Servo *servo, const int reg_type, const int address, const int length, std::vector <unsigned char> &data)
+{
+    const int (*ct)[8] = servo->getControlTable();
+    int regCount = servo->getRegisterCount();
+
+    for (int a = address; a < address + length;)
+    {
+        int reg_name = -1, reg_addr = -1, reg_size = 0;
+
+        for (int i = 0; i < regCount; i++)
+        {
+            // Control table columns: name, size, access, ROM address, RAM address
+            int addr = (reg_type == REGISTER_ROM) ? ct[i][3] : ct[i][4];
+            if (addr >= 0 && a >= addr && a < addr + ct[i][1])
+            {
+                if (ct[i][2] == READ_WRITE)
+                {
+                    reg_name = ct[i][0];
+                    reg_addr = addr;
+                    reg_size = ct[i][1];
+                }
+                break;
+            }
+        }
+
+        if (reg_name < 0)
+        {
+            return false;
+        }
+
+        int value = servo->getValue(reg_name, reg_type);
+        for (; a < reg_addr + reg_size && a < address + length; a++)
+        {
+            data.push_back(static_cast<unsigned char>((value >> (8 * (a - reg_addr))) & 0xFF));
+        }
+    }
+
+    return true;
+}
+
+size_t WritePlanner::plan(Servo *servo, const int reg_type)
+{
+    blockCount = 0;
+
+    std::sort(writes.begin(), writes.end(),
+              [](const RegisterWrite &a, const RegisterWrite &b) { return a.address < b.address; });
+
+    for (const RegisterWrite &w: writes)
+    {
+        WriteBlock *b = (blockCount > 0) ? &blocks[blockCount - 1] : nullptr;
+        bool merged = false;
+
+        if (b != nullptr)
+        {
+            int end = b->address + static_cast<int>(b->data.size());
+            int gap = w.address - end;
+
+            if (gap == 0)
+            {
+                merged = true;
+            }
+            else if (gap > 0 && gap <= gapTolerance && servo != nullptr)
+            {
+                size_t size = b->data.size();
+                merged = fillGap(servo, reg_type, end, gap, b->data);
+                if (merged == false)
+                {
+                    b->data.resize(size);
+                }
+            }
+        }
+
+        if (merged == false)
+        {
+            if (blockCount == blocks.size())
+            {
+                blocks.emplace_back();
+            }
+
+            b = &blocks[blockCount++];
+            b->address = w.address;
+            b->data.clear();
+        }
+
+        for (int i = 0; i < w.size; i++)
+        {
+            b->data.push_back(static_cast<unsigned char>((w.value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    return blockCount;
+}
@@ -0,0 +1,109 @@
+/*!
+ * This file is part of SmartServoFramework.
+ * Copyright (c) 2026, INRIA, All rights reserved.
+ *
+ * SmartServoFramework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this software. If not, see <http://www.gnu.org/licenses/lgpl-3.0.txt>.
+ *
+ * \file WritePlanner.h
+ * \date 19/10/2026
+ * \author Emeric Grange <emeric.grange@gmail.com>
+ */
+
+#ifndef WRITE_PLANNER_H
+#define WRITE_PLANNER_H
+
+#include <vector>
+#include <cstddef>
+
+class Servo;
+
+/** \addtogroup Tools
+ *  @{
+ */
+
+/*!
+ * \brief A block of contiguous register bytes to write into a device.
+ */
+typedef struct WriteBlock_t
+{
+    int address = 0;
+    std::vector <unsigned char> data;   //!< Register bytes, little endian.
+} WriteBlock;
+
+/*!
+ * \brief The WritePlanner class merges the register modifications of a device into as few writes as possible.
+ *
+ * Registers are added with add(), then plan() sorts them and merges the ones
+ * with contiguous addresses into the same block. Registers separated by a gap
+ * of at most 'gap tolerance' bytes are also merged, if every byte of the gap
+ * belongs to a writable register of the device control table: the gap is then
+ * filled with the current (unchanged) values of these registers.
+ *
+ * Blocks memory is kept between plans, so a planner used on every
+ * synchronization loop doesn't allocate once it has warmed up.
+ */
+class WritePlanner
+{
+    struct RegisterWrite
+    {
+        int address;
+        int size;
+        int value;
+    };
+
+    std::vector <RegisterWrite> writes;
+    std::vector <WriteBlock> blocks;
+    size_t blockCount = 0;
+    int gapTolerance = 0;
+
+    /*!
+     * \brief Fill a gap between two registers with the device current values.
+     * \return false if a byte of the gap doesn't belong to a writable register.
+     */
+    bool fillGap(Servo *servo, const int reg_type, const int address, const int length, std::vector <unsigned char> &data);
+
+public:
+    /*!
+     * \brief Set the maximum number of unchanged bytes to re-send to merge two register writes.
+     * \param bytes: Gap tolerance, 0 to only merge contiguous registers.
+     */
+    void setGapTolerance(const int bytes);
+    int getGapTolerance() const { return gapTolerance; }
+
+    //! Remove every register write.
+    void clear();
+
+    /*!
+     * \brief Add a register modification.
+     * \param address: Register address.
+     * \param size: Register size, in bytes.
+     * \param value: Register value.
+     */
+    void add(const int address, const int size, const int value);
+
+    /*!
+     * \brief Merge the register writes into blocks.
+     * \param servo: Device the registers belong to, used to fill the gaps.
+     * \param reg_type: Memory the register addresses refer to (REGISTER_ROM or REGISTER_RAM).
+     * \return The number of blocks to write.
+     */
+    size_t plan(Servo *servo, const int reg_type);
+
+    //! Get a block computed by the last plan().
+    const WriteBlock &getBlock(const size_t index) const { return blocks[index]; }
+};
+
+/** @}*/
+
+#endif // WRITE_PLANNER_H
@@ -97,6 +97,7 @@ enum TraceModule_e
     MAPI,
     DXL,
     HKX,
+    SIM,
 };
 
 /*!
@@ -119,6 +120,7 @@ static TraceModule_t trace_modules_table[] =
     { "M-API"  , "Managed API"                      , TRACE_LEVEL_DEBUG },
     { "DXL"    , "Dynamixel protocol"               , TRACE_LEVEL_DEBUG },
     { "HKX"    , "HerkuleX protocol"                , TRACE_LEVEL_DEBUG },
+    { "SIM"    , "Virtual servo bus"                , TRACE_LEVEL_DEBUG },
 };
 
 /* ************************************************************************** */
@@ -0,0 +1,148 @@
+/*!
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 INRIA
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * Capture and replay program: record the serial traffic of a virtual servo bus
+ * into a capture file, then feed the capture back into the Simple API with the
+ * original timing, and as fast as possible.
+ * No hardware is needed.
+ *
+ * Usage: ex_capture_replay [capture file] [servo count] [baudrate]
+ */
+
+// SmartServoFramework
+#include "../SmartServoFramework/SimpleAPI.h"
+#include "../SmartServoFramework/VirtualServoBus.h"
+
+// C++ standard libraries
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+
+/* ************************************************************************** */
+
+/*!
+ * \brief Read the position of every device (and of a missing one), a few times.
+ * \return The values read, in order.
+ */
+static std::vector <int> readPositions(DynamixelSimpleAPI &dxl, int servoCount, int rounds, double &duration)
+{
+    std::vector <int> values;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        // The last ID is not on the bus and will time out
+        for (int id = 1; id <= servoCount + 1; id++)
+        {
+            values.push_back(dxl.readCurrentPosition(id));
+        }
+    }
+    duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    return values;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string captureFile = (argc > 1) ? argv[1] : "/tmp/ex_capture_replay.ssfcap";
+    int servoCount = (argc > 2) ? std::atoi(argv[2]) : 4;
+    int baudrate = (argc > 3) ? std::atoi(argv[3]) : 1000000;
+    const int rounds = 50;
+
+    std::cout << std::endl << "======== Smart Servo Framework Capture & Replay ========" << std::endl;
+
+    // Capture
+    ////////////////////////////////////////////////////////////////////////////
+
+    std::vector <int> captured;
+    double captureDuration = 0.0;
+    {
+        VirtualServoBus bus(baudrate);
+        for (int id = 1; id <= servoCount; id++)
+        {
+            bus.addDynamixel(id, 0x001D, PROTOCOL_DXLv1); // MX-28
+        }
+
+        if (bus.start() == false)
+        {
+            std::cerr << "> Unable to start the virtual servo bus! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::string devicePath = bus.getDevicePath();
+
+        DynamixelSimpleAPI dxl(SERVO_MX);
+        if (dxl.connect(devicePath, baudrate) != 1 ||
+            dxl.serialCaptureStart(captureFile) == false)
+        {
+            std::cerr << "> Unable to capture the virtual servo bus! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        captured = readPositions(dxl, servoCount, rounds, captureDuration);
+
+        dxl.serialCaptureStop();
+        dxl.disconnect();
+        bus.stop();
+
+        std::cout << "> " << captured.size() << " reads captured into '" << captureFile << "' in "
+                  << captureDuration << " ms" << std::endl;
+    }
+
+    // Replays
+    ////////////////////////////////////////////////////////////////////////////
+
+    const char *modes[2] = {"", "?fast"};
+    for (int m = 0; m < 2; m++)
+    {
+        std::string devicePath = "replay://" + captureFile + modes[m];
+
+        DynamixelSimpleAPI dxl(SERVO_MX);
+        if (dxl.connect(devicePath, baudrate) != 1)
+        {
+            std::cerr << "> Unable to open '" << devicePath << "'! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        double duration = 0.0;
+        std::vector <int> replayed = readPositions(dxl, servoCount, rounds, duration);
+
+        int differences = 0;
+        for (size_t i = 0; i < captured.size(); i++)
+        {
+            if (replayed[i] != captured[i])
+                differences++;
+        }
+
+        std::cout << "> Replay '" << devicePath << "': " << replayed.size() << " reads in " << duration << " ms ("
+                  << differences << " differences with the capture)" << std::endl;
+
+        dxl.disconnect();
+    }
+
+    std::cout << std::endl << "======== EXITING ========" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+/* ************************************************************************** */
@@ -0,0 +1,157 @@
+/*!
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 INRIA
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Example program: start several virtual servo buses (mixing Dynamixel and
+ * HerkuleX devices), one controller per bus, and drive all of them with a
+ * common cycle clock. Every group cycle publishes the state of the whole
+ * "robot". No hardware is needed.
+ *
+ * Usage: ex_controller_group [bus count] [servos per bus] [frequency]
+ */
+
+// SmartServoFramework
+#include "../SmartServoFramework/ManagedAPI.h"
+#include "../SmartServoFramework/VirtualServoBus.h"
+
+// C++ standard libraries
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+
+/* ************************************************************************** */
+
+int main(int argc, char *argv[])
+{
+    int busCount = (argc > 1) ? std::atoi(argv[1]) : 3;
+    int servoCount = (argc > 2) ? std::atoi(argv[2]) : 4;
+    int frequency = (argc > 3) ? std::atoi(argv[3]) : 50;
+    const int baudrate = 1000000;
+
+    std::cout << std::endl << "======== Smart Servo Framework Controller Group ========" << std::endl;
+
+    std::vector <std::unique_ptr <VirtualServoBus>> buses;
+    std::vector <std::unique_ptr <ServoController>> controllers;
+    ControllerGroup group(frequency);
+
+    for (int b = 0; b < busCount; b++)
+    {
+        // Every third bus is a HerkuleX one
+        bool herkulex = (b % 3 == 2);
+
+        std::unique_ptr <VirtualServoBus> bus(new VirtualServoBus(baudrate));
+        for (int id = 1; id <= servoCount; id++)
+        {
+            if (herkulex)
+                bus->addHerkuleX(id, 0x0101);
+            else
+                bus->addDynamixel(id, 0x001D, PROTOCOL_DXLv1); // MX-28
+        }
+        if (bus->start() == false)
+        {
+            std::cerr << "> Unable to start a virtual servo bus! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        std::unique_ptr <ServoController> ctrl;
+        if (herkulex)
+            ctrl.reset(new HerkuleXController(SERVO_DRS, frequency));
+        else
+            ctrl.reset(new DynamixelController(SERVO_MX, frequency));
+
+        std::string devicePath = bus->getDevicePath();
+        if (ctrl->connect(devicePath, baudrate) != 1)
+        {
+            std::cerr << "> Unable to connect a controller! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        ctrl->autodetect(1, servoCount);
+        ctrl->waitUntilReady();
+
+        std::cout << "> Bus #" << b << " (" << (herkulex ? "HerkuleX" : "Dynamixel") << ") on '" << devicePath
+                  << "' with " << ctrl->getServos().size() << " devices" << std::endl;
+
+        // Join the group once ready, so the scan doesn't hold the other buses
+        group.addController(ctrl.get());
+
+        buses.push_back(std::move(bus));
+        controllers.push_back(std::move(ctrl));
+    }
+
+    // Move every device of every bus, once per group cycle
+    CycleSnapshot snap;
+    const int cycles = frequency * 4;
+    uint64_t cycle = group.getCycleCount();
+    std::vector <uint64_t> firstCycles;
+    for (auto &c: controllers)
+    {
+        firstCycles.push_back(c->getCycleCount());
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < cycles; i++)
+    {
+        cycle = group.waitForCycle(cycle);
+
+        group.snapshot(snap);
+        for (auto &c: controllers)
+        {
+            for (auto s: c->getServos())
+            {
+                s->setGoalPosition(512 + ((i % 2) ? 64 : -64));
+            }
+        }
+    }
+
+    double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LatencyStats latency = group.getCycleLatency();
+    LatencyStats skew = group.getArrivalSkew();
+
+    std::cout << "> " << cycles / duration << " group cycles/s, last one #" << snap.cycle << " with "
+              << snap.states.size() << " devices" << std::endl;
+    std::cout << "> Group cycle duration: p50 " << latency.p50 << "µs, p99 " << latency.p99 << "µs, max " << latency.max << "µs" << std::endl;
+    std::cout << "> Arrival skew: p50 " << skew.p50 << "µs, p99 " << skew.p99 << "µs, max " << skew.max << "µs" << std::endl;
+    std::cout << "> " << group.getOverruns() << " deadlines missed, " << group.getTimeouts() << " barrier timeouts" << std::endl;
+    for (size_t b = 0; b < controllers.size(); b++)
+    {
+        // Aligned buses complete the same number of cycles
+        std::cout << ">   bus #" << b << ": " << controllers[b]->getCycleCount() - firstCycles[b] << " cycles, "
+                  << controllers[b]->getErrorCount() << " errors" << std::endl;
+    }
+
+    for (auto &c: controllers)
+    {
+        group.removeController(c.get());
+        c->disconnect();
+    }
+    for (auto &b: buses)
+    {
+        b->stop();
+    }
+
+    std::cout << std::endl << "======== EXITING ========" << std::endl;
+
+    return EXIT_SUCCESS;
+}
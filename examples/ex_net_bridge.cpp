@@ -0,0 +1,257 @@
+/*!
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 INRIA
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Network serial link program: start a virtual servo bus, expose it through a
+ * loopback TCP or UDP bridge (a stand-in for an Ethernet to RS485/TTL gateway),
+ * then talk to it using a "tcp://" or "udp://" device path.
+ * No hardware is needed.
+ *
+ * Usage: ex_net_bridge [tcp|udp] [servo count] [baudrate]
+ */
+
+// SmartServoFramework
+#include "../SmartServoFramework/SimpleAPI.h"
+#include "../SmartServoFramework/SerialPortNet.h"
+#include "../SmartServoFramework/VirtualServoBus.h"
+
+// POSIX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+/* ************************************************************************** */
+
+static std::atomic <bool> bridgeRunning(true);
+
+/*!
+ * \brief Copy bytes between a network socket and a serial device, like a ser2net gateway would.
+ */
+static void bridge(int listenFd, bool udp, std::string ttyPath)
+{
+    int ttyFd = open(ttyPath.c_str(), O_RDWR | O_NOCTTY);
+    int netFd = udp ? listenFd : -1;
+    struct sockaddr_storage peer;
+    socklen_t peerLength = 0;
+    unsigned char buffer[1024];
+
+    while (bridgeRunning)
+    {
+        struct pollfd fds[2] = {{ttyFd, POLLIN, 0}, {(netFd >= 0) ? netFd : listenFd, POLLIN, 0}};
+
+        if (poll(fds, 2, 50) <= 0)
+            continue;
+
+        if (fds[1].revents & POLLIN)
+        {
+            if (netFd < 0)
+            {
+                // Like any serial gateway, forward small packets immediately
+                int flag = 1;
+                netFd = accept(listenFd, nullptr, nullptr);
+                setsockopt(netFd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+            }
+            else
+            {
+                ssize_t len = 0;
+                if (udp)
+                {
+                    peerLength = sizeof(peer);
+                    len = recvfrom(netFd, buffer, sizeof(buffer), 0, (struct sockaddr *)&peer, &peerLength);
+                }
+                else
+                {
+                    len = recv(netFd, buffer, sizeof(buffer), 0);
+                }
+                if (len > 0)
+                {
+                    if (write(ttyFd, buffer, len) < 0)
+                        break;
+                }
+                else if (!udp)
+                {
+                    close(netFd);
+                    netFd = -1;
+                }
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            ssize_t len = read(ttyFd, buffer, sizeof(buffer));
+            if (len > 0 && netFd >= 0)
+            {
+                if (udp && peerLength > 0)
+                    sendto(netFd, buffer, len, 0, (struct sockaddr *)&peer, peerLength);
+                else if (!udp)
+                    send(netFd, buffer, len, MSG_NOSIGNAL);
+            }
+        }
+    }
+
+    if (netFd >= 0 && netFd != listenFd)
+        close(netFd);
+    close(ttyFd);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string transport = (argc > 1) ? argv[1] : "tcp";
+    int servoCount = (argc > 2) ? std::atoi(argv[2]) : 8;
+    int baudrate = (argc > 3) ? std::atoi(argv[3]) : 1000000;
+    bool udp = (transport == "udp");
+
+    std::cout << std::endl << "======== Smart Servo Framework Network Bridge ========" << std::endl;
+
+    VirtualServoBus bus(baudrate);
+    for (int id = 1; id <= servoCount; id++)
+    {
+        bus.addDynamixel(id, 0x001D, PROTOCOL_DXLv1); // MX-28
+    }
+
+    if (bus.start() == false)
+    {
+        std::cerr << "> Unable to start the virtual servo bus! Exiting..." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Loopback gateway, on a port chosen by the system
+    int listenFd = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    socklen_t addrLength = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (!udp && listen(listenFd, 1) < 0) ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &addrLength) < 0)
+    {
+        std::cerr << "> Unable to start the network bridge! Exiting..." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::thread bridgeThread(bridge, listenFd, udp, bus.getDevicePath());
+
+    std::string devicePath = transport + "://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+    std::cout << "> Virtual bus on '" << bus.getDevicePath() << "' bridged to '" << devicePath << "'" << std::endl;
+
+    // Simple API over the network link
+    ////////////////////////////////////////////////////////////////////////////
+
+    std::cout << std::endl << "======== Simple API ========" << std::endl;
+    {
+        const int iterations = 500;
+        int errors = 0;
+
+        DynamixelSimpleAPI dxl(SERVO_MX);
+        if (dxl.connect(devicePath, baudrate) != 1)
+        {
+            std::cerr << "> Unable to connect the Simple API! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (dxl.readCurrentPosition(1 + i % servoCount) < 0)
+                errors++;
+        }
+        double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "> " << iterations << " reads in " << duration * 1000.0 << " ms ("
+                  << iterations / duration << " transactions/s, " << errors << " errors)" << std::endl;
+
+        dxl.disconnect();
+    }
+
+    // Pipelined requests, using the network serial port directly
+    ////////////////////////////////////////////////////////////////////////////
+
+    std::cout << std::endl << "======== Pipelined pings ========" << std::endl;
+    {
+        SerialPortNet link(devicePath, baudrate, SERIAL_UNKNOWN, SERVO_DYNAMIXEL);
+        if (link.openLink() != 1)
+        {
+            std::cerr << "> Unable to open the network link! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        const int rounds = 100;
+        int replies = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int r = 0; r < rounds; r++)
+        {
+            // Send a ping to every device at once, without waiting for the replies
+            for (int id = 1; id <= servoCount; id++)
+            {
+                unsigned char ping[6] = {0xFF, 0xFF, (unsigned char)id, 0x02, 0x01, 0};
+                ping[5] = ~(ping[2] + ping[3] + ping[4]);
+                link.tx(ping, 6);
+                link.setTimeOut(6);
+            }
+
+            // Collect the status packets (6 bytes each)
+            unsigned char status[6];
+            int received = 0;
+            link.setTimeOut(50.0);
+            while (received < servoCount * 6 && link.checkTimeOut() == 0)
+            {
+                int len = link.rx(status, 6 - (received % 6));
+                if (len > 0)
+                    received += len;
+            }
+            replies += received / 6;
+        }
+
+        double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "> " << replies << "/" << rounds * servoCount << " replies in " << duration * 1000.0 << " ms ("
+                  << replies / duration << " transactions/s)" << std::endl;
+        std::cout << "> Round trip time: " << link.getRoundTripTime() << " ms (variation: "
+                  << link.getRoundTripTimeVariance() << " ms)" << std::endl;
+
+        link.closeLink();
+    }
+
+    bridgeRunning = false;
+    bridgeThread.join();
+    close(listenFd);
+    bus.stop();
+
+    std::cout << std::endl << "======== EXITING ========" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+/* ************************************************************************** */
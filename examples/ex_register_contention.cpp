@@ -0,0 +1,148 @@
+/*!
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 INRIA
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Benchmark program: one thread updates the register values of a set of servos
+ * (like a controller's synchronization loop does), while several "user" threads
+ * read them back as fast as they can. Measure the readers throughput, and how
+ * long the writer takes to update every servo. No hardware is needed.
+ *
+ * Usage: ex_register_contention [reader threads] [servo count] [duration (s)]
+ */
+
+// SmartServoFramework
+#include "../SmartServoFramework/ManagedAPI.h"
+#include "../SmartServoFramework/LatencyHistogram.h"
+
+// C++ standard libraries
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/* ************************************************************************** */
+
+int main(int argc, char *argv[])
+{
+    int readerCount = (argc > 1) ? std::atoi(argv[1]) : 4;
+    int servoCount = (argc > 2) ? std::atoi(argv[2]) : 18;
+    int duration = (argc > 3) ? std::atoi(argv[3]) : 2;
+
+    std::cout << std::endl << "======== Smart Servo Framework Register Contention ========" << std::endl;
+    std::cout << "> " << readerCount << " reader threads, " << servoCount << " servos, " << duration << " s" << std::endl;
+
+    std::vector <Servo *> servos;
+    for (int id = 1; id <= servoCount; id++)
+    {
+        servos.push_back(new ServoMX(id, 0x001D)); // MX-28
+    }
+
+    std::atomic <bool> running(true);
+    std::atomic <uint64_t> reads(0);
+    std::atomic <uint64_t> consistentReads(0);
+    std::atomic <uint64_t> tornReads(0);
+    uint64_t cycles = 0;
+    LatencyHistogram writerLatency;
+
+    const int regs[3] = {REG_CURRENT_POSITION, REG_CURRENT_SPEED, REG_CURRENT_LOAD};
+
+    // Writer: update the feedback registers of every servo, like a synchronization loop
+    // (the three registers of a servo always hold the same value)
+    std::thread writer([&]()
+    {
+        int value = 0;
+        while (running)
+        {
+            const int values[3] = {value, value, value};
+
+            auto start = std::chrono::steady_clock::now();
+            for (auto s: servos)
+            {
+                s->updateValues(regs, values, 3);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            writerLatency.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            value = (value + 1) % 1024;
+            cycles++;
+        }
+    });
+
+    // Readers: a user control loop, reading every servo
+    std::vector <std::thread> readers;
+    for (int i = 0; i < readerCount; i++)
+    {
+        readers.push_back(std::thread([&]()
+        {
+            int values[3];
+            uint64_t count = 0, consistent = 0, torn = 0;
+
+            while (running)
+            {
+                for (auto s: servos)
+                {
+                    // Single register getter
+                    s->getCurrentPosition();
+
+                    // Consistent multi-register read
+                    s->getValues(regs, values, 3);
+                    count += 2;
+
+                    if (values[0] == values[1] && values[1] == values[2])
+                        consistent++;
+                    else
+                        torn++;
+                }
+            }
+
+            reads += count;
+            consistentReads += consistent;
+            tornReads += torn;
+        }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(duration));
+    running = false;
+
+    writer.join();
+    for (auto &t: readers)
+    {
+        t.join();
+    }
+
+    LatencyStats w = writerLatency.getStats();
+    std::cout << "> Readers: " << reads / duration << " reads/s (" << consistentReads / duration << " consistent multi-register reads/s, "
+              << tornReads << " torn)" << std::endl;
+    std::cout << "> Writer: " << cycles / duration << " cycles/s, cycle duration p50 " << w.p50 << "ns, p99 " << w.p99
+              << "ns, p999 " << w.p999 << "ns, max " << w.max << "ns" << std::endl;
+
+    for (auto s: servos)
+    {
+        delete s;
+    }
+
+    std::cout << std::endl << "======== EXITING ========" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -31,7 +31,6 @@
 
 #define ENABLE_OPENCV_VIZ       1
 #define SYNC_FREQUENCY         30
-#define SOFTWARE_FREQUENCY     30
 
 // SmartServoFramework
 #include "../SmartServoFramework/ManagedAPI.h"
@@ -104,13 +103,13 @@ int main(int argc, char *argv[])
 
     std::cout << std::endl << "======== MAIN LOOP ========" << std::endl;
 
-    std::chrono::time_point<std::chrono::system_clock> start, end;
-    double syncloopDuration = 1000.0 / static_cast<double>(SOFTWARE_FREQUENCY);
+    uint64_t cycle = ctrl.getCycleCount();
     bool running = true;
 
     while (running)
     {
-        start = std::chrono::system_clock::now();
+        // Run phase-locked with the controller: wait for fresh feedback
+        cycle = ctrl.waitForCycle(cycle);
 
         // Maths:
         // x(t) = pos   = a * sin(b * t) + offset;
@@ -181,31 +180,15 @@ int main(int argc, char *argv[])
         cv::imshow(window, img);
 #endif /* ENABLE_OPENCV_VIZ */
 
-        // Loop control (No need to go faster than the sync thread)
+        // Loop control (No need to go faster than the sync thread, see waitForCycle())
         ///////////////////////////////////////////////////////////////////////
 
         oldpos = pos;
 
         (t > w) ? t = 0 : t++;
-        end = std::chrono::system_clock::now();
-        double loopd = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-        double waitd = (syncloopDuration*1000.0) - loopd;
 
 #if ENABLE_OPENCV_VIZ == 1
-        if (waitd >= 1000.0)
-        {
-            cv::waitKey(static_cast<int>(waitd/1000.0));
-        }
-        else
-        {
-            cv::waitKey(1);
-        }
-#else /* ENABLE_OPENCV_VIZ == 0*/
-        if (waitd > 0.0)
-        {
-            std::chrono::microseconds waittime(static_cast<int>(waitd));
-            std::this_thread::sleep_for(waittime);
-        }
+        cv::waitKey(1);
 #endif
     }
 
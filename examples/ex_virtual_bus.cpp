@@ -0,0 +1,279 @@
+/*!
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 INRIA
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Benchmark program: start a virtual servo bus (a pseudo terminal emulating
+ * Dynamixel or HerkuleX devices), then measure the transaction rate of the
+ * "Simple API" and the synchronization loop of a "controller" against it.
+ * No hardware is needed.
+ *
+ * Usage: ex_virtual_bus [dxl1|dxl2|hkx] [servo count] [baudrate]
+ */
+
+// SmartServoFramework
+#include "../SmartServoFramework/SimpleAPI.h"
+#include "../SmartServoFramework/ManagedAPI.h"
+#include "../SmartServoFramework/VirtualServoBus.h"
+
+// C++ standard libraries
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/* ************************************************************************** */
+
+int main(int argc, char *argv[])
+{
+    std::string protocol = (argc > 1) ? argv[1] : "dxl1";
+    int servoCount = (argc > 2) ? std::atoi(argv[2]) : 8;
+    int baudrate = (argc > 3) ? std::atoi(argv[3]) : 1000000;
+
+    std::cout << std::endl << "======== Smart Servo Framework Virtual Bus ========" << std::endl;
+
+    VirtualServoBus bus(baudrate);
+    for (int id = 1; id <= servoCount; id++)
+    {
+        if (protocol == "hkx")
+            bus.addHerkuleX(id, 0x0101);
+        else if (protocol == "dxl2")
+            bus.addDynamixel(id, 1020, PROTOCOL_DXLv2); // XM430-W350
+        else
+            bus.addDynamixel(id, 0x001D, PROTOCOL_DXLv1); // MX-28
+    }
+
+    if (bus.start() == false)
+    {
+        std::cerr << "> Unable to start the virtual servo bus! Exiting..." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::string devicePath = bus.getDevicePath();
+    std::cout << "> Virtual bus on '" << devicePath << "' with " << servoCount << " " << protocol << " devices" << std::endl;
+
+    // Simple API round-trips
+    ////////////////////////////////////////////////////////////////////////////
+
+    std::cout << std::endl << "======== Simple API ========" << std::endl;
+    {
+        const int iterations = 1000;
+        int errors = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        if (protocol == "hkx")
+        {
+            HerkuleXSimpleAPI hkx(SERVO_DRS);
+            if (hkx.connect(devicePath, baudrate) != 1)
+            {
+                std::cerr << "> Unable to connect the Simple API! Exiting..." << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < iterations; i++)
+            {
+                if (hkx.readCurrentPosition(1 + i % servoCount) < 0)
+                    errors++;
+            }
+            hkx.disconnect();
+        }
+        else
+        {
+            DynamixelSimpleAPI dxl((protocol == "dxl2") ? SERVO_X : SERVO_MX);
+            if (dxl.connect(devicePath, baudrate) != 1)
+            {
+                std::cerr << "> Unable to connect the Simple API! Exiting..." << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < iterations; i++)
+            {
+                if (dxl.readCurrentPosition(1 + i % servoCount) < 0)
+                    errors++;
+            }
+            dxl.disconnect();
+        }
+
+        double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "> " << iterations << " reads in " << duration * 1000.0 << " ms ("
+                  << iterations / duration << " transactions/s, " << errors << " errors)" << std::endl;
+    }
+
+    // Controller synchronization loop
+    ////////////////////////////////////////////////////////////////////////////
+
+    std::cout << std::endl << "======== Controller ========" << std::endl;
+    {
+        ServoController *ctrl = nullptr;
+        if (protocol == "hkx")
+            ctrl = new HerkuleXController(SERVO_DRS, 120);
+        else
+            ctrl = new DynamixelController((protocol == "dxl2") ? SERVO_X : SERVO_MX, 120);
+
+        if (ctrl->connect(devicePath, baudrate) != 1)
+        {
+            std::cerr << "> Unable to connect the controller! Exiting..." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // Scan the virtual bus, every device found will be registered
+        ctrl->autodetect(1, servoCount);
+        ctrl->waitUntilReady();
+        std::cout << "> " << ctrl->getServos().size() << " devices registered" << std::endl;
+
+        std::atomic <uint64_t> callbacks(0);
+        int handle = ctrl->addCycleCallback([&callbacks](uint64_t) { callbacks++; });
+
+        ctrl->serialResetStats_wrapper();
+        unsigned packets = bus.getPacketsReceived();
+        auto start = std::chrono::steady_clock::now();
+        // Move every device once per cycle, so the controller has goal positions to commit
+        uint64_t cycle = ctrl->getCycleCount();
+        for (int i = 0; i < 200; i++)
+        {
+            cycle = ctrl->waitForCycle(cycle);
+            for (auto s: ctrl->getServos())
+            {
+                s->setGoalPosition(512 + ((i % 2) ? 64 : -64));
+            }
+        }
+        ctrl->removeCycleCallback(handle);
+        double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        packets = bus.getPacketsReceived() - packets;
+
+        std::cout << "> " << callbacks / duration << " cycles/s published" << std::endl;
+        std::cout << "> " << packets / duration << " packets/s on the bus, "
+                  << "controller error count: " << ctrl->getErrorCount() << std::endl;
+
+        SerialPortStats stats = ctrl->serialGetStats_wrapper();
+        std::cout << "> Bus " << stats.percentBusy << "% busy (" << stats.percentWire << "% on the wire), "
+                  << stats.transactions << " transactions, " << stats.replies << " replies, "
+                  << stats.bytesTx << " bytes TX, " << stats.bytesRx << " bytes RX" << std::endl;
+        std::cout << "> Wire " << stats.txWireTime + stats.rxWireTime << " ms, wait " << stats.waitTime
+                  << " ms, idle " << stats.idleTime << " ms, timeouts: " << stats.timeouts
+                  << " (+" << stats.timeoutsPartial << " partial), bad ID: " << stats.errorsId
+                  << ", bad checksum: " << stats.errorsChecksum << std::endl;
+
+        const char *names[LATENCY_INSTRUCTION_COUNT] = {"ping", "read", "write", "sync read", "sync write", "bulk read", "bulk write", "other"};
+        for (int i = 0; i < LATENCY_INSTRUCTION_COUNT; i++)
+        {
+            LatencyStats l = ctrl->getInstructionLatency_wrapper(i);
+            if (l.count > 0)
+            {
+                std::cout << "> Latency (" << names[i] << "): " << l.count << " transactions, p50 " << l.p50
+                          << "µs, p99 " << l.p99 << "µs, p999 " << l.p999 << "µs, max " << l.max << "µs" << std::endl;
+            }
+        }
+        for (int id = 1; id <= servoCount; id++)
+        {
+            LatencyStats l = ctrl->getServoLatency_wrapper(id);
+            std::cout << ">   #" << id << ": p50 " << l.p50 << "µs, p99 " << l.p99 << "µs, max " << l.max << "µs" << std::endl;
+        }
+        LatencyStats loop = ctrl->getSyncLoopLatency();
+        std::cout << "> Sync loop duration: p50 " << loop.p50 << "µs, p99 " << loop.p99 << "µs, max " << loop.max << "µs, "
+                  << ctrl->getDeferredReadCount() << " reads deferred" << std::endl;
+
+        LatencyStats jitter = ctrl->getSyncLoopJitter();
+        std::cout << "> Sync loop jitter: p50 " << jitter.p50 << "µs, p99 " << jitter.p99 << "µs, max " << jitter.max << "µs, "
+                  << ctrl->getSyncLoopOverruns() << " deadlines missed" << std::endl;
+
+        // Move every device, and wait for all of them to reach their goal
+        std::vector <Servo *> servos = ctrl->getServos();
+        servos.front()->enableHistory({(protocol == "hkx") ? REG_ABSOLUTE_POSITION : REG_CURRENT_POSITION}, 256);
+        for (auto s: servos)
+        {
+            s->setGoalPosition(768);
+        }
+        start = std::chrono::steady_clock::now();
+        bool reached = ctrl->waitAll(servos, ServoController::inPosition(), 5000);
+        duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "> Motion " << (reached ? "completed" : "timed out") << " after " << duration * 1000.0 << " ms" << std::endl;
+
+        // Peak velocity of the first device during that motion, from its feedback history
+        FeedbackSample samples[256];
+        size_t count = servos.front()->readHistory(samples, 256);
+        double peak = 0.0;
+        for (size_t i = 1; i < count; i++)
+        {
+            double dt = std::chrono::duration<double>(samples[i].time - samples[i - 1].time).count();
+            if (dt > 0.0)
+                peak = std::max(peak, std::abs(samples[i].values[0] - samples[i - 1].values[0]) / dt);
+        }
+        std::cout << "> History: " << count << " samples, peak velocity " << peak << " steps/s" << std::endl;
+        servos.front()->disableHistory();
+
+        // Coherent feedback of every device, from a single cycle
+        CycleSnapshot snap;
+        ctrl->waitForCycle(ctrl->getCycleCount());
+        if (ctrl->snapshot(snap))
+        {
+            double age = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - snap.rxTime).count();
+            std::cout << "> Snapshot of cycle #" << snap.cycle << " (" << age << " ms old):";
+            for (const ServoState &st: snap.states)
+            {
+                std::cout << " #" << st.id << "@" << st.position;
+            }
+            std::cout << std::endl;
+        }
+
+        // Stream a spline trajectory to every device, all starting together, from the controller's thread
+        std::shared_ptr <const Trajectory> traj = std::make_shared <const Trajectory>(std::vector <Waypoint>{
+            {0.0, 768.0}, {0.5, 400.0}, {1.0, 600.0}, {1.5, 512.0}}, TRAJECTORY_CUBIC_SPLINE);
+        std::chrono::steady_clock::time_point trajStart = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+        for (auto s: servos)
+        {
+            ctrl->setTrajectory(s->getId(), traj, trajStart);
+        }
+        int maxError = 0;
+        cycle = ctrl->getCycleCount();
+        while (ctrl->isTrajectoryRunning(servos.front()->getId()))
+        {
+            cycle = ctrl->waitForCycle(cycle);
+
+            // Tracking error of the first device, against the trajectory at the time of the feedback
+            double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - trajStart).count();
+            if (t > 0.1 && t < traj->getDuration())
+                maxError = std::max(maxError, static_cast<int>(std::abs(servos.front()->getCurrentPosition() - traj->getPosition(t))));
+        }
+        std::cout << "> Trajectory completed, max tracking error " << maxError << " steps" << std::endl;
+
+        // Let the controller find the highest frequency the bus can sustain
+        ctrl->setAdaptiveSyncFrequency(10, SYNCLOOP_MAX_FREQUENCY);
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+        std::cout << "> Adaptive frequency: " << ctrl->getSyncFrequency() << " Hz scheduled, "
+                  << ctrl->getAchievedSyncFrequency() << " Hz achieved" << std::endl;
+
+        ctrl->disconnect();
+        delete ctrl;
+    }
+
+    bus.stop();
+
+    std::cout << std::endl << "======== EXITING ========" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+/* ************************************************************************** */